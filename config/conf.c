@@ -16,6 +16,7 @@ struct	dentry	devtab[NDEVS] =
  * init, open, close,
  * read, write, seek,
  * getc, putc, control,
+ * bio, readv, writev,
  * dev-csr-address, intr-handler, irq
  */
 
@@ -24,6 +25,7 @@ struct	dentry	devtab[NDEVS] =
 	  (void *)ttyinit, (void *)ionull, (void *)ionull,
 	  (void *)ttyread, (void *)ttywrite, (void *)ioerr,
 	  (void *)ttygetc, (void *)ttyputc, (void *)ttycontrol,
+	  (void *)ioerr, (void *)ttyreadv, (void *)ttywritev,
 	  (void *)0x3f8, (void *)ttydispatch, 36 },
 
 /* NULLDEV is null */
@@ -31,6 +33,7 @@ struct	dentry	devtab[NDEVS] =
 	  (void *)ionull, (void *)ionull, (void *)ionull,
 	  (void *)ionull, (void *)ionull, (void *)ioerr,
 	  (void *)ionull, (void *)ionull, (void *)ioerr,
+	  (void *)ioerr, (void *)ioreadv, (void *)iowritev,
 	  (void *)0x0, (void *)ioerr, 0 },
 
 /* ETHER0 is eth */
@@ -38,6 +41,7 @@ struct	dentry	devtab[NDEVS] =
 	  (void *)ethinit, (void *)ioerr, (void *)ioerr,
 	  (void *)ethread, (void *)ethwrite, (void *)ioerr,
 	  (void *)ioerr, (void *)ioerr, (void *)ethcontrol,
+	  (void *)ioerr, (void *)ethreadv, (void *)ethwritev,
 	  (void *)0x0, (void *)ethdispatch, 0 },
 
 /* NAMESPACE is nam */
@@ -45,6 +49,7 @@ struct	dentry	devtab[NDEVS] =
 	  (void *)naminit, (void *)namopen, (void *)ioerr,
 	  (void *)ioerr, (void *)ioerr, (void *)ioerr,
 	  (void *)ioerr, (void *)ioerr, (void *)ioerr,
+	  (void *)ioerr, (void *)ioreadv, (void *)iowritev,
 	  (void *)0x0, (void *)ioerr, 0 },
 
 /* RDISK is rds */
@@ -52,13 +57,15 @@ struct	dentry	devtab[NDEVS] =
 	  (void *)rdsinit, (void *)rdsopen, (void *)ioerr,
 	  (void *)rdsread, (void *)rdswrite, (void *)ioerr,
 	  (void *)ioerr, (void *)ioerr, (void *)rdscontrol,
+	  (void *)rdsbio, (void *)ioerr, (void *)ioerr,
 	  (void *)0x0, (void *)ionull, 0 },
 
 /* RAM0 is ram */
 	{ 5, 0, "RAM0",
 	  (void *)raminit, (void *)ramopen, (void *)ramclose,
 	  (void *)ramread, (void *)ramwrite, (void *)ioerr,
-	  (void *)ioerr, (void *)ioerr, (void *)ioerr,
+	  (void *)ioerr, (void *)ioerr, (void *)ramcontrol,
+	  (void *)rambio, (void *)ioerr, (void *)ioerr,
 	  (void *)0x0, (void *)ionull, 0 },
 
 /* RFILESYS is rfs */
@@ -66,6 +73,7 @@ struct	dentry	devtab[NDEVS] =
 	  (void *)rfsinit, (void *)rfsopen, (void *)ioerr,
 	  (void *)ioerr, (void *)ioerr, (void *)ioerr,
 	  (void *)ioerr, (void *)ioerr, (void *)rfscontrol,
+	  (void *)ioerr, (void *)ioreadv, (void *)iowritev,
 	  (void *)0x0, (void *)ionull, 0 },
 
 /* RFILE0 is rfl */
@@ -73,6 +81,7 @@ struct	dentry	devtab[NDEVS] =
 	  (void *)rflinit, (void *)ioerr, (void *)rflclose,
 	  (void *)rflread, (void *)rflwrite, (void *)rflseek,
 	  (void *)rflgetc, (void *)rflputc, (void *)ioerr,
+	  (void *)ioerr, (void *)ioreadv, (void *)iowritev,
 	  (void *)0x0, (void *)ionull, 0 },
 
 /* RFILE1 is rfl */
@@ -80,6 +89,7 @@ struct	dentry	devtab[NDEVS] =
 	  (void *)rflinit, (void *)ioerr, (void *)rflclose,
 	  (void *)rflread, (void *)rflwrite, (void *)rflseek,
 	  (void *)rflgetc, (void *)rflputc, (void *)ioerr,
+	  (void *)ioerr, (void *)ioreadv, (void *)iowritev,
 	  (void *)0x0, (void *)ionull, 0 },
 
 /* RFILE2 is rfl */
@@ -87,6 +97,7 @@ struct	dentry	devtab[NDEVS] =
 	  (void *)rflinit, (void *)ioerr, (void *)rflclose,
 	  (void *)rflread, (void *)rflwrite, (void *)rflseek,
 	  (void *)rflgetc, (void *)rflputc, (void *)ioerr,
+	  (void *)ioerr, (void *)ioreadv, (void *)iowritev,
 	  (void *)0x0, (void *)ionull, 0 },
 
 /* RFILE3 is rfl */
@@ -94,6 +105,7 @@ struct	dentry	devtab[NDEVS] =
 	  (void *)rflinit, (void *)ioerr, (void *)rflclose,
 	  (void *)rflread, (void *)rflwrite, (void *)rflseek,
 	  (void *)rflgetc, (void *)rflputc, (void *)ioerr,
+	  (void *)ioerr, (void *)ioreadv, (void *)iowritev,
 	  (void *)0x0, (void *)ionull, 0 },
 
 /* RFILE4 is rfl */
@@ -101,6 +113,7 @@ struct	dentry	devtab[NDEVS] =
 	  (void *)rflinit, (void *)ioerr, (void *)rflclose,
 	  (void *)rflread, (void *)rflwrite, (void *)rflseek,
 	  (void *)rflgetc, (void *)rflputc, (void *)ioerr,
+	  (void *)ioerr, (void *)ioreadv, (void *)iowritev,
 	  (void *)0x0, (void *)ionull, 0 },
 
 /* RFILE5 is rfl */
@@ -108,6 +121,7 @@ struct	dentry	devtab[NDEVS] =
 	  (void *)rflinit, (void *)ioerr, (void *)rflclose,
 	  (void *)rflread, (void *)rflwrite, (void *)rflseek,
 	  (void *)rflgetc, (void *)rflputc, (void *)ioerr,
+	  (void *)ioerr, (void *)ioreadv, (void *)iowritev,
 	  (void *)0x0, (void *)ionull, 0 },
 
 /* RFILE6 is rfl */
@@ -115,6 +129,7 @@ struct	dentry	devtab[NDEVS] =
 	  (void *)rflinit, (void *)ioerr, (void *)rflclose,
 	  (void *)rflread, (void *)rflwrite, (void *)rflseek,
 	  (void *)rflgetc, (void *)rflputc, (void *)ioerr,
+	  (void *)ioerr, (void *)ioreadv, (void *)iowritev,
 	  (void *)0x0, (void *)ionull, 0 },
 
 /* RFILE7 is rfl */
@@ -122,6 +137,7 @@ struct	dentry	devtab[NDEVS] =
 	  (void *)rflinit, (void *)ioerr, (void *)rflclose,
 	  (void *)rflread, (void *)rflwrite, (void *)rflseek,
 	  (void *)rflgetc, (void *)rflputc, (void *)ioerr,
+	  (void *)ioerr, (void *)ioreadv, (void *)iowritev,
 	  (void *)0x0, (void *)ionull, 0 },
 
 /* RFILE8 is rfl */
@@ -129,6 +145,7 @@ struct	dentry	devtab[NDEVS] =
 	  (void *)rflinit, (void *)ioerr, (void *)rflclose,
 	  (void *)rflread, (void *)rflwrite, (void *)rflseek,
 	  (void *)rflgetc, (void *)rflputc, (void *)ioerr,
+	  (void *)ioerr, (void *)ioreadv, (void *)iowritev,
 	  (void *)0x0, (void *)ionull, 0 },
 
 /* RFILE9 is rfl */
@@ -136,13 +153,15 @@ struct	dentry	devtab[NDEVS] =
 	  (void *)rflinit, (void *)ioerr, (void *)rflclose,
 	  (void *)rflread, (void *)rflwrite, (void *)rflseek,
 	  (void *)rflgetc, (void *)rflputc, (void *)ioerr,
+	  (void *)ioerr, (void *)ioreadv, (void *)iowritev,
 	  (void *)0x0, (void *)ionull, 0 },
 
 /* LFILESYS is lfs */
 	{ 17, 0, "LFILESYS",
 	  (void *)lfsinit, (void *)lfsopen, (void *)ioerr,
 	  (void *)ioerr, (void *)ioerr, (void *)ioerr,
-	  (void *)ioerr, (void *)ioerr, (void *)ioerr,
+	  (void *)ioerr, (void *)ioerr, (void *)lfscontrol,
+	  (void *)ioerr, (void *)ioreadv, (void *)iowritev,
 	  (void *)0x0, (void *)ionull, 0 },
 
 /* LFILE0 is lfl */
@@ -150,6 +169,7 @@ struct	dentry	devtab[NDEVS] =
 	  (void *)lflinit, (void *)ioerr, (void *)lflclose,
 	  (void *)lflread, (void *)lflwrite, (void *)lflseek,
 	  (void *)lflgetc, (void *)lflputc, (void *)lflcontrol,
+	  (void *)ioerr, (void *)lflreadv, (void *)lflwritev,
 	  (void *)0x0, (void *)ionull, 0 },
 
 /* LFILE1 is lfl */
@@ -157,6 +177,7 @@ struct	dentry	devtab[NDEVS] =
 	  (void *)lflinit, (void *)ioerr, (void *)lflclose,
 	  (void *)lflread, (void *)lflwrite, (void *)lflseek,
 	  (void *)lflgetc, (void *)lflputc, (void *)lflcontrol,
+	  (void *)ioerr, (void *)lflreadv, (void *)lflwritev,
 	  (void *)0x0, (void *)ionull, 0 },
 
 /* LFILE2 is lfl */
@@ -164,6 +185,7 @@ struct	dentry	devtab[NDEVS] =
 	  (void *)lflinit, (void *)ioerr, (void *)lflclose,
 	  (void *)lflread, (void *)lflwrite, (void *)lflseek,
 	  (void *)lflgetc, (void *)lflputc, (void *)lflcontrol,
+	  (void *)ioerr, (void *)lflreadv, (void *)lflwritev,
 	  (void *)0x0, (void *)ionull, 0 },
 
 /* LFILE3 is lfl */
@@ -171,6 +193,7 @@ struct	dentry	devtab[NDEVS] =
 	  (void *)lflinit, (void *)ioerr, (void *)lflclose,
 	  (void *)lflread, (void *)lflwrite, (void *)lflseek,
 	  (void *)lflgetc, (void *)lflputc, (void *)lflcontrol,
+	  (void *)ioerr, (void *)lflreadv, (void *)lflwritev,
 	  (void *)0x0, (void *)ionull, 0 },
 
 /* LFILE4 is lfl */
@@ -178,6 +201,7 @@ struct	dentry	devtab[NDEVS] =
 	  (void *)lflinit, (void *)ioerr, (void *)lflclose,
 	  (void *)lflread, (void *)lflwrite, (void *)lflseek,
 	  (void *)lflgetc, (void *)lflputc, (void *)lflcontrol,
+	  (void *)ioerr, (void *)lflreadv, (void *)lflwritev,
 	  (void *)0x0, (void *)ionull, 0 },
 
 /* LFILE5 is lfl */
@@ -185,5 +209,6 @@ struct	dentry	devtab[NDEVS] =
 	  (void *)lflinit, (void *)ioerr, (void *)lflclose,
 	  (void *)lflread, (void *)lflwrite, (void *)lflseek,
 	  (void *)lflgetc, (void *)lflputc, (void *)lflcontrol,
+	  (void *)ioerr, (void *)lflreadv, (void *)lflwritev,
 	  (void *)0x0, (void *)ionull, 0 }
 };
@@ -2,6 +2,9 @@
 
 /* Device switch table declarations */
 
+struct	bioreq;
+struct	iovec;
+
 /* Device table entry */
 struct	dentry	{
 	int32   dvnum;
@@ -16,6 +19,9 @@ struct	dentry	{
 	devcall (*dvgetc) (struct dentry *);
 	devcall (*dvputc) (struct dentry *, char);
 	devcall (*dvcntl) (struct dentry *, int32, int32, int32);
+	devcall (*dvbio)  (struct dentry *, struct bioreq *);
+	devcall (*dvreadv)(struct dentry *, struct iovec *, int32);
+	devcall (*dvwritev)(struct dentry *, struct iovec *, int32);
 	void    *dvcsr;
 	void    (*dvintr)(void);
 	byte    dvirq;
@@ -74,6 +80,9 @@ extern	struct	dentry	devtab[]; /* one entry per device */
 #define	IRQ_TIMER    IRQ_HW5	/* timer IRQ is wired to hardware 5	*/
 #define	IRQ_ATH_MISC IRQ_HW4	/* Misc. IRQ is wired to hardware 4	*/
 #define CLKFREQ      200000000	/* 200 MHz clock			*/
+#define	ETH_MTU	     1500	/* Ethernet MTU (up to 9000 enables	*/
+				/*   jumbo frames on the 82545EM)	*/
+#define	TY_OBUFLEN   256	/* chars in a tty output queue		*/
 
 #ifndef	ETHER0
 #define	ETHER0	0
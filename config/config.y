@@ -10,7 +10,7 @@
 /************************************************************************/
 
 %token	DEFBRK IFBRK COLON OCTAL INTEGER IDENT CSR IRQ INTR INIT OPEN
-	CLOSE READ WRITE SEEK CONTROL IS ON GETC PUTC
+	CLOSE READ WRITE SEEK CONTROL IS ON GETC PUTC BIO READV WRITEV
 %{
 #include <stdlib.h>
 #include <stdio.h>
@@ -68,6 +68,9 @@ struct	dev_ent	{			/* Entry for a device or device type	*/
 	char	seek[MAXNAME];		/* seek function name			*/
 	char	getc[MAXNAME];		/* getc function name			*/
 	char	putc[MAXNAME];		/* putc function name			*/
+	char	bio[MAXNAME];		/* async block I/O function name	*/
+	char	readv[MAXNAME];		/* vectored read function name		*/
+	char	writev[MAXNAME];	/* vectored write function name		*/
 	int	minor;			/* In a device, the minor device	*/
 					/*  assigned to the device 0,1,...	*/
 					/*  in a type, the next minor number	*/
@@ -80,6 +83,8 @@ struct	dev_ent		devs[NDEVS];	/* Table of all devices			*/
 int	ndevs = 0;			/* Number of devices found		*/
 
 char *devstab[] = {
+	"struct\tbioreq;",
+	"struct\tiovec;\n",
 	"/* Device table entry */",
 	"struct\tdentry\t{",
 	"\tint32   dvnum;",
@@ -94,6 +99,9 @@ char *devstab[] = {
 	"\tdevcall (*dvgetc) (struct dentry *);",
 	"\tdevcall (*dvputc) (struct dentry *, char);",
 	"\tdevcall (*dvcntl) (struct dentry *, int32, int32, int32);",
+	"\tdevcall (*dvbio)  (struct dentry *, struct bioreq *);",
+	"\tdevcall (*dvreadv)(struct dentry *, struct iovec *, int32);",
+	"\tdevcall (*dvwritev)(struct dentry *, struct iovec *, int32);",
 	"\tvoid    *dvcsr;",
 	"\tvoid    (*dvintr)(void);",
 	"\tbyte    dvirq;",
@@ -175,6 +183,9 @@ attr:		  CSR number		{ addattr(CSR,    $2);	}
 		| WRITE id		{ addattr(WRITE,   0);	}
 		| SEEK id		{ addattr(SEEK,    0);	}
 		| CONTROL id		{ addattr(CONTROL, 0);	}
+		| BIO id		{ addattr(BIO,     0);	}
+		| READV id		{ addattr(READV,   0);	}
+		| WRITEV id		{ addattr(WRITEV,  0);	}
 ;
 
 id:		IDENT { $$ = 0; getattrid(yytext); }
@@ -379,13 +390,14 @@ int main(int argc, char **argv) {
 	if (ndevs > 0)
 	{
 		fprintf(confc, "struct	dentry	devtab[NDEVS] =\n{\n");
-		fprintf(confc, "%s\n%s\n%s\n%s\n%s\n%s\n%s\n%s\n\n",
+		fprintf(confc, "%s\n%s\n%s\n%s\n%s\n%s\n%s\n%s\n%s\n\n",
 			"/**",
 			" * Format of entries is:",
 			" * dev-number, minor-number, dev-name,",
 			" * init, open, close,",
 			" * read, write, seek,",
 			" * getc, putc, control,",
+			" * bio, readv, writev,",
 			" * dev-csr-address, intr-handler, irq",
 			" */");
 	}
@@ -400,6 +412,8 @@ int main(int argc, char **argv) {
 			s->read, s->write, s->seek);
 		fprintf(confc, "\t  (void *)%s, (void *)%s, (void *)%s,\n",
 			s->getc, s->putc, s->control);
+		fprintf(confc, "\t  (void *)%s, (void *)%s, (void *)%s,\n",
+			s->bio, s->readv, s->writev);
 		fprintf(confc, "\t  (void *)0x%x, (void *)%s, %d }",
 			s->csr, s->intr, s->irq);
 		if (i< ndevs-1) {
@@ -458,6 +472,9 @@ void	addattr(int tok, int val) {
 	case INIT:	strcpy(s->init, saveattrid);	break;
 	case SEEK:	strcpy(s->seek, saveattrid);	break;
 	case CONTROL:	strcpy(s->control,saveattrid);	break;
+	case BIO:	strcpy(s->bio,  saveattrid);	break;
+	case READV:	strcpy(s->readv,saveattrid);	break;
+	case WRITEV:	strcpy(s->writev,saveattrid);	break;
 	default:	fprintf(stderr, "Internal error 1\n");
 	}
 }
@@ -721,6 +738,9 @@ int	newtype(char *name) {
 	strncpy(dptr->seek,	"ioerr", 5);
 	strncpy(dptr->getc,	"ioerr", 5);
 	strncpy(dptr->putc,	"ioerr", 5);
+	strncpy(dptr->bio,	"ioerr", 5);
+	strncpy(dptr->readv,	"ioreadv", 7);
+	strncpy(dptr->writev,	"iowritev", 8);
 
 	return ntypes++;
 }
@@ -348,12 +348,31 @@ local void _82545EM_configure_rx(
 		  E1000_RCTL_LPE   |
 		  E1000_RCTL_SECRC |
 		  E1000_RCTL_PMCF);
+
+	/* Enable long packet receive if the MTU allows jumbo frames	*/
+
+	if (ETH_JUMBO) {
+		rctl |= E1000_RCTL_LPE;
+	}
 	
-	/* Setup buffer sizes */
+	/* Setup buffer sizes (sizes above 2048 use the extension)	*/
 
 	rctl &= ~(E1000_RCTL_BSEX |
 		  E1000_RCTL_SZ_4096);
-	rctl |= E1000_RCTL_SZ_2048;
+	switch (ETH_BUF_SIZE) {
+	case 4096:
+		rctl |= E1000_RCTL_BSEX | E1000_RCTL_SZ_4096;
+		break;
+	case 8192:
+		rctl |= E1000_RCTL_BSEX | E1000_RCTL_SZ_8192;
+		break;
+	case 16384:
+		rctl |= E1000_RCTL_BSEX | E1000_RCTL_SZ_16384;
+		break;
+	default:
+		rctl |= E1000_RCTL_SZ_2048;
+		break;
+	}
 
 	/* Set the Receive Delay Timer Register, let driver be notified */
 	/* 	immediately each time a new packet has been stored in 	*/
@@ -56,13 +56,15 @@ local 	void 	eth_txPackets(
 		if (!(descptr->upper.data & E1000_TXD_STAT_DD))
 			break;
 
-		/* Clear the write-back descriptor and buffer */
+		/* Clear the part of the buffer used (the low 16 bits	*/
+		/*	of the command word hold the length) and the	*/
+		/*	write-back descriptor				*/
 
-		descptr->lower.data = 0;
-		descptr->upper.data = 0;
 		pktptr = (char *)((uint32)(descptr->buffer_addr &
 					   ADDR_BIT_MASK));
-		memset(pktptr, '\0', ETH_BUF_SIZE);
+		memset(pktptr, '\0', descptr->lower.data & 0xffff);
+		descptr->lower.data = 0;
+		descptr->upper.data = 0;
 
 		ethptr->txHead 
 			= (ethptr->txHead + 1) % ethptr->txRingSize;
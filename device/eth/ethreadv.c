@@ -0,0 +1,94 @@
+/* ethreadv.c - ethreadv */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ * ethreadv - read a packet from an E1000E device, scattering it
+ *		across a vector of buffers
+ *------------------------------------------------------------------------
+ */
+devcall	ethreadv(
+	struct	dentry	*devptr,	/* entry in device switch table	*/
+	struct	iovec	*iov,		/* buffers to hold the packet	*/
+	int32	iovcnt			/* number of buffers		*/
+	)
+{
+	struct 	ethcblk	*ethptr; 	/* ptr to entry in ethertab	*/
+	struct	eth_rx_desc *descptr;	/* ptr to ring descriptor	*/
+	char	*pktptr;		/* ptr used during packet copy	*/
+	uint32	head;			/* head of ring buffer 		*/
+	uint32	status;			/* status of entry		*/
+	uint32	length;			/* packet length		*/
+	int32 	retval;
+	uint32 	rdt;
+	uint32	len;			/* total length of the buffers	*/
+	uint32	span;			/* bytes copied to one buffer	*/
+	int32	i;			/* index into vector		*/
+
+	ethptr = &ethertab[devptr->dvminor];
+
+	len = 0;
+	for (i=0; i<iovcnt; i++) {
+		len += iov[i].iov_len;
+	}
+
+	if ((ETH_STATE_UP != ethptr->state)
+			|| (len < ETH_HDR_LEN)) {
+		return SYSERR;
+	}
+
+	/* Wait for a packet to arrive */
+
+	wait(ethptr->isem);
+
+	/* Find out where to pick up the packet */
+
+	head = ethptr->rxHead;
+	descptr = (struct eth_rx_desc *)ethptr->rxRing + head;
+	status = descptr->status;
+
+	if (!(status & E1000_RXD_STAT_DD)) { 	/* check for error */
+		kprintf("ethread: packet error!\n");
+		retval = SYSERR;
+	} else { 	/* pick up the packet */			
+		pktptr = (char *)((uint32)(descptr->buffer_addr &
+					   ADDR_BIT_MASK));
+		length = descptr->length;
+		if (length > len) {
+			length = len;
+		}
+		retval = length;
+		for (i=0; (i<iovcnt) && (length>0); i++) {
+			span = iov[i].iov_len;
+			if (span > length) {
+				span = length;
+			}
+			memcpy(iov[i].iov_base, pktptr, span);
+			pktptr += span;
+			length -= span;
+		}
+	}
+	/* Clear up the descriptor and the part of the buffer used	*/
+
+	memset((char *)((uint32)(descptr->buffer_addr & ADDR_BIT_MASK)), 
+			'\0', descptr->length); 
+	descptr->length = 0;
+	descptr->csum = 0;
+	descptr->status = 0;
+	descptr->errors = 0;
+	descptr->special = 0;
+
+	/* Add newly reclaimed descriptor to the ring */
+
+	if (ethptr->rxHead % E1000_RING_BOUNDARY == 0) {
+		rdt = eth_io_readl(ethptr->iobase, E1000_RDT(0));
+		rdt = (rdt + E1000_RING_BOUNDARY) % ethptr->rxRingSize;
+		eth_io_writel(ethptr->iobase, E1000_RDT(0), rdt);
+	}
+
+	/* Advance the head pointing to the next ring descriptor which 	*/
+	/*  	will be ready to be picked up 				*/
+	ethptr->rxHead = (ethptr->rxHead + 1) % ethptr->rxRingSize;
+
+	return retval;
+}
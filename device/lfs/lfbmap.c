@@ -0,0 +1,84 @@
+/* lfbmap.c - lfbmap */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ * lfbmap  -  Map a byte offset in a file given by its first i-block to
+ *		the disk sector that holds it, optionally allocating the
+ *		d-block just beyond the end of the file (used for
+ *		directories; assumes directory mutex held)
+ *------------------------------------------------------------------------
+ */
+dbid32	lfbmap (
+	  ibid32	ilist,		/* First i-block of the file	*/
+	  uint32	offset,		/* Byte offset in the file	*/
+	  bool8		alloc		/* Allocate a missing d-block?	*/
+	)
+{
+	struct	lfiblk	iblock;		/* Buffer for one index block	*/
+	ibid32	ibnum;			/* ID of the i-block in iblock	*/
+	ibid32	newib;			/* ID of a new i-block		*/
+	struct	lfext	*xptr;		/* Ptr to an extent		*/
+	uint32	spb;			/* Sectors in a d-block		*/
+	uint32	fbn;			/* D-block of the file		*/
+	uint32	blk;			/* First d-block of an extent	*/
+	dbid32	prevdb;			/* Last d-block of the file	*/
+	dbid32	dnum;			/* D-block found or allocated	*/
+	int32	i;			/* Index of an extent		*/
+
+	spb = Lf_data.lf_spb;
+	fbn = offset / (spb * LF_BLKSIZ);
+
+	/* Walk the i-block list looking for the extent that holds fbn	*/
+
+	ibnum = ilist;
+	lfibget(Lf_data.lf_dskdev, ibnum, &iblock);
+	while (TRUE) {
+		blk = iblock.ib_offset;
+		for (i=0; i<LF_NEXTENT; i++) {
+			xptr = &iblock.ib_ext[i];
+			if (xptr->ex_len == 0) {
+				break;
+			}
+			if (fbn < blk + xptr->ex_len) {
+				return xptr->ex_start + (fbn - blk) * spb +
+					(offset / LF_BLKSIZ) % spb;
+			}
+			blk += xptr->ex_len;
+		}
+		if (iblock.ib_next == LF_INULL) {
+			break;
+		}
+		ibnum = iblock.ib_next;
+		lfibget(Lf_data.lf_dskdev, ibnum, &iblock);
+	}
+	if ( !alloc || (fbn != blk) ) {
+		return LF_DNULL;
+	}
+
+	/* Allocate a d-block after the last one of the file, extending	*/
+	/*   the last extent when the new block is contiguous with it	*/
+
+	prevdb = LF_DNULL;
+	if (i > 0) {
+		xptr = &iblock.ib_ext[i-1];
+		prevdb = xptr->ex_start + (xptr->ex_len - 1) * spb;
+	}
+	dnum = lfdballoc(prevdb);
+	if ( (prevdb != LF_DNULL) && (dnum == prevdb + spb) ) {
+		xptr->ex_len++;
+	} else if (i < LF_NEXTENT) {
+		iblock.ib_ext[i].ex_start = dnum;
+		iblock.ib_ext[i].ex_len = 1;
+	} else {
+		newib = lfiballoc();
+		iblock.ib_next = newib;
+		lfibput(Lf_data.lf_dskdev, ibnum, &iblock);
+		ibnum = newib;
+		lfibclear(&iblock, blk);
+		iblock.ib_ext[0].ex_start = dnum;
+		iblock.ib_ext[0].ex_len = 1;
+	}
+	lfibput(Lf_data.lf_dskdev, ibnum, &iblock);
+	return dnum + (offset / LF_BLKSIZ) % spb;
+}
@@ -0,0 +1,28 @@
+/* lfbmflush.c - lfbmflush */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ * lfbmflush  -  Write the changed sectors of the in-memory d-block
+ *		   bitmap to disk (assumes directory mutex held)
+ *------------------------------------------------------------------------
+ */
+status	lfbmflush(void)
+{
+	uint32	sect;			/* Bitmap sector to write	*/
+	status	retval;			/* Value to return		*/
+
+	if (Lf_data.lf_bmnchg == 0) {
+		return OK;
+	}
+	retval = OK;
+	for (sect=Lf_data.lf_bmlo; sect<=Lf_data.lf_bmhi; sect++) {
+		if (bcwrite(Lf_data.lf_dskdev,
+			    (char *)&Lf_data.lf_dbmap[sect * LF_BLKSIZ],
+			    Lf_data.lf_dir.lfd_bmsect + sect) == SYSERR) {
+			retval = SYSERR;
+		}
+	}
+	Lf_data.lf_bmnchg = 0;
+	return retval;
+}
@@ -0,0 +1,45 @@
+/* lfbmload.c - lfbmload */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ * lfbmload  -  Read the d-block bitmap described by the in-memory
+ *		  directory into memory and count the free d-blocks (called
+ *		  when the directory is loaded; assumes directory mutex held)
+ *------------------------------------------------------------------------
+ */
+status	lfbmload(void)
+{
+	struct	lfdir	*dirptr;	/* Pointer to directory		*/
+	uint32	nsect;			/* Number of bitmap sectors	*/
+	uint32	sect;			/* Bitmap sector to read	*/
+	uint32	idx;			/* Index of d-block in bitmap	*/
+
+	dirptr = &Lf_data.lf_dir;
+	nsect = lfbmsects(dirptr->lfd_ndblks);
+	Lf_data.lf_dbmap = (byte *)getmem(nsect * LF_BLKSIZ);
+	if ((int32)Lf_data.lf_dbmap == SYSERR) {
+		Lf_data.lf_dbmap = NULL;
+		return SYSERR;
+	}
+	for (sect=0; sect<nsect; sect++) {
+		if (bcread(Lf_data.lf_dskdev,
+			   (char *)&Lf_data.lf_dbmap[sect * LF_BLKSIZ],
+			   dirptr->lfd_bmsect + sect) == SYSERR) {
+			freemem((char *)Lf_data.lf_dbmap, nsect * LF_BLKSIZ);
+			Lf_data.lf_dbmap = NULL;
+			return SYSERR;
+		}
+	}
+
+	/* Count the free d-blocks */
+
+	Lf_data.lf_dbfree = 0;
+	for (idx=0; idx<dirptr->lfd_ndblks; idx++) {
+		if ( (Lf_data.lf_dbmap[idx >> 3] & (1 << (idx & 0x7))) == 0 ) {
+			Lf_data.lf_dbfree++;
+		}
+	}
+	Lf_data.lf_bmnchg = 0;
+	return OK;
+}
@@ -2,39 +2,76 @@
 
 #include <xinu.h>
 
-#define  DFILL  '+'		/* character used to fill a disk block	*/
-
 /*------------------------------------------------------------------------
- * lfdballoc  -  Allocate a new data block from free list on disk
- *			(assumes directory mutex held)
+ * lfdballoc  -  Allocate a new data block from the in-memory bitmap,
+ *			preferring the block that follows the file's
+ *			previous data block and return the first sector
+ *			of the new block (assumes directory mutex held)
  *------------------------------------------------------------------------
  */
 dbid32	lfdballoc (
-	  struct lfdbfree *dbuff /* Addr. of buffer to hold data block	*/
+	  dbid32	prev		/* File's previous d-block or	*/
+					/*   LF_DNULL if there is none	*/
 	)
 {
-	dbid32	dnum;		/* ID of next d-block on the free list	*/
-	int32	retval;		/* Return value				*/
-
-	/* Get the ID of first data block on the free list */
+	struct	lfdir	*dirptr;	/* Pointer to directory		*/
+	byte	*map;			/* Pointer to the bitmap	*/
+	uint32	nblks;			/* Number of d-blocks on disk	*/
+	uint32	idx;			/* Index of d-block in bitmap	*/
+	uint32	n;			/* Number of bits examined	*/
+	uint32	sect;			/* Bitmap sector for the block	*/
+	uint32	spb;			/* Sectors in a d-block		*/
 
-	dnum = Lf_data.lf_dir.lfd_dfree;
-	if (dnum == LF_DNULL) {	/* Ran out of free data blocks */
+	if (Lf_data.lf_dbfree == 0) {	/* Ran out of free data blocks	*/
 		panic("out of data blocks");
 	}
-	retval = read(Lf_data.lf_dskdev, (char *)dbuff, dnum);
-	if (retval == SYSERR) {
-		panic("lfdballoc cannot read disk block\n");
+	dirptr = &Lf_data.lf_dir;
+	map = Lf_data.lf_dbmap;
+	nblks = dirptr->lfd_ndblks;
+	spb = Lf_data.lf_spb;
+
+	/* Start the search just beyond the previous data block */
+
+	idx = 0;
+	if ( (prev != LF_DNULL) && (prev >= dirptr->lfd_dstart) &&
+	     ((prev - dirptr->lfd_dstart) / spb + 1 < nblks) ) {
+		idx = (prev - dirptr->lfd_dstart) / spb + 1;
 	}
 
-	/* Unlink d-block from in-memory directory */
+	/* Search forward, wrapping around, and skip a byte of the map	*/
+	/*   at a time when all eight blocks are in use (bits beyond	*/
+	/*   the last block are always set)				*/
 
-	Lf_data.lf_dir.lfd_dfree = dbuff->lf_nextdb;
-	write(Lf_data.lf_dskdev, (char *)&Lf_data.lf_dir, LF_AREA_DIR);
-	Lf_data.lf_dirdirty = FALSE;
+	for (n=0; n<nblks+8; n++, idx++) {
+		if (idx >= nblks) {
+			idx = 0;
+		}
+		if ( ((idx & 0x7) == 0) && (map[idx >> 3] == 0xff) ) {
+			idx += 7;
+			n += 7;
+			continue;
+		}
+		if ( (map[idx >> 3] & (1 << (idx & 0x7))) == 0 ) {
+			break;
+		}
+	}
+	if (n >= nblks+8) {
+		panic("d-block bitmap is inconsistent");
+	}
 
-	/* Fill data block to erase old data */
+	/* Mark the block in use and record the change */
 
-	memset((char *)dbuff, DFILL, LF_BLKSIZ);
-	return dnum;
+	map[idx >> 3] |= (1 << (idx & 0x7));
+	Lf_data.lf_dbfree--;
+	sect = idx / LF_BMBITS;
+	if ( (Lf_data.lf_bmnchg == 0) || (sect < Lf_data.lf_bmlo) ) {
+		Lf_data.lf_bmlo = sect;
+	}
+	if ( (Lf_data.lf_bmnchg == 0) || (sect > Lf_data.lf_bmhi) ) {
+		Lf_data.lf_bmhi = sect;
+	}
+	if (++Lf_data.lf_bmnchg >= LF_BMBATCH) {
+		lfbmflush();
+	}
+	return dirptr->lfd_dstart + idx * spb;
 }
@@ -3,23 +3,47 @@
 #include <xinu.h>
 
 /*------------------------------------------------------------------------
- *  lfdbfree  -  Free a data block given its block number (assumes
- *			directory mutex is held)
+ *  lfdbfree  -  Free a data block given its block number by clearing
+ *			its bit in the in-memory bitmap (assumes directory
+ *			mutex is held)
  *------------------------------------------------------------------------
  */
 status	lfdbfree(
 	  did32		diskdev,	/* ID of disk device to use	*/
-	  dbid32	dnum		/* ID of data block to free	*/
+	  dbid32	dnum		/* First sector of data block	*/
+					/*   to free			*/
 	)
 {
 	struct	lfdir	*dirptr;	/* Pointer to directory		*/
-	struct	lfdbfree buf;		/* Buffer to hold data block	*/
+	uint32	idx;			/* Index of d-block in bitmap	*/
+	uint32	sect;			/* Bitmap sector for the block	*/
 
 	dirptr = &Lf_data.lf_dir;
-	buf.lf_nextdb = dirptr->lfd_dfree;
-	dirptr->lfd_dfree = dnum;
-	write(diskdev, (char *)&buf,   dnum);
-	write(diskdev, (char *)dirptr, LF_AREA_DIR);
+	if ( (diskdev != Lf_data.lf_dskdev) || (dnum < dirptr->lfd_dstart)
+	     || ((dnum - dirptr->lfd_dstart) % Lf_data.lf_spb != 0) ) {
+		return SYSERR;
+	}
+	idx = (dnum - dirptr->lfd_dstart) / Lf_data.lf_spb;
+	if (idx >= dirptr->lfd_ndblks) {
+		return SYSERR;
+	}
+	if ( (Lf_data.lf_dbmap[idx >> 3] & (1 << (idx & 0x7))) == 0 ) {
+		return SYSERR;		/* Block is already free	*/
+	}
+	Lf_data.lf_dbmap[idx >> 3] &= ~(1 << (idx & 0x7));
+	Lf_data.lf_dbfree++;
 
+	/* Record the change; the bitmap is written in batches */
+
+	sect = idx / LF_BMBITS;
+	if ( (Lf_data.lf_bmnchg == 0) || (sect < Lf_data.lf_bmlo) ) {
+		Lf_data.lf_bmlo = sect;
+	}
+	if ( (Lf_data.lf_bmnchg == 0) || (sect > Lf_data.lf_bmhi) ) {
+		Lf_data.lf_bmhi = sect;
+	}
+	if (++Lf_data.lf_bmnchg >= LF_BMBATCH) {
+		lfbmflush();
+	}
 	return OK;
 }
@@ -0,0 +1,103 @@
+/* lfdcfcns.c - lfdcfind, lfdcadd, lfdcinval */
+
+#include <xinu.h>
+
+/* First entry of the set of cache entries a name can occupy */
+
+#define	lfdcset(dir, name) \
+	(&Lf_data.lf_dcache[(((dir) + lfdhash(name)) % \
+			(LF_NDCACHE / LF_DCWAYS)) * LF_DCWAYS])
+
+/*------------------------------------------------------------------------
+ * lfdcfind  -  Look up a name in the dentry cache and return the slot
+ *		  that holds its entry, or SYSERR if the name is not cached
+ *		  (assumes directory mutex held)
+ *------------------------------------------------------------------------
+ */
+int32	lfdcfind (
+	  ibid32	dir,		/* Directory holding the name	*/
+	  char		*name,		/* Name to find			*/
+	  ibid32	*ilist,		/* Where to store the first	*/
+					/*   i-block of a directory	*/
+	  byte		*type		/* Where to store the type	*/
+	)
+{
+	struct	lfdcent	*dcptr;		/* Walks the set of entries	*/
+	int32	i;			/* Index into the set		*/
+
+	dcptr = lfdcset(dir, name);
+	for (i=0; i<LF_DCWAYS; i++, dcptr++) {
+		if ( (dcptr->dc_dir == dir) &&
+		     (strncmp(dcptr->dc_name, name, LF_NAME_LEN) == 0) ) {
+			dcptr->dc_time = ++Lf_data.lf_dcclock;
+			*ilist = dcptr->dc_ilist;
+			*type = dcptr->dc_type;
+			return dcptr->dc_slot;
+		}
+	}
+	return SYSERR;
+}
+
+/*------------------------------------------------------------------------
+ * lfdcadd  -  Add the location of an entry to the dentry cache,
+ *		 replacing the least-recently used entry of the set
+ *		 (assumes directory mutex held)
+ *------------------------------------------------------------------------
+ */
+void	lfdcadd (
+	  ibid32	dir,		/* Directory holding the entry	*/
+	  int32		slot,		/* Slot that holds the entry	*/
+	  struct ldentry *ent		/* The entry			*/
+	)
+{
+	struct	lfdcent	*dcptr;		/* Walks the set of entries	*/
+	struct	lfdcent	*vptr;		/* Entry to replace		*/
+	int32	i;			/* Index into the set		*/
+
+	dcptr = lfdcset(dir, ent->ld_name);
+	vptr = dcptr;
+	for (i=0; i<LF_DCWAYS; i++, dcptr++) {
+		if ( (dcptr->dc_dir == dir) && (strncmp(dcptr->dc_name,
+				ent->ld_name, LF_NAME_LEN) == 0) ) {
+			vptr = dcptr;
+			break;
+		}
+		if (dcptr->dc_dir == LF_INULL) {
+			vptr = dcptr;
+		} else if ( (vptr->dc_dir != LF_INULL) &&
+			    (dcptr->dc_time < vptr->dc_time) ) {
+			vptr = dcptr;
+		}
+	}
+	vptr->dc_dir = dir;
+	vptr->dc_slot = slot;
+	vptr->dc_ilist = ent->ld_ilist;
+	vptr->dc_type = ent->ld_type;
+	vptr->dc_time = ++Lf_data.lf_dcclock;
+	strncpy(vptr->dc_name, ent->ld_name, LF_NAME_LEN);
+	return;
+}
+
+/*------------------------------------------------------------------------
+ * lfdcinval  -  Remove a name, or all names in a directory if name is
+ *		   NULL, from the dentry cache (assumes directory mutex
+ *		   held)
+ *------------------------------------------------------------------------
+ */
+void	lfdcinval (
+	  ibid32	dir,		/* Directory holding the name	*/
+	  char		*name		/* Name to remove or NULL	*/
+	)
+{
+	struct	lfdcent	*dcptr;		/* Walks the cache		*/
+	int32	i;			/* Index into the cache		*/
+
+	for (i=0; i<LF_NDCACHE; i++) {
+		dcptr = &Lf_data.lf_dcache[i];
+		if ( (dcptr->dc_dir == dir) && ( (name == NULL) ||
+		     (strncmp(dcptr->dc_name, name, LF_NAME_LEN) == 0) ) ) {
+			dcptr->dc_dir = LF_INULL;
+		}
+	}
+	return;
+}
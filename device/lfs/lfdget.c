@@ -0,0 +1,31 @@
+/* lfdget.c - lfdget */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ * lfdget  -  Copy one slot of a directory into memory (slot 0 holds
+ *		the header; assumes directory mutex held)
+ *------------------------------------------------------------------------
+ */
+status	lfdget (
+	  ibid32	dir,		/* First i-block of directory	*/
+	  int32		slot,		/* Slot to read			*/
+	  struct ldentry *ent		/* Buffer to hold the slot	*/
+	)
+{
+	dbid32	sect;			/* Sector that holds the slot	*/
+	struct	bcbuf	*bptr;		/* Cache buffer for the sector	*/
+
+	sect = lfbmap(dir, slot * LF_DSLOT, FALSE);
+	if (sect == LF_DNULL) {
+		return SYSERR;
+	}
+	bptr = bcget(Lf_data.lf_dskdev, sect, TRUE);
+	if (bptr == (struct bcbuf *)NULL) {
+		return SYSERR;
+	}
+	memcpy((char *)ent, bptr->bc_data + (slot * LF_DSLOT) % LF_BLKSIZ,
+							LF_DSLOT);
+	bcrelse(bptr, FALSE);
+	return OK;
+}
@@ -0,0 +1,123 @@
+/* lfdgrow.c - lfdgrow */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ * lfdgrow  -  Rebuild a directory with twice as many slots (or with
+ *		 the same number if removing the marks left by deleted
+ *		 entries frees enough space), and move open files in the
+ *		 directory to the new slots of their entries (assumes
+ *		 directory mutex held)
+ *------------------------------------------------------------------------
+ */
+status	lfdgrow (
+	  ibid32	dir		/* First i-block of directory	*/
+	)
+{
+	struct	ldhdr	hdr;		/* Current header		*/
+	struct	ldhdr	*hptr;		/* Header of the new table	*/
+	struct	ldentry	*oldtab;	/* Copy of the current slots	*/
+	struct	ldentry	*newtab;	/* Slots being built		*/
+	struct	ldentry	*eptr;		/* Entry being moved		*/
+	struct	lflcblk	*lfptr;		/* Walks the open files		*/
+	uint32	oldn, newn;		/* Slots before and after	*/
+	uint32	nslots;			/* Slots available for entries	*/
+	uint32	off;			/* Byte offset in the directory	*/
+	dbid32	sect;			/* Sector of the directory	*/
+	int32	slot;			/* Slot in the new table	*/
+	uint32	i, j;			/* Indexes into the tables	*/
+	status	retval;			/* Value to return		*/
+
+	/* Choose the new size and read the entire table */
+
+	if (lfdget(dir, 0, (struct ldentry *)&hdr) == SYSERR) {
+		return SYSERR;
+	}
+	oldn = hdr.dh_nslots;
+	newn = oldn;
+	if ( (hdr.dh_nlive + 1) * 2 > oldn - 1 ) {
+		newn = oldn * 2;
+	}
+	oldtab = (struct ldentry *)getmem(oldn * LF_DSLOT);
+	if ((int32)oldtab == SYSERR) {
+		return SYSERR;
+	}
+	newtab = (struct ldentry *)getmem(newn * LF_DSLOT);
+	if ((int32)newtab == SYSERR) {
+		freemem((char *)oldtab, oldn * LF_DSLOT);
+		return SYSERR;
+	}
+	retval = OK;
+	for (off=0; off<oldn*LF_DSLOT; off+=LF_BLKSIZ) {
+		sect = lfbmap(dir, off, FALSE);
+		if ( (sect == LF_DNULL) || (bcread(Lf_data.lf_dskdev,
+				(char *)oldtab + off, sect) == SYSERR) ) {
+			retval = SYSERR;
+			break;
+		}
+	}
+
+	/* Build the new table, inserting each entry in the first free	*/
+	/*   slot of its probe sequence					*/
+
+	if (retval == OK) {
+		memset((char *)newtab, NULLCH, newn * LF_DSLOT);
+		hptr = (struct ldhdr *)newtab;
+		memcpy((char *)hptr, (char *)oldtab, LF_DSLOT);
+		hptr->dh_nslots = newn;
+		hptr->dh_nlive = hptr->dh_nused = 0;
+		nslots = newn - 1;
+		for (i=1; i<oldn; i++) {
+			eptr = &oldtab[i];
+			if ( (eptr->ld_type != LF_TFILE) &&
+			     (eptr->ld_type != LF_TDIR) ) {
+				continue;
+			}
+			for (j=0; j<nslots; j++) {
+				slot = 1 + (lfdhash(eptr->ld_name) + j) % nslots;
+				if (newtab[slot].ld_type == LF_TFREE) {
+					break;
+				}
+			}
+			memcpy((char *)&newtab[slot], (char *)eptr, LF_DSLOT);
+			hptr->dh_nlive++;
+			hptr->dh_nused++;
+		}
+
+		/* Write the new table, extending the directory as needed */
+
+		for (off=0; off<newn*LF_DSLOT; off+=LF_BLKSIZ) {
+			sect = lfbmap(dir, off, TRUE);
+			if ( (sect == LF_DNULL) || (bcwrite(Lf_data.lf_dskdev,
+					(char *)newtab + off, sect) == SYSERR) ) {
+				retval = SYSERR;
+				break;
+			}
+		}
+	}
+
+	/* Entries have moved, so forget cached slots and find the new	*/
+	/*   slot of each open file in the directory			*/
+
+	if (retval == OK) {
+		lfdcinval(dir, NULL);
+		for (i=0; i<Nlfl; i++) {
+			lfptr = &lfltab[i];
+			if ( (lfptr->lfstate != LF_USED) ||
+			     (lfptr->lfpdir != dir) || (lfptr->lfslot < 0) ) {
+				continue;
+			}
+			for (j=1; j<newn; j++) {
+				if ( (newtab[j].ld_type == LF_TFILE) &&
+				     (strncmp(newtab[j].ld_name,
+					lfptr->lfdent.ld_name, LF_NAME_LEN) == 0) ) {
+					lfptr->lfslot = j;
+					break;
+				}
+			}
+		}
+	}
+	freemem((char *)newtab, newn * LF_DSLOT);
+	freemem((char *)oldtab, oldn * LF_DSLOT);
+	return retval;
+}
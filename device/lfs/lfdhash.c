@@ -0,0 +1,21 @@
+/* lfdhash.c - lfdhash */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ * lfdhash  -  Compute the hash of a name in a directory
+ *------------------------------------------------------------------------
+ */
+uint32	lfdhash (
+	  char		*name		/* Null-terminated name		*/
+	)
+{
+	uint32	hash;			/* Hash of the name		*/
+	int32	i;			/* Index into the name		*/
+
+	hash = 0;
+	for (i=0; (i<LF_NAME_LEN) && (name[i] != NULLCH); i++) {
+		hash = (hash * 31) + (byte)name[i];
+	}
+	return hash;
+}
@@ -0,0 +1,61 @@
+/* lfdinsert.c - lfdinsert */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ * lfdinsert  -  Add an entry for a name that is not present to a
+ *		   directory, enlarging the directory first if it is three
+ *		   quarters full, and return the slot used (assumes
+ *		   directory mutex held)
+ *------------------------------------------------------------------------
+ */
+int32	lfdinsert (
+	  ibid32	dir,		/* First i-block of directory	*/
+	  struct ldentry *ent		/* Entry to add			*/
+	)
+{
+	struct	ldhdr	hdr;		/* Header of the directory	*/
+	struct	ldentry	old;		/* Current contents of a slot	*/
+	int32	slot;			/* Slot being examined		*/
+	uint32	nslots;			/* Slots available for entries	*/
+	uint32	hash;			/* Hash of the name		*/
+	uint32	i;			/* Number of slots probed	*/
+
+	if (lfdget(dir, 0, (struct ldentry *)&hdr) == SYSERR) {
+		return SYSERR;
+	}
+	if ( (hdr.dh_nused + 1) * 4 > (hdr.dh_nslots - 1) * 3 ) {
+		if (lfdgrow(dir) == SYSERR) {
+			return SYSERR;
+		}
+		lfdget(dir, 0, (struct ldentry *)&hdr);
+	}
+
+	/* Use the first slot in the probe sequence that is free or	*/
+	/*   marks a deleted entry					*/
+
+	nslots = hdr.dh_nslots - 1;
+	hash = lfdhash(ent->ld_name);
+	for (i=0; i<nslots; i++) {
+		slot = 1 + (hash + i) % nslots;
+		if (lfdget(dir, slot, &old) == SYSERR) {
+			return SYSERR;
+		}
+		if ( (old.ld_type == LF_TFREE) || (old.ld_type == LF_TDEL) ) {
+			break;
+		}
+	}
+	if (i >= nslots) {
+		return SYSERR;
+	}
+	if (lfdput(dir, slot, ent) == SYSERR) {
+		return SYSERR;
+	}
+	if (old.ld_type == LF_TFREE) {
+		hdr.dh_nused++;
+	}
+	hdr.dh_nlive++;
+	lfdput(dir, 0, (struct ldentry *)&hdr);
+	lfdcadd(dir, slot, ent);
+	return slot;
+}
@@ -0,0 +1,59 @@
+/* lfdlookup.c - lfdlookup */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ * lfdlookup  -  Find a name in a directory, copy its entry, and return
+ *		   the slot that holds it or SYSERR if the name is not
+ *		   present (assumes directory mutex held)
+ *------------------------------------------------------------------------
+ */
+int32	lfdlookup (
+	  ibid32	dir,		/* First i-block of directory	*/
+	  char		*name,		/* Name to find			*/
+	  struct ldentry *ent		/* Buffer to hold the entry	*/
+	)
+{
+	struct	ldhdr	hdr;		/* Header of the directory	*/
+	int32	slot;			/* Slot being examined		*/
+	ibid32	ilist;			/* Cached first i-block		*/
+	byte	type;			/* Cached type			*/
+	uint32	nslots;			/* Slots available for entries	*/
+	uint32	hash;			/* Hash of the name		*/
+	uint32	i;			/* Number of slots probed	*/
+
+	/* Try the dentry cache first */
+
+	slot = lfdcfind(dir, name, &ilist, &type);
+	if (slot != SYSERR) {
+		if ( (lfdget(dir, slot, ent) == OK) &&
+		     (ent->ld_type == type) &&
+		     (strncmp(ent->ld_name, name, LF_NAME_LEN) == 0) ) {
+			return slot;
+		}
+		lfdcinval(dir, name);
+	}
+
+	/* Probe the hash table, stopping at a slot that was never used	*/
+
+	if (lfdget(dir, 0, (struct ldentry *)&hdr) == SYSERR) {
+		return SYSERR;
+	}
+	nslots = hdr.dh_nslots - 1;
+	hash = lfdhash(name);
+	for (i=0; i<nslots; i++) {
+		slot = 1 + (hash + i) % nslots;
+		if (lfdget(dir, slot, ent) == SYSERR) {
+			return SYSERR;
+		}
+		if (ent->ld_type == LF_TFREE) {
+			break;
+		}
+		if ( (ent->ld_type != LF_TDEL) &&
+		     (strncmp(ent->ld_name, name, LF_NAME_LEN) == 0) ) {
+			lfdcadd(dir, slot, ent);
+			return slot;
+		}
+	}
+	return SYSERR;
+}
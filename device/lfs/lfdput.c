@@ -0,0 +1,35 @@
+/* lfdput.c - lfdput */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ * lfdput  -  Write one slot of a directory (slot 0 holds the header;
+ *		assumes directory mutex held)
+ *------------------------------------------------------------------------
+ */
+status	lfdput (
+	  ibid32	dir,		/* First i-block of directory	*/
+	  int32		slot,		/* Slot to write		*/
+	  struct ldentry *ent		/* Contents of the slot		*/
+	)
+{
+	dbid32	sect;			/* Sector that holds the slot	*/
+	struct	bcbuf	*bptr;		/* Cache buffer for the sector	*/
+
+	sect = lfbmap(dir, slot * LF_DSLOT, FALSE);
+	if (sect == LF_DNULL) {
+		return SYSERR;
+	}
+	bptr = bcget(Lf_data.lf_dskdev, sect, TRUE);
+	if (bptr == (struct bcbuf *)NULL) {
+		return SYSERR;
+	}
+
+	/* Copy the slot into place; the cache writes the sector back	*/
+	/*	to disk later						*/
+
+	memcpy(bptr->bc_data + (slot * LF_DSLOT) % LF_BLKSIZ, (char *)ent,
+							LF_DSLOT);
+	bcrelse(bptr, TRUE);
+	return OK;
+}
@@ -0,0 +1,32 @@
+/* lfdremove.c - lfdremove */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ * lfdremove  -  Remove the entry in a slot of a directory, leaving a
+ *		   mark so probes for other names continue past the slot
+ *		   (assumes directory mutex held)
+ *------------------------------------------------------------------------
+ */
+status	lfdremove (
+	  ibid32	dir,		/* First i-block of directory	*/
+	  int32		slot		/* Slot that holds the entry	*/
+	)
+{
+	struct	ldhdr	hdr;		/* Header of the directory	*/
+	struct	ldentry	ent;		/* Entry being removed		*/
+
+	if ( (lfdget(dir, 0, (struct ldentry *)&hdr) == SYSERR) ||
+	     (lfdget(dir, slot, &ent) == SYSERR) ) {
+		return SYSERR;
+	}
+	lfdcinval(dir, ent.ld_name);
+	ent.ld_type = LF_TDEL;
+	ent.ld_ilist = LF_INULL;
+	ent.ld_size = 0;
+	if (lfdput(dir, slot, &ent) == SYSERR) {
+		return SYSERR;
+	}
+	hdr.dh_nlive--;
+	return lfdput(dir, 0, (struct ldentry *)&hdr);
+}
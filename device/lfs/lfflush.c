@@ -3,8 +3,10 @@
 #include <xinu.h>
 
 /*------------------------------------------------------------------------
- * lfflush  -  Flush directory, data block, and index block for an open
- *			file (assumes file mutex is held)
+ * lfflush  -  Flush directory, directory entry, data block, and index
+ *			block for an open file, and the changed i-blocks
+ *			in the i-block cache (assumes file mutex and
+ *			directory mutex are held)
  *------------------------------------------------------------------------
  */
 status	lfflush (
@@ -19,15 +21,22 @@ status	lfflush (
 	/* Write the directory if it has changed */
 
 	if (Lf_data.lf_dirdirty) {
-		write(Lf_data.lf_dskdev, (char *)&Lf_data.lf_dir,
+		bcwrite(Lf_data.lf_dskdev, (char *)&Lf_data.lf_dir,
 							LF_AREA_DIR);
 		Lf_data.lf_dirdirty = FALSE;
 	}
 
+	/* Write the file's entry into its directory if it has changed	*/
+
+	if (lfptr->lfdedirty) {
+		lfdput(lfptr->lfpdir, lfptr->lfslot, &lfptr->lfdent);
+		lfptr->lfdedirty = FALSE;
+	}
+
 	/* Write data block if it has changed */
 
 	if (lfptr->lfdbdirty) {
-		write(Lf_data.lf_dskdev, lfptr->lfdblock, lfptr->lfdnum);
+		bcwrite(Lf_data.lf_dskdev, lfptr->lfdblock, lfptr->lfdnum);
 		lfptr->lfdbdirty = FALSE;
 	}
 
@@ -37,6 +46,13 @@ status	lfflush (
 		lfibput(Lf_data.lf_dskdev, lfptr->lfinum, &lfptr->lfiblock);
 		lfptr->lfibdirty = FALSE;
 	}
+
+	/* Move changed cached i-blocks into the buffer cache, so they	*/
+	/*   are written back with the data blocks they describe	*/
+
+	if (Lf_data.lf_icndirty > 0) {
+		lfibsync();
+	}
 	
 	return OK;
 }
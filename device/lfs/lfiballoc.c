@@ -26,7 +26,7 @@ ibid32	lfiballoc (void)
 
 	/* Write a copy of the directory to disk after the change */
 
-	write(Lf_data.lf_dskdev, (char *) &Lf_data.lf_dir, LF_AREA_DIR);
+	bcwrite(Lf_data.lf_dskdev, (char *) &Lf_data.lf_dir, LF_AREA_DIR);
 	Lf_data.lf_dirdirty = FALSE;
 
 	return ibnum;
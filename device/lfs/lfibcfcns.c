@@ -0,0 +1,124 @@
+/* lfibcfcns.c - lfibcfind, lfibcnew, lfibcwback, lfibsync */
+
+#include <xinu.h>
+
+/* First entry of the set of cache entries an i-block can occupy */
+
+#define	lfibcset(ib) \
+	(&Lf_data.lf_ibcache[((ib) % (LF_NIBCACHE / LF_IBCWAYS)) * \
+							LF_IBCWAYS])
+
+/*------------------------------------------------------------------------
+ * lfibcfind  -  Look up an i-block in the i-block cache and return a
+ *		   pointer to its entry, or NULL if the i-block is not
+ *		   cached (assumes directory mutex held)
+ *------------------------------------------------------------------------
+ */
+struct	lfibcent *lfibcfind (
+	  ibid32	inum		/* ID of index block to find	*/
+	)
+{
+	struct	lfibcent *icptr;	/* Walks the set of entries	*/
+	int32	i;			/* Index into the set		*/
+
+	icptr = lfibcset(inum);
+	for (i=0; i<LF_IBCWAYS; i++, icptr++) {
+		if (icptr->ic_inum == inum) {
+			icptr->ic_time = ++Lf_data.lf_icclock;
+			return icptr;
+		}
+	}
+	return (struct lfibcent *)NULL;
+}
+
+/*------------------------------------------------------------------------
+ * lfibcnew  -  Obtain a cache entry for an i-block that is not cached,
+ *		  replacing the least-recently used entry of the set and
+ *		  writing back its sector first if it has changed
+ *		  (assumes directory mutex held)
+ *------------------------------------------------------------------------
+ */
+struct	lfibcent *lfibcnew (
+	  ibid32	inum		/* ID of index block to cache	*/
+	)
+{
+	struct	lfibcent *icptr;	/* Walks the set of entries	*/
+	struct	lfibcent *vptr;		/* Entry to replace		*/
+	int32	i;			/* Index into the set		*/
+
+	icptr = lfibcset(inum);
+	vptr = icptr;
+	for (i=0; i<LF_IBCWAYS; i++, icptr++) {
+		if (icptr->ic_inum == LF_INULL) {
+			vptr = icptr;
+			break;
+		}
+		if (icptr->ic_time < vptr->ic_time) {
+			vptr = icptr;
+		}
+	}
+	if (vptr->ic_dirty) {
+		if (lfibcwback(ib2sect(vptr->ic_inum)) == SYSERR) {
+			return (struct lfibcent *)NULL;
+		}
+	}
+	vptr->ic_inum = inum;
+	vptr->ic_dirty = FALSE;
+	vptr->ic_time = ++Lf_data.lf_icclock;
+	return vptr;
+}
+
+/*------------------------------------------------------------------------
+ * lfibcwback  -  Copy every changed cached i-block that lies in a given
+ *		    sector into the buffer cache with one access to the
+ *		    sector (assumes directory mutex held)
+ *------------------------------------------------------------------------
+ */
+status	lfibcwback (
+	  uint32	sect		/* Sector of i-blocks to write	*/
+	)
+{
+	struct	bcbuf	*bptr;		/* Cache buffer for the sector	*/
+	struct	lfibcent *icptr;	/* Walks the i-block cache	*/
+	int32	i;			/* Index into the i-block cache	*/
+
+	bptr = bcget(Lf_data.lf_dskdev, sect, TRUE);
+	if (bptr == (struct bcbuf *)NULL) {
+		return SYSERR;
+	}
+	for (i=0; i<LF_NIBCACHE; i++) {
+		icptr = &Lf_data.lf_ibcache[i];
+		if ( icptr->ic_dirty && (ib2sect(icptr->ic_inum) == sect) ) {
+			memcpy(bptr->bc_data + ib2disp(icptr->ic_inum),
+				(char *)&icptr->ic_iblk,
+				sizeof(struct lfiblk));
+			icptr->ic_dirty = FALSE;
+			Lf_data.lf_icndirty--;
+		}
+	}
+	bcrelse(bptr, TRUE);
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ * lfibsync  -  Write back all changed i-blocks in the i-block cache,
+ *		  grouped by sector (assumes directory mutex held)
+ *------------------------------------------------------------------------
+ */
+status	lfibsync(void)
+{
+	struct	lfibcent *icptr;	/* Walks the i-block cache	*/
+	status	retval;			/* Value to return		*/
+	int32	i;			/* Index into the i-block cache	*/
+
+	retval = OK;
+	for (i=0; (i<LF_NIBCACHE) && (Lf_data.lf_icndirty > 0); i++) {
+		icptr = &Lf_data.lf_ibcache[i];
+		if (icptr->ic_dirty) {
+			if (lfibcwback(ib2sect(icptr->ic_inum)) == SYSERR) {
+				retval = SYSERR;
+			}
+		}
+	}
+	return retval;
+}
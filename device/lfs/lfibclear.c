@@ -8,14 +8,16 @@
  */
 void	lfibclear(
 	  struct lfiblk	*ibptr,		/* Address of i-block in memory	*/
-	  int32		offset		/* File offset for this i-block	*/
+	  int32		offset		/* First d-block of the file	*/
+					/*   for this i-block		*/
 	)
 {
-	int32	i;			/* Index for data block array 	*/
+	int32	i;			/* Index for extent array	*/
 
-	ibptr->ib_offset = offset;	/* Assign specified file offset	*/
-	for (i=0 ; i<LF_IBLEN ; i++) {	/* Clear each data block pointer*/
-		ibptr->ib_dba[i] = LF_DNULL;
+	ibptr->ib_offset = offset;	/* Assign specified offset	*/
+	for (i=0 ; i<LF_NEXTENT ; i++) {/* Clear each extent		*/
+		ibptr->ib_ext[i].ex_start = LF_DNULL;
+		ibptr->ib_ext[i].ex_len = 0;
 	}
 	ibptr->ib_next = LF_INULL;	/* Set next ptr to null		*/
 	return;
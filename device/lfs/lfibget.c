@@ -13,19 +13,42 @@ void	lfibget(
 	  struct lfiblk	*ibuff		/* Buffer to hold index block	*/
 	)	
 {
-	char	*from, *to;		/* Pointers used in copying	*/
-	int32	i;			/* Loop index used during copy	*/
-	char	dbuff[LF_BLKSIZ];	/* Buffer to hold disk block	*/
+	struct	bcbuf	*bptr;		/* Cache buffer for the sector	*/
+	struct	lfibcent *icptr;	/* Entry in the i-block cache	*/
 
-	/* Read disk block that contains the specified index block */
+	/* Use the copy in the i-block cache if there is one */
 
-	read(diskdev, dbuff, ib2sect(inum));
+	icptr = (struct lfibcent *)NULL;
+	if (lfibcached(diskdev)) {
+		icptr = lfibcfind(inum);
+		if (icptr != (struct lfibcent *)NULL) {
+			memcpy((char *)ibuff, (char *)&icptr->ic_iblk,
+						sizeof(struct lfiblk));
+			return;
+		}
+		icptr = lfibcnew(inum);
+	}
 
-	/* Copy specified index block to caller's ibuff */
+	/* Obtain the disk block that contains the specified index	*/
+	/*	block from the buffer cache				*/
 
-	from = dbuff + ib2disp(inum);
-	to = (char *)ibuff;
-	for (i=0 ; i<sizeof(struct lfiblk) ; i++)
-		*to++ = *from++;
+	bptr = bcget(diskdev, ib2sect(inum), TRUE);
+	if (bptr == (struct bcbuf *)NULL) {
+		if (icptr != (struct lfibcent *)NULL) {
+			icptr->ic_inum = LF_INULL;
+		}
+		return;
+	}
+
+	/* Copy specified index block to caller's ibuff and keep a	*/
+	/*	copy in the i-block cache				*/
+
+	memcpy((char *)ibuff, bptr->bc_data + ib2disp(inum),
+						sizeof(struct lfiblk));
+	bcrelse(bptr, FALSE);
+	if (icptr != (struct lfibcent *)NULL) {
+		memcpy((char *)&icptr->ic_iblk, (char *)ibuff,
+						sizeof(struct lfiblk));
+	}
 	return;
 }
@@ -13,31 +13,43 @@ status	lfibput(
 	  struct lfiblk	*ibuff		/* Buffer holding the index blk	*/
 	)
 {
-	dbid32	diskblock;		/* ID of disk sector (block)	*/
-	char	*from, *to;		/* Pointers used in copying	*/
-	int32	i;			/* Loop index used during copy	*/
-	char	dbuff[LF_BLKSIZ];	/* Temp. buffer to hold d-block	*/
-
-	/* Compute disk block number and offset of index block */
-
-	diskblock = ib2sect(inum);
-	to = dbuff + ib2disp(inum);
-	from = (char *)ibuff;
-
-	/* Read disk block */
-
-	if (read(diskdev, dbuff, diskblock) == SYSERR) {
-		return SYSERR;
+	struct	bcbuf	*bptr;		/* Cache buffer for the sector	*/
+	struct	lfibcent *icptr;	/* Entry in the i-block cache	*/
+
+	/* Once a file system is mounted, record the change in the	*/
+	/*   i-block cache; the sector is updated when the entry is	*/
+	/*   replaced or the cache is synchronized			*/
+
+	if (lfibcached(diskdev)) {
+		icptr = lfibcfind(inum);
+		if (icptr == (struct lfibcent *)NULL) {
+			icptr = lfibcnew(inum);
+			if (icptr == (struct lfibcent *)NULL) {
+				return SYSERR;
+			}
+		}
+		memcpy((char *)&icptr->ic_iblk, (char *)ibuff,
+						sizeof(struct lfiblk));
+		if (! icptr->ic_dirty) {
+			icptr->ic_dirty = TRUE;
+			Lf_data.lf_icndirty++;
+		}
+		return OK;
 	}
 
-	/* Copy index block into place */
+	/* Obtain the disk block that holds the index block from the	*/
+	/*	buffer cache (read from disk only on a miss)		*/
 
-	for (i=0 ; i<sizeof(struct lfiblk) ; i++) {
-		*to++ = *from++;
+	bptr = bcget(diskdev, ib2sect(inum), TRUE);
+	if (bptr == (struct bcbuf *)NULL) {
+		return SYSERR;
 	}
 
-	/* Write the block back to disk */
+	/* Copy index block into place; the cache writes the block	*/
+	/*	back to disk later					*/
 
-	write(diskdev, dbuff, diskblock);
+	memcpy(bptr->bc_data + ib2disp(inum), (char *)ibuff,
+						sizeof(struct lfiblk));
+	bcrelse(bptr, TRUE);
 	return OK;
 }
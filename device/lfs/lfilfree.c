@@ -0,0 +1,81 @@
+/* lfilfree.c - lfilfree */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ * lfilfree  -  Free the data blocks of a file and move its list of
+ *		  index blocks to the free list (assumes directory mutex
+ *		  held)
+ *------------------------------------------------------------------------
+ */
+status	lfilfree (
+	  ibid32	firstib		/* First i-block of the file	*/
+	)
+{
+	struct	lfiblk	iblock;		/* Buffer for one index block	*/
+	ibid32	ifree;			/* Start of index blk free list	*/
+	ibid32	nextib;			/* Walks down list of the	*/
+					/*   file's index blocks	*/
+	struct	lfext	*xptr;		/* Ptr to an extent to free	*/
+	uint32	j;			/* Index of d-block in extent	*/
+	int32	i;			/* Moves through extents in a	*/
+					/*   given index block		*/
+
+	if (firstib == LF_INULL) {
+		return OK;
+	}
+
+	/* Obtain ID of first index block on free list */
+
+	ifree = Lf_data.lf_dir.lfd_ifree;
+
+	/* Walk along index block list, disposing of the data blocks in	*/
+	/*   each extent and clearing the extent.  A note on loop	*/
+	/*   termination: last pointer is set to ifree below.		*/
+
+	for (nextib=firstib; nextib!=ifree; nextib=iblock.ib_next) {
+
+		/* Obtain a copy of current index block from disk	*/
+
+		lfibget(Lf_data.lf_dskdev, nextib, &iblock);
+
+		/* Free the data blocks in each extent			*/
+
+		for (i=0; i<LF_NEXTENT; i++) {	/* For each extent	*/
+			xptr = &iblock.ib_ext[i];
+			for (j=0; j<xptr->ex_len; j++) {
+				lfdbfree(Lf_data.lf_dskdev,
+					xptr->ex_start + j * Lf_data.lf_spb);
+			}
+
+			/* Clear the extent in the i-block		*/
+
+			xptr->ex_start = LF_DNULL;
+			xptr->ex_len = 0;
+		}
+
+		/* Clear offset (just to make debugging easier)		*/
+
+		iblock.ib_offset = 0;
+
+		/* For the last index block on the list, make it point	*/
+		/*	to the current free list			*/
+
+		if (iblock.ib_next == LF_INULL) {
+			iblock.ib_next = ifree;
+		}
+
+		/* Write cleared i-block back to disk */
+
+		lfibput(Lf_data.lf_dskdev, nextib, &iblock);
+	}
+
+	/* Last index block on the file list now points to first node	*/
+	/*   on the current free list.  Once we make the free list	*/
+	/*   point to the first index block on the file list, the	*/
+	/*   entire set of index blocks will be on the free list	*/
+
+	Lf_data.lf_dir.lfd_ifree = firstib;
+	Lf_data.lf_dirdirty = TRUE;
+	return OK;
+}
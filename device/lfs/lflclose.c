@@ -24,11 +24,17 @@ devcall	lflclose (
 		return SYSERR;
 	}
 
-	/* Write index or data blocks to disk if they have changed */
+	/* Write the entry, index or data blocks, and changes to the	*/
+	/*   cached i-blocks and the d-block bitmap to disk		*/
 
-	if (Lf_data.lf_dirdirty || lfptr->lfdbdirty || lfptr->lfibdirty) {
+	wait(Lf_data.lf_mutex);
+	if (Lf_data.lf_dirdirty || lfptr->lfdedirty || lfptr->lfdbdirty ||
+	    lfptr->lfibdirty) {
 		lfflush(lfptr);
 	}
+	lfibsync();
+	lfbmflush();
+	signal(Lf_data.lf_mutex);
 
 	/* Set device state to FREE and return to caller */
 
@@ -13,7 +13,6 @@ devcall	lflinit (
 	)
 {
 	struct	lflcblk	*lfptr;		/* Ptr. to control block entry	*/
-	int32	i;			/* Walks through name array	*/
 
 	lfptr = &lfltab[ devptr->dvminor ];
 
@@ -26,15 +25,17 @@ devcall	lflinit (
 	/* Initialize the directory and file position */
 
 	lfptr->lfdirptr = (struct  ldentry *) NULL;
+	memset((char *) &lfptr->lfdent, NULLCH, sizeof(struct ldentry));
+	lfptr->lfpdir = LF_INULL;
+	lfptr->lfslot = -1;
+	lfptr->lfdedirty = FALSE;
 	lfptr->lfpos = 0;
-	for (i=0; i<LF_NAME_LEN; i++) {
-		lfptr->lfname[i] = NULLCH;
-	}
 
 	/* Zero the in-memory index block and data block */
 
 	lfptr->lfinum = LF_INULL;
 	memset((char *) &lfptr->lfiblock, NULLCH, sizeof(struct lfiblk));
+	lfptr->lfnibmap = 0;
 	lfptr->lfdnum = 0;
 	memset((char *) &lfptr->lfdblock, NULLCH, LF_BLKSIZ);
 
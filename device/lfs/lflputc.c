@@ -50,7 +50,7 @@ devcall	lflputc (
 
 	if (lfptr->lfpos >= ldptr->ld_size) {
 		ldptr->ld_size++;
-		Lf_data.lf_dirdirty = TRUE;
+		lfptr->lfdedirty = TRUE;
 	}
 
 	/* Place byte in buffer and mark buffer "dirty" */
@@ -12,28 +12,12 @@ devcall	lflread (
 	  int32	count			/* Max bytes to read		*/
 	)
 {
-	uint32	numread;		/* Number of bytes read		*/
-	int32	nxtbyte;		/* Character or SYSERR/EOF	*/
+	struct	iovec	iov;		/* The buffer as a vector	*/
 
 	if (count < 0) {
 		return SYSERR;
 	}
-
-	/* Iterate and use lflgetc to read individual bytes */
-
-	for (numread=0 ; numread < count ; numread++) {
-		nxtbyte = lflgetc(devptr);
-		if (nxtbyte == SYSERR) {
-			return SYSERR;
-		} else if (nxtbyte == EOF) {	/* EOF before finished */
-		    if (numread == 0) {
-			return EOF;
-		    } else {
-			return numread;
-		    }
-		} else {
-			*buff++ = (char) (0xff & nxtbyte);
-		}
-	}
-	return numread;
+	iov.iov_base = buff;
+	iov.iov_len = count;
+	return lflreadv(devptr, &iov, 1);
 }
@@ -0,0 +1,84 @@
+/* lflreadv.c - lflreadv */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ * lflreadv  -  Read from a previously opened local file into a vector
+ *		  of buffers, holding the file for the entire transfer
+ *------------------------------------------------------------------------
+ */
+devcall	lflreadv (
+	  struct dentry *devptr,	/* Entry in device switch table */
+	  struct iovec	*iov,		/* Buffers to fill in order	*/
+	  int32		iovcnt		/* Number of buffers		*/
+	)
+{
+	struct	lflcblk	*lfptr;		/* Ptr to open file table entry	*/
+	struct	ldentry	*ldptr;		/* Ptr to file's entry in the	*/
+					/*   in-memory directory	*/
+	char	*buff;			/* Next byte of a buffer	*/
+	uint32	count;			/* Bytes requested in total	*/
+	uint32	numread;		/* Number of bytes read		*/
+	uint32	left;			/* Bytes left in a buffer	*/
+	uint32	span;			/* Bytes to copy from the block	*/
+	int32	i;			/* Index into the vector	*/
+
+	count = 0;
+	for (i=0; i<iovcnt; i++) {
+		count += iov[i].iov_len;
+	}
+
+	/* Obtain exclusive use of the file */
+
+	lfptr = &lfltab[devptr->dvminor];
+	wait(lfptr->lfmutex);
+
+	/* If file is not open, return an error */
+
+	if (lfptr->lfstate != LF_USED) {
+		signal(lfptr->lfmutex);
+		return SYSERR;
+	}
+
+	/* Return EOF for any attempt to read beyond the end-of-file */
+
+	ldptr = lfptr->lfdirptr;
+	if ( (count > 0) && (lfptr->lfpos >= ldptr->ld_size) ) {
+		signal(lfptr->lfmutex);
+		return EOF;
+	}
+
+	/* Copy the span of bytes in each data block, setting up a new	*/
+	/*	data block only when the byte pointer passes the end of	*/
+	/*	the current one, and moving to the next buffer when one	*/
+	/*	is full; if no block can be set up, report the bytes	*/
+	/*	already read						*/
+
+	numread = 0;
+	for (i=0; (i<iovcnt) && (lfptr->lfpos < ldptr->ld_size); i++) {
+		buff = iov[i].iov_base;
+		left = iov[i].iov_len;
+		while ( (left > 0) && (lfptr->lfpos < ldptr->ld_size) ) {
+			if ( (lfptr->lfbyte >= &lfptr->lfdblock[LF_BLKSIZ])
+			     && (lfsetup(lfptr) == SYSERR) ) {
+				signal(lfptr->lfmutex);
+				return (numread > 0) ? numread : SYSERR;
+			}
+			span = &lfptr->lfdblock[LF_BLKSIZ] - lfptr->lfbyte;
+			if (span > left) {
+				span = left;
+			}
+			if (span > ldptr->ld_size - lfptr->lfpos) {
+				span = ldptr->ld_size - lfptr->lfpos;
+			}
+			memcpy(buff, lfptr->lfbyte, span);
+			buff += span;
+			left -= span;
+			lfptr->lfbyte += span;
+			lfptr->lfpos += span;
+			numread += span;
+		}
+	}
+	signal(lfptr->lfmutex);
+	return numread;
+}
@@ -12,18 +12,12 @@ devcall	lflwrite (
 	  int32	count			/* Number of bytes to write	*/
 	)
 {
-	int32		i;		/* Number of bytes written	*/
+	struct	iovec	iov;		/* The buffer as a vector	*/
 
 	if (count < 0) {
 		return SYSERR;
 	}
-
-	/* Iteratate and write one byte at a time */
-
-	for (i=0; i<count; i++) {
-		if (lflputc(devptr, *buff++) == SYSERR) {
-			return SYSERR;
-		}
-	}
-	return count;
+	iov.iov_base = buff;
+	iov.iov_len = count;
+	return lflwritev(devptr, &iov, 1);
 }
@@ -0,0 +1,83 @@
+/* lflwritev.c - lflwritev */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ * lflwritev  --  Write a vector of buffers to a previously opened local
+ *		    disk file, holding the file for the entire transfer
+ *------------------------------------------------------------------------
+ */
+devcall	lflwritev (
+	  struct dentry *devptr,	/* Entry in device switch table */
+	  struct iovec	*iov,		/* Buffers to write in order	*/
+	  int32		iovcnt		/* Number of buffers		*/
+	)
+{
+	struct	lflcblk	*lfptr;		/* Ptr to open file table entry	*/
+	struct	ldentry	*ldptr;		/* Ptr to file's entry in the	*/
+					/*  in-memory directory		*/
+	char	*buff;			/* Next byte of a buffer	*/
+	uint32	numwritten;		/* Number of bytes written	*/
+	uint32	left;			/* Bytes left in a buffer	*/
+	uint32	span;			/* Bytes to copy into the block	*/
+	int32	i;			/* Index into the vector	*/
+
+	/* Obtain exclusive use of the file */
+
+	lfptr = &lfltab[devptr->dvminor];
+	wait(lfptr->lfmutex);
+
+	/* If file is not open, return an error */
+
+	if (lfptr->lfstate != LF_USED) {
+		signal(lfptr->lfmutex);
+		return SYSERR;
+	}
+
+	/* Return SYSERR for an attempt to skip bytes beyond the byte	*/
+	/* 	that is currently the end of the file		 	*/
+
+	ldptr = lfptr->lfdirptr;
+	if (lfptr->lfpos > ldptr->ld_size) {
+		signal(lfptr->lfmutex);
+		return SYSERR;
+	}
+
+	/* Copy a span of bytes into each data block, setting up a new	*/
+	/*	data block only when the byte pointer passes the end of	*/
+	/*	the current one; if no block can be set up, report the	*/
+	/*	bytes already written					*/
+
+	numwritten = 0;
+	for (i=0; i<iovcnt; i++) {
+		buff = iov[i].iov_base;
+		left = iov[i].iov_len;
+		while (left > 0) {
+			if ( (lfptr->lfbyte >= &lfptr->lfdblock[LF_BLKSIZ])
+			     && (lfsetup(lfptr) == SYSERR) ) {
+				signal(lfptr->lfmutex);
+				return (numwritten > 0) ? numwritten : SYSERR;
+			}
+			span = &lfptr->lfdblock[LF_BLKSIZ] - lfptr->lfbyte;
+			if (span > left) {
+				span = left;
+			}
+			memcpy(lfptr->lfbyte, buff, span);
+			buff += span;
+			left -= span;
+			lfptr->lfbyte += span;
+			lfptr->lfpos += span;
+			numwritten += span;
+			lfptr->lfdbdirty = TRUE;
+
+			/* If appending to the file, increase the size	*/
+
+			if (lfptr->lfpos > ldptr->ld_size) {
+				ldptr->ld_size = lfptr->lfpos;
+				lfptr->lfdedirty = TRUE;
+			}
+		}
+	}
+	signal(lfptr->lfmutex);
+	return numwritten;
+}
@@ -0,0 +1,81 @@
+/* lfpath.c - lfpath */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ * lfpath  -  Resolve all but the last component of a path name to a
+ *		directory and copy the last component, ignoring trailing
+ *		slashes (so "a/b/" yields directory a and last component
+ *		"b"); when the path ends in "." or ".." or is empty, return
+ *		the directory it names and an empty last component
+ *		(assumes directory mutex held)
+ *------------------------------------------------------------------------
+ */
+status	lfpath (
+	  char		*path,		/* Path name relative to root	*/
+	  ibid32	*dir,		/* Where to store the directory	*/
+	  char		*last		/* Buffer of LF_NAME_LEN chars	*/
+					/*   for the last component	*/
+	)
+{
+	ibid32	cur;			/* Directory reached so far	*/
+	ibid32	ilist;			/* Cached first i-block		*/
+	byte	type;			/* Cached type			*/
+	struct	ldentry	ent;		/* Entry for a component	*/
+	struct	ldhdr	hdr;		/* Header of a directory	*/
+	char	comp[LF_NAME_LEN];	/* One component of the path	*/
+	int32	len;			/* Length of the component	*/
+
+	cur = Lf_data.lf_dir.lfd_root;
+	while (TRUE) {
+
+		/* Extract the next component */
+
+		while (*path == '/') {
+			path++;
+		}
+		for (len=0; (*path != NULLCH) && (*path != '/'); len++) {
+			if (len >= LF_NAME_LEN - 1) {
+				return SYSERR;	/* Component is too long */
+			}
+			comp[len] = *path++;
+		}
+		comp[len] = NULLCH;
+
+		/* Stop at the last component unless it is "." or ".."	*/
+
+		while (*path == '/') {
+			path++;
+		}
+		if ( (*path == NULLCH) && (strncmp(comp, ".", 2) != 0) &&
+		     (strncmp(comp, "..", 3) != 0) ) {
+			strncpy(last, comp, LF_NAME_LEN);
+			*dir = cur;
+			return OK;
+		}
+
+		/* Move to the directory named by the component */
+
+		if (strncmp(comp, "..", 3) == 0) {
+			if (lfdget(cur, 0, (struct ldentry *)&hdr) == SYSERR) {
+				return SYSERR;
+			}
+			cur = hdr.dh_parent;
+		} else if (strncmp(comp, ".", 2) != 0) {
+			if ( (lfdcfind(cur, comp, &ilist, &type) != SYSERR) &&
+			     (type == LF_TDIR) ) {
+				cur = ilist;
+			} else if ( (lfdlookup(cur, comp, &ent) != SYSERR) &&
+				    (ent.ld_type == LF_TDIR) ) {
+				cur = ent.ld_ilist;
+			} else {
+				return SYSERR;
+			}
+		}
+		if (*path == NULLCH) {
+			last[0] = NULLCH;
+			*dir = cur;
+			return OK;
+		}
+	}
+}
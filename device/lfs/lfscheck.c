@@ -16,6 +16,7 @@ status	lfscheck (
 	/* Verify the File System ID, all 0's and all 1's fields */
 
 	if ( (dirptr->lfd_fsysid != LFS_ID)       ||
+	     (dirptr->lfd_vers != LF_VERSION)     ||
 	     (dirptr->lfd_allzeros != 0x00000000) ||
 	     (dirptr->lfd_allones  != 0xffffffff) ) {
 		return SYSERR;
@@ -32,9 +33,17 @@ status	lfscheck (
 		return SYSERR;
 	}
 
-	/* Extra sanity check - verify file count is non-negative */
+	/* Extra sanity check - verify the root directory exists */
 
-	if (dirptr->lfd_nfiles < 0){
+	if (dirptr->lfd_root == LF_INULL) {
+		return SYSERR;
+	}
+
+	/* Verify the d-block size is a multiple of the sector size	*/
+
+	if ( (dirptr->lfd_blksiz < LF_BLKSIZ) ||
+	     (dirptr->lfd_blksiz > LF_MAXBSIZ) ||
+	     ((dirptr->lfd_blksiz % LF_BLKSIZ) != 0) ) {
 		return SYSERR;
 	}
 	return OK;
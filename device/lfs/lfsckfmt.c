@@ -15,15 +15,15 @@ status	lfsckfmt (
 	struct	lfdir	dir;		/* Buffer to hold the directory	*/
 	uint32	dblks;			/* Total free data blocks	*/
 	struct	lfiblk	iblock;		/* Space for one i-block	*/
-	struct	lfdbfree dblock;	/* Data block on the free list	*/
+	byte	bmblock[LF_BLKSIZ];	/* One sector of the bitmap	*/
 	int32	lfiblks;		/* Total free index blocks	*/
 	int32	retval;
 	ibid32	nextib;
-	dbid32	nextdb;
+	uint32	idx;			/* Index of d-block in bitmap	*/
 
 	/* Read directory */
 
-	retval = read(disk,(char *)&dir, LF_AREA_DIR);
+	retval = bcread(disk,(char *)&dir, LF_AREA_DIR);
 	if (retval == SYSERR) {
 		panic("cannot read directory");
 	}
@@ -50,16 +50,21 @@ status	lfsckfmt (
 	ibsectors = (lfiblks + 6) /7;
 	kprintf("Found %d index blocks (%d sectors)\n", lfiblks, ibsectors);
 
-	/* Follow data block list */
+	/* Count the free data blocks in the bitmap */
 
 	dblks = 0;
-	nextdb = dir.lfd_dfree;
-	kprintf("initial data block is %d\n", nextdb);
-	while (nextdb != LF_DNULL) {
-		dblks++;
-		read(disk, (char *)&dblock, nextdb);
-		nextdb = dblock.lf_nextdb;
+	kprintf("initial data block is %d\n", dir.lfd_dstart);
+	for (idx=0; idx<dir.lfd_ndblks; idx++) {
+		if ((idx % LF_BMBITS) == 0) {
+			bcread(disk, (char *)bmblock,
+					dir.lfd_bmsect + idx / LF_BMBITS);
+		}
+		if ( (bmblock[(idx % LF_BMBITS) >> 3] & (1 << (idx & 0x7)))
+								== 0) {
+			dblks++;
+		}
 	}
-	kprintf("Found %d data blocks\n", dblks);
+	kprintf("Found %d free data blocks of %d (%d bytes each)\n",
+		dblks, dir.lfd_ndblks, dir.lfd_blksiz);
 	return OK;
 }
@@ -0,0 +1,171 @@
+/* lfscontrol.c - lfscontrol, lfsbusy */
+
+#include <xinu.h>
+
+local	bool8	lfsbusy(ibid32, int32, ibid32);
+
+/*------------------------------------------------------------------------
+ * lfscontrol  -  Provide control functions for the local file system
+ *		    (arg1 is the path name of a file or directory)
+ *------------------------------------------------------------------------
+ */
+devcall	lfscontrol (
+	 struct dentry	*devptr,	/* Entry in device switch table	*/
+	 int32	func,			/* A control function		*/
+	 int32	arg1,			/* Argument #1			*/
+	 int32	arg2			/* Argument #2			*/
+	)
+{
+	ibid32	dir;			/* Directory holding the name	*/
+	char	last[LF_NAME_LEN];	/* Last component of the path	*/
+	struct	ldentry	ent;		/* Entry for the name		*/
+	struct	ldhdr	hdr;		/* Header of a directory	*/
+	struct	lflcblk	*lfptr;		/* Ptr to open file table entry	*/
+	int32	slot;			/* Slot of the entry		*/
+	ibid32	ibnum;			/* I-block of a new directory	*/
+	struct	lfiblk	iblock;		/* I-block of a new directory	*/
+	dbid32	dnum;			/* D-block of a new directory	*/
+	char	sector[LF_BLKSIZ];	/* First sector of a new dir.	*/
+	int32	retval;			/* Return value			*/
+	int32	i;			/* Walks the open files		*/
+
+	wait(Lf_data.lf_mutex);
+	if ( (lfsmount() == SYSERR) ||
+	     (lfpath((char *)arg1, &dir, last) == SYSERR) ||
+	     (last[0] == NULLCH) ) {
+		signal(Lf_data.lf_mutex);
+		return SYSERR;
+	}
+	slot = lfdlookup(dir, last, &ent);
+	retval = OK;
+
+	switch (func) {
+
+	/* Delete a file that is not open */
+
+	case LF_CTL_DEL:
+		if ( (slot == SYSERR) || (ent.ld_type != LF_TFILE) ||
+		     lfsbusy(dir, slot, LF_INULL) ) {
+			retval = SYSERR;
+			break;
+		}
+		lfilfree(ent.ld_ilist);
+		retval = lfdremove(dir, slot);
+		break;
+
+	/* Make an empty directory with one d-block */
+
+	case LF_CTL_MKDIR:
+		if (slot != SYSERR) {
+			retval = SYSERR;
+			break;
+		}
+		ibnum = lfiballoc();
+		dnum = lfdballoc(LF_DNULL);
+		lfibclear(&iblock, 0);
+		iblock.ib_ext[0].ex_start = dnum;
+		iblock.ib_ext[0].ex_len = 1;
+		lfibput(Lf_data.lf_dskdev, ibnum, &iblock);
+		memset(sector, NULLCH, LF_BLKSIZ);
+		((struct ldhdr *)sector)->dh_nslots = LF_DMINSLOTS;
+		((struct ldhdr *)sector)->dh_parent = dir;
+		bcwrite(Lf_data.lf_dskdev, sector, dnum);
+
+		memset((char *)&ent, NULLCH, sizeof(ent));
+		ent.ld_ilist = ibnum;
+		ent.ld_type = LF_TDIR;
+		strncpy(ent.ld_name, last, LF_NAME_LEN);
+		if (lfdinsert(dir, &ent) == SYSERR) {
+			lfilfree(ibnum);
+			retval = SYSERR;
+		}
+		break;
+
+	/* Remove an empty directory that is not open */
+
+	case LF_CTL_RMDIR:
+		if ( (slot == SYSERR) || (ent.ld_type != LF_TDIR) ||
+		     lfsbusy(LF_INULL, -1, ent.ld_ilist) ||
+		     (lfdget(ent.ld_ilist, 0, (struct ldentry *)&hdr)
+							== SYSERR) ||
+		     (hdr.dh_nlive != 0) ) {
+			retval = SYSERR;
+			break;
+		}
+		lfdcinval(ent.ld_ilist, NULL);
+		lfilfree(ent.ld_ilist);
+		retval = lfdremove(dir, slot);
+		break;
+
+	/* Obtain the size of a file (the open copy of the entry is	*/
+	/*   the current one)						*/
+
+	case LF_CTL_SIZE:
+		if (slot == SYSERR) {
+			retval = SYSERR;
+			break;
+		}
+		retval = ent.ld_size;
+		for (i=0; i<Nlfl; i++) {
+			lfptr = &lfltab[i];
+			if ( (lfptr->lfstate == LF_USED) &&
+			     (lfptr->lfpdir == dir) && (lfptr->lfslot == slot) ) {
+				retval = lfptr->lfdent.ld_size;
+			}
+		}
+		break;
+
+	default:
+		kprintf("lfscontrol: function %d not valid\n", func);
+		retval = SYSERR;
+		break;
+	}
+
+	/* Write the directory sector, i-blocks, and bitmap if they	*/
+	/*   have changed						*/
+
+	if (Lf_data.lf_dirdirty) {
+		bcwrite(Lf_data.lf_dskdev, (char *)&Lf_data.lf_dir,
+							LF_AREA_DIR);
+		Lf_data.lf_dirdirty = FALSE;
+	}
+	lfibsync();
+	lfbmflush();
+	signal(Lf_data.lf_mutex);
+	return retval;
+}
+
+/*------------------------------------------------------------------------
+ * lfsbusy  -  Determine whether a file (given by the slot of its entry)
+ *		 or a directory (given by its first i-block) is open or,
+ *		 for a directory, is the root (assumes directory mutex held)
+ *------------------------------------------------------------------------
+ */
+local	bool8	lfsbusy (
+	  ibid32	dir,		/* Directory holding a file	*/
+	  int32		slot,		/* Slot of the file's entry	*/
+	  ibid32	ilist		/* First i-block of a directory	*/
+	)
+{
+	struct	lflcblk	*lfptr;		/* Ptr to open file table entry	*/
+	int32	i;			/* Walks the open files		*/
+
+	if (ilist == Lf_data.lf_dir.lfd_root) {
+		return TRUE;
+	}
+	for (i=0; i<Nlfl; i++) {
+		lfptr = &lfltab[i];
+		if (lfptr->lfstate != LF_USED) {
+			continue;
+		}
+		if ( (slot >= 0) && (lfptr->lfpdir == dir) &&
+		     (lfptr->lfslot == slot) ) {
+			return TRUE;
+		}
+		if ( (ilist != LF_INULL) && ( (lfptr->lfpdir == ilist) ||
+		     (lfptr->lfdent.ld_ilist == ilist) ) ) {
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
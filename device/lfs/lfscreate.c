@@ -10,7 +10,10 @@
 status	lfscreate (
 	  did32		disk,		/* ID of an open disk device	*/
 	  ibid32	lfiblks,	/* Num. of index blocks on disk	*/
-	  uint32	dsiz		/* Total size of disk in bytes	*/
+	  uint32	dsiz,		/* Total size of disk in bytes	*/
+	  uint32	blksiz		/* Bytes in a data block (a	*/
+					/*   multiple of LF_BLKSIZ up	*/
+					/*   to LF_MAXBSIZ)		*/
 	)
 {
 	uint32	sectors;		/* Number of sectors to use	*/
@@ -18,9 +21,12 @@ status	lfscreate (
 	uint32	ibpersector;		/* Number of i-blocks per sector*/
 	struct	lfdir	dir;		/* Buffer to hold the directory	*/
 	uint32	dblks;			/* Total free data blocks	*/
+	uint32	bmsectors;		/* Number of sectors of bitmap	*/
+	uint32	spb;			/* Sectors in a data block	*/
 	struct	lfiblk	iblock;		/* Space for one i-block	*/
-	struct	lfdbfree dblock;	/* Data block on the free list	*/
-	dbid32	dbindex;		/* Index for data blocks	*/
+	byte	bmblock[LF_BLKSIZ];	/* One sector of the bitmap	*/
+	uint32	first;			/* First d-block in a sector	*/
+	uint32	idx;			/* Index of d-block in bitmap	*/
 	int32	retval;			/* Return value from func call	*/
 	int32	i;			/* Loop index			*/
 
@@ -30,6 +36,11 @@ status	lfscreate (
 	if ( isbaddev(disk) || (Lf_data.lf_dskdev >= 0) ) {
 		return SYSERR;
 	}
+	if ( (blksiz < LF_BLKSIZ) || (blksiz > LF_MAXBSIZ) ||
+	     ((blksiz % LF_BLKSIZ) != 0) ) {
+		return SYSERR;
+	}
+	spb = blksiz / LF_BLKSIZ;
 	Lf_data.lf_dskdev = disk;
 
 	/* Compute total sectors on disk */
@@ -49,17 +60,32 @@ status	lfscreate (
 
 	memset((char *)&dir, NULLCH, sizeof(struct lfdir));
 	dir.lfd_fsysid = LFS_ID;
-	dir.lfd_nfiles = 0;
 	dir.lfd_allzeros = 0;
 	dir.lfd_allones = 0xffffffff;
 	dir.lfd_revid = ((LFS_ID>>24) & 0x000000ff) | 
                   ((LFS_ID>> 8) & 0x0000ff00) |
                   ((LFS_ID<< 8) & 0x00ff0000) |
                   ((LFS_ID<<24) & 0xff000000) ;
-	dbindex= (dbid32)(ibsectors + 1);
-	dir.lfd_dfree = dbindex;
-	dblks = sectors - ibsectors - 1;
-	retval = write(disk,(char *)&dir, LF_AREA_DIR);
+	dir.lfd_vers = LF_VERSION;
+
+	dir.lfd_blksiz = blksiz;
+
+	/* Divide the remaining sectors between the bitmap, which	*/
+	/*   needs one bit per data block, and the data blocks		*/
+
+	bmsectors = (sectors - ibsectors - 1 + LF_BMBITS * spb) /
+						(LF_BMBITS * spb + 1);
+	dblks = (sectors - ibsectors - 1 - bmsectors) / spb;
+	dir.lfd_bmsect = ibsectors + 1;
+	dir.lfd_dstart = (dbid32)(ibsectors + 1 + bmsectors);
+	dir.lfd_ndblks = dblks;
+
+	/* The root directory uses i-block 0 and the first data block,	*/
+	/*   and the remaining i-blocks are free			*/
+
+	dir.lfd_root = 0;
+	dir.lfd_ifree = (lfiblks > 1) ? 1 : LF_INULL;
+	retval = bcwrite(disk,(char *)&dir, LF_AREA_DIR);
 	if (retval == SYSERR) {
 		return SYSERR;
 	}
@@ -74,16 +100,37 @@ status	lfscreate (
 	iblock.ib_next = LF_INULL;
 	lfibput(disk, i, &iblock);
 
-	/* Create list of free data blocks on disk */
+	/* Create an empty root directory that is its own parent */
 
-	memset((char*)&dblock, NULLCH, LF_BLKSIZ);
-	for (i=0; i<dblks-1; i++) {
-		dblock.lf_nextdb = dbindex + 1;
-		write(disk, (char *)&dblock, dbindex);
-		dbindex++;
+	lfibclear(&iblock, 0);
+	iblock.ib_ext[0].ex_start = dir.lfd_dstart;
+	iblock.ib_ext[0].ex_len = 1;
+	lfibput(disk, dir.lfd_root, &iblock);
+	memset((char *)bmblock, NULLCH, LF_BLKSIZ);
+	((struct ldhdr *)bmblock)->dh_nslots = LF_DMINSLOTS;
+	((struct ldhdr *)bmblock)->dh_parent = dir.lfd_root;
+	bcwrite(disk, (char *)bmblock, dir.lfd_dstart);
+
+	/* Create a bitmap in which all data blocks except the one used	*/
+	/*   by the root are free (bits beyond the last data block are	*/
+	/*   marked in use)						*/
+
+	for (i=0; i<bmsectors; i++) {
+		memset((char *)bmblock, NULLCH, LF_BLKSIZ);
+		first = i * LF_BMBITS;
+		for (idx=first; idx<first+LF_BMBITS; idx++) {
+			if ( (idx == 0) || (idx >= dblks) ) {
+				bmblock[(idx-first) >> 3] |= 1 << (idx & 0x7);
+			}
+		}
+		bcwrite(disk, (char *)bmblock, dir.lfd_bmsect + i);
+	}
+
+	/* Write the new file system from the buffer cache to the disk	*/
+
+	if (bcsync(disk) == SYSERR) {
+		return SYSERR;
 	}
-	dblock.lf_nextdb = LF_DNULL;
-	write(disk, (char *)&dblock, dbindex);
 	close(disk);
 	return OK;
 }
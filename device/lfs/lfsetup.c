@@ -1,7 +1,9 @@
-/* lfsetup.c - lfsetup */
+/* lfsetup.c - lfsetup, lfibspan */
 
 #include <xinu.h>
 
+local	uint32	lfibspan(struct lfiblk *);
+
 /*------------------------------------------------------------------------
  * lfsetup  -  Set a file's index block and data block for the current
  *		 file position (assumes file mutex held)
@@ -11,112 +13,183 @@ status	lfsetup (
 	  struct lflcblk  *lfptr	/* Pointer to slave file device	*/
 	)
 {
-	dbid32	dnum;			/* Data block to fetch		*/
+	dbid32	dnum;			/* Sector of data to fetch	*/
 	ibid32	ibnum;			/* I-block number during search	*/
 	struct	ldentry	*ldptr;		/* Ptr to file entry in dir.	*/
 	struct	lfiblk	*ibptr;		/* Ptr to in-memory index block	*/
-	uint32	newoffset;		/* Computed data offset for	*/
-					/*   next index block		*/
-	int32	dindex;			/* Index into array in an index	*/
-					/*   block			*/
-
+	struct	lfext	*xptr;		/* Ptr to an extent		*/
+	uint32	spb;			/* Sectors in a d-block		*/
+	uint32	fbn;			/* D-block of the file that	*/
+					/*   holds the current position	*/
+	uint32	blk;			/* First d-block of an extent	*/
+	dbid32	prevdb;			/* Data block that precedes a	*/
+					/*   newly allocated one	*/
+	int32	lo, hi, mid;		/* Bounds for binary search	*/
+	int32	i;			/* Index of an extent		*/
 
 	/* Obtain exclusive access to the directory */
 
 	wait(Lf_data.lf_mutex);
 
-	/* Get pointers to in-memory directory, file's entry in the	*/
-	/*	directory, and the in-memory index block		*/
+	/* Get pointers to the file's entry in the directory and the	*/
+	/*	in-memory index block					*/
 
 	ldptr = lfptr->lfdirptr;
 	ibptr = &lfptr->lfiblock;
 
 	/* If existing index block or data block changed, write to disk	*/
 
-	if (lfptr->lfibdirty || lfptr->lfdbdirty) {
+	if (lfptr->lfibdirty || lfptr->lfdbdirty || lfptr->lfdedirty) {
 		lfflush(lfptr);
 	}
-	ibnum = lfptr->lfinum;		/* Get ID of curr. index block	*/
-
-	/* If there is no index block in memory (e.g., because the file	*/
-	/*	was just opened), either load the first index block of	*/
-	/*	the file or allocate a new first index block		*/
+	spb = Lf_data.lf_spb;
+	fbn = lfptr->lfpos / (spb * LF_BLKSIZ);
 
-	if (ibnum == LF_INULL) {
+	/* An empty file gets its first i-block */
 
-		/* Check directory entry to see if index block exists	*/
-
-		ibnum = ldptr->ld_ilist;
-		if (ibnum == LF_INULL) { /* Empty file - get new i-block*/
-			ibnum = lfiballoc();
-			lfibclear(ibptr, 0);
-			ldptr->ld_ilist = ibnum;
-			lfptr->lfibdirty = TRUE;
-		} else {		/* Nonempty - read first i-block*/
-	 		lfibget(Lf_data.lf_dskdev, ibnum, ibptr);
-		}
+	if (ldptr->ld_ilist == LF_INULL) {
+		ibnum = lfiballoc();
+		lfibclear(ibptr, 0);
+		ldptr->ld_ilist = ibnum;
+		lfptr->lfdedirty = TRUE;
 		lfptr->lfinum = ibnum;
+		lfptr->lfibdirty = TRUE;
+		lfptr->lfnibmap = 0;
+	}
+	if (lfptr->lfnibmap == 0) {
+		lfptr->lfibmap[0] = ldptr->ld_ilist;
+		lfptr->lfibfbn[0] = 0;
+		lfptr->lfnibmap = 1;
+	}
 
-	/* Otherwise, if current file position has been moved to an	*/
-	/*   offset before the current index block, start at the	*/
-	/*   beginning of the index list for the file			*/
+	/* If the index block in memory does not cover the position,	*/
+	/*   use a binary search of the i-blocks recorded for the file	*/
+	/*   to find the last one that starts at or before the position	*/
+
+	if ( (lfptr->lfinum == LF_INULL) || (fbn < ibptr->ib_offset) ||
+	     ( (fbn >= ibptr->ib_offset + lfibspan(ibptr)) &&
+	       (ibptr->ib_next != LF_INULL) ) ) {
+		lo = 0;
+		hi = lfptr->lfnibmap - 1;
+		while (lo < hi) {
+			mid = (lo + hi + 1) / 2;
+			if (lfptr->lfibfbn[mid] <= fbn) {
+				lo = mid;
+			} else {
+				hi = mid - 1;
+			}
+		}
+		ibnum = lfptr->lfibmap[lo];
+		if (ibnum != lfptr->lfinum) {
+			lfibget(Lf_data.lf_dskdev, ibnum, ibptr);
+			lfptr->lfinum = ibnum;
+		}
+	}
 
-	} else if (lfptr->lfpos < ibptr->ib_offset) {
+	/* Move along the list beyond the recorded i-blocks, recording	*/
+	/*   each i-block passed while there is room			*/
 
-		/* Load initial index block for the file (we know that	*/
-		/*	at least one index block exists)		*/
-	
-		ibnum = ldptr->ld_ilist;
+	while ( (fbn >= ibptr->ib_offset + lfibspan(ibptr)) &&
+		(ibptr->ib_next != LF_INULL) ) {
+		ibnum = ibptr->ib_next;
 		lfibget(Lf_data.lf_dskdev, ibnum, ibptr);
 		lfptr->lfinum = ibnum;
+		if ( (lfptr->lfnibmap < LF_NIBMAP) &&
+		     (lfptr->lfibfbn[lfptr->lfnibmap-1] < ibptr->ib_offset) ) {
+			lfptr->lfibmap[lfptr->lfnibmap] = ibnum;
+			lfptr->lfibfbn[lfptr->lfnibmap++] = ibptr->ib_offset;
+		}
 	}
 
-	/* At this point, an index block is in memory, but may cover	*/
-	/*  an offset less than the current file position.  Loop until	*/
-	/*  the index block covers the current file position.		*/
+	/* Find the extent that holds the d-block */
+
+	dnum = LF_DNULL;
+	blk = ibptr->ib_offset;
+	for (i=0; i<LF_NEXTENT; i++) {
+		xptr = &ibptr->ib_ext[i];
+		if (xptr->ex_len == 0) {
+			break;
+		}
+		if (fbn < blk + xptr->ex_len) {
+			dnum = xptr->ex_start + (fbn - blk) * spb;
+			break;
+		}
+		blk += xptr->ex_len;
+	}
+
+	/* If the position lies just beyond the last d-block of the	*/
+	/*   file, allocate a new d-block, placing it after the file's	*/
+	/*   previous d-block when possible so the extent grows		*/
+
+	if (dnum == LF_DNULL) {
+		if (fbn != blk) {
+			signal(Lf_data.lf_mutex);
+			return SYSERR;
+		}
+		prevdb = LF_DNULL;
+		if (i > 0) {
+			xptr = &ibptr->ib_ext[i-1];
+			prevdb = xptr->ex_start + (xptr->ex_len - 1) * spb;
+		}
+		dnum = lfdballoc(prevdb);
+		if ( (prevdb != LF_DNULL) && (dnum == prevdb + spb) ) {
+			xptr->ex_len++;
+		} else if (i < LF_NEXTENT) {
+			ibptr->ib_ext[i].ex_start = dnum;
+			ibptr->ib_ext[i].ex_len = 1;
+		} else {
+
+			/* The i-block is full, so extend the list */
 
-	while ((lfptr->lfpos & ~LF_IMASK) > ibptr->ib_offset ) {
-		ibnum = ibptr->ib_next;
-		if (ibnum == LF_INULL) {
-			/* Allocate new index block to extend file */
 			ibnum = lfiballoc();
 			ibptr->ib_next = ibnum;
 			lfibput(Lf_data.lf_dskdev, lfptr->lfinum, ibptr);
+			lfibclear(ibptr, blk);
+			ibptr->ib_ext[0].ex_start = dnum;
+			ibptr->ib_ext[0].ex_len = 1;
 			lfptr->lfinum = ibnum;
-			newoffset = ibptr->ib_offset + LF_IDATA;
-			lfibclear(ibptr, newoffset);
-			lfptr->lfibdirty = TRUE;
-		} else {
-			lfibget(Lf_data.lf_dskdev, ibnum, ibptr);
-			lfptr->lfinum = ibnum;
+			if (lfptr->lfnibmap < LF_NIBMAP) {
+				lfptr->lfibmap[lfptr->lfnibmap] = ibnum;
+				lfptr->lfibfbn[lfptr->lfnibmap++] = blk;
+			}
 		}
-		lfptr->lfdnum = LF_DNULL; /* Invalidate old data block */
+		lfptr->lfibdirty = TRUE;
 	}
 
-	/* At this point, the index block in lfiblock covers the	*/
-	/*  current file position (i.e., position lfptr->lfpos).  The	*/
-	/*  next step consists of loading the correct data block.	*/
-
-	dindex = (lfptr->lfpos & LF_IMASK) >> 9;
-
-	/* If data block index does not match current data block, read	*/
-	/*   the correct data block from disk				*/
+	/* Select the sector within the d-block and read it from disk	*/
+	/*   unless it is already in memory or lies entirely beyond the	*/
+	/*   end of the file (e.g., it has just been allocated)		*/
 
-	dnum = lfptr->lfiblock.ib_dba[dindex];
-	if (dnum == LF_DNULL) {		/* Allocate new data block */
-		dnum = lfdballoc((struct lfdbfree *)&lfptr->lfdblock);
-		lfptr->lfiblock.ib_dba[dindex] = dnum;
-		lfptr->lfibdirty = TRUE;
-	} else if ( dnum != lfptr->lfdnum) {
-		read(Lf_data.lf_dskdev, (char *)lfptr->lfdblock, dnum);
+	dnum += (lfptr->lfpos / LF_BLKSIZ) % spb;
+	if ( (dnum != lfptr->lfdnum) &&
+	     ((lfptr->lfpos & ~LF_DMASK) < ldptr->ld_size) ) {
+		bcread(Lf_data.lf_dskdev, (char *)lfptr->lfdblock, dnum);
 		lfptr->lfdbdirty = FALSE;
 	}
 	lfptr->lfdnum = dnum;
 
 	/* Use current file offset to set the pointer to the next byte	*/
-	/*   within the data block					*/
+	/*   within the sector						*/
 
 	lfptr->lfbyte = &lfptr->lfdblock[lfptr->lfpos & LF_DMASK];
 	signal(Lf_data.lf_mutex);
 	return OK;
 }
+
+/*------------------------------------------------------------------------
+ * lfibspan  -  Return the number of d-blocks indexed by an i-block
+ *------------------------------------------------------------------------
+ */
+local	uint32	lfibspan (
+	  struct lfiblk	*ibptr		/* Ptr to in-memory index block	*/
+	)
+{
+	uint32	nblks;			/* Number of d-blocks		*/
+	int32	i;			/* Index of an extent		*/
+
+	nblks = 0;
+	for (i=0; i<LF_NEXTENT && ibptr->ib_ext[i].ex_len != 0; i++) {
+		nblks += ibptr->ib_ext[i].ex_len;
+	}
+	return nblks;
+}
@@ -12,6 +12,8 @@ devcall	lfsinit (
 	  struct dentry *devptr		/* Entry in device switch table */
 	)
 {
+	int32	i;			/* Index into a cache		*/
+
 	/* Indicate that no disk device has been selected */
 
 	Lf_data.lf_dskdev = -1;
@@ -28,5 +30,28 @@ devcall	lfsinit (
 
 	Lf_data.lf_dirpresent = Lf_data.lf_dirdirty = FALSE;
 
+	/* The d-block bitmap is loaded with the directory */
+
+	Lf_data.lf_spb = 1;
+	Lf_data.lf_dbmap = NULL;
+	Lf_data.lf_dbfree = 0;
+	Lf_data.lf_bmnchg = 0;
+
+	/* Empty the dentry cache */
+
+	for (i=0; i<LF_NDCACHE; i++) {
+		Lf_data.lf_dcache[i].dc_dir = LF_INULL;
+	}
+	Lf_data.lf_dcclock = 0;
+
+	/* Empty the i-block cache */
+
+	for (i=0; i<LF_NIBCACHE; i++) {
+		Lf_data.lf_ibcache[i].ic_inum = LF_INULL;
+		Lf_data.lf_ibcache[i].ic_dirty = FALSE;
+	}
+	Lf_data.lf_icclock = 0;
+	Lf_data.lf_icndirty = 0;
+
 	return OK;
 }
@@ -0,0 +1,38 @@
+/* lfsmount.c - lfsmount */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ * lfsmount  -  Read the directory sector and the d-block bitmap into
+ *		  memory if they are not already present (assumes
+ *		  directory mutex held)
+ *------------------------------------------------------------------------
+ */
+status	lfsmount(void)
+{
+	struct	lfdir	*dirptr;	/* Ptr to in-memory directory	*/
+
+	if (Lf_data.lf_dirpresent) {
+		return OK;
+	}
+	if (Lf_data.lf_dskdev < 0) {
+		kprintf("error: no disk selected for local files ");
+		kprintf("use lfscreate)\n");
+		return SYSERR;
+	}
+	dirptr = &Lf_data.lf_dir;
+	if (bcread(Lf_data.lf_dskdev, (char *)dirptr, LF_AREA_DIR)
+							== SYSERR) {
+		return SYSERR;
+	}
+	if (lfscheck(dirptr) == SYSERR ) {
+		kprintf("Disk does not contain a Xinu file system\n");
+		return SYSERR;
+	}
+	Lf_data.lf_spb = dirptr->lfd_blksiz / LF_BLKSIZ;
+	if (lfbmload() == SYSERR) {
+		return SYSERR;
+	}
+	Lf_data.lf_dirpresent = TRUE;
+	return OK;
+}
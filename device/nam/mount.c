@@ -47,6 +47,14 @@ syscall	mount(
 		namptr->nprefix[i] = *prefix++;
 	}
 
+	/* Add the prefix to the trie */
+
+	if (namtinsert(nnames) == SYSERR) {
+		kprintf("Namespace overflow\n");
+		restore(mask);
+		return SYSERR;
+	}
+
 	for (i=0; i<rsiz; i++) {	/* Copy replacement into entry	*/
 		namptr->nreplace[i] = *replace++;
 	}
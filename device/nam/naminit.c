@@ -16,6 +16,7 @@
 
 struct	nmentry	nametab[NNAMES];	/* Table of name mappings	*/
 int32	nnames;				/* Number of entries allocated	*/
+struct	nmcache	Nam_cache;		/* Resolved-name cache		*/
 
 /*------------------------------------------------------------------------
  *  naminit  -  Initialize the syntactic namespace
@@ -33,9 +34,11 @@ status	naminit(void)
 	int32	len;			/* Length of created name	*/
 	char	ch;			/* Storage for a character	*/
 
-	/* Set prefix table to empty */
+	/* Set prefix table, trie, and cache to empty */
 
 	nnames = 0;
+	Nam_cache.nc_hits = Nam_cache.nc_misses = 0;
+	namtbuild();
 
 	for (i=0; i<NDEVS ; i++) {
 		tptr = tmpstr;
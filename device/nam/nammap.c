@@ -15,9 +15,14 @@ devcall	nammap(
 	 did32 namdev			/* ID of the namespace device	*/
 	)
 {
+	intmask	mask;			/* Saved interrupt mask		*/
 	did32	newdev;			/* Device descriptor to return	*/
 	char	tmpname[NM_MAXLEN];	/* Temporary buffer for name	*/
 	int32	iter;			/* Number of iterations		*/
+	uint32	hash;			/* Hash of the name		*/
+	uint32	gen;			/* Cache generation at start	*/
+	struct	nmcent	*cptr;		/* Walks the cache		*/
+	int32	i;			/* Index into the cache		*/
 
 	/* Place original name in temporary buffer and null terminate */
 
@@ -25,21 +30,66 @@ devcall	nammap(
 		return SYSERR;
 	}
 
+	/* Return the result of an earlier mapping of the name if it	*/
+	/*   is in the cache						*/
+
+	hash = 0;
+	for (i=0; tmpname[i] != NULLCH; i++) {
+		hash = (hash * 31) + (byte)tmpname[i];
+	}
+	mask = disable();
+	gen = Nam_cache.nc_gen;
+	for (i=0; i<Nam_cache.nc_count; i++) {
+		cptr = &Nam_cache.nc_ent[i];
+		if ( (cptr->nc_hash == hash) && (cptr->nc_namdev == namdev) &&
+		     (strncmp(cptr->nc_name, tmpname, NM_MAXLEN) == 0) ) {
+			namcpy(newname, cptr->nc_newname, NM_MAXLEN);
+			newdev = cptr->nc_dev;
+			Nam_cache.nc_hits++;
+			restore(mask);
+			return newdev;
+		}
+	}
+	Nam_cache.nc_misses++;
+	restore(mask);
+
 	/* Repeatedly substitute the name prefix until a non-namespace	*/
 	/*   device is reached or an iteration limit is exceeded	*/
 
 	for (iter=0; iter<nnames ; iter++) {
 		newdev = namrepl(tmpname, newname);
 		if (newdev != namdev) {
-			return newdev;	/* Either valid ID or SYSERR	*/
+			break;
 		}
 		namcpy(tmpname, newname, NM_MAXLEN);
 	}
-	return SYSERR;
+	if ( (iter >= nnames) || (newdev == SYSERR) ) {
+		return SYSERR;
+	}
+
+	/* Cache the result unless the namespace changed meanwhile	*/
+
+	mask = disable();
+	if (gen == Nam_cache.nc_gen) {
+		if (Nam_cache.nc_count < NM_NCACHE) {
+			cptr = &Nam_cache.nc_ent[Nam_cache.nc_count++];
+		} else {
+			cptr = &Nam_cache.nc_ent[Nam_cache.nc_next];
+			Nam_cache.nc_next = (Nam_cache.nc_next + 1) % NM_NCACHE;
+		}
+		cptr->nc_hash = hash;
+		cptr->nc_namdev = namdev;
+		cptr->nc_dev = newdev;
+		namcpy(cptr->nc_name, name, NM_MAXLEN);
+		namcpy(cptr->nc_newname, newname, NM_MAXLEN);
+	}
+	restore(mask);
+	return newdev;
 }
 
 /*------------------------------------------------------------------------
- *  namrepl  -  Use the name table to perform prefix substitution
+ *  namrepl  -  Use the prefix trie to replace the longest prefix of a
+ *		  name that appears in the name table
  *------------------------------------------------------------------------
  */
 did32	namrepl(
@@ -47,66 +97,73 @@ did32	namrepl(
 	 char	newname[NM_MAXLEN]	/* Buffer for mapped name	*/
 	)
 {
-	int32	i;			/* Iterate through name table	*/
-	char	*pptr;			/* Walks through a prefix	*/
 	char	*rptr;			/* Walks through a replacement	*/
 	char	*optr;			/* Walks through original name	*/
         char    *nptr;                  /* Walks through new name       */
-	char	olen;			/* Length of original name	*/
+	int32	olen;			/* Length of original name	*/
 					/*   including the NULL byte	*/
-	int32	plen;			/* Length of a prefix string	*/
+	int32	plen;			/* Length of the matched prefix	*/
 					/*   *not* including NULL byte	*/
 	int32	rlen;			/* Length of replacment string	*/
 	int32	remain;			/* Bytes in name beyond prefix	*/
+	int32	node;			/* Current node of the trie	*/
+	int32	child;			/* Walks the children of a node	*/
+	int32	entry;			/* Entry of the longest match	*/
+	int32	len;			/* Characters of name matched	*/
 	struct	nmentry	*namptr;	/* Pointer to a table entry	*/
 
-	/* Search name table for first prefix that matches */
+	/* Walk down the trie along the name, remembering the deepest	*/
+	/*   node at which a prefix ends				*/
 
-	for (i=0; i<nnames; i++) {
-		namptr = &nametab[i];
-		optr = name;		/* Start at beginning of name	*/
-		pptr = namptr->nprefix;	/* Start at beginning of prefix	*/
-		
-		/* Compare prefix to string and count prefix size */
-
-		for (plen=0; *pptr != NULLCH ; plen++) {
-			if (*pptr != *optr) {
+	node = 0;
+	entry = namtrie[0].nn_entry;
+	plen = 0;
+	for (len=0; name[len] != NULLCH; len++) {
+		for (child = namtrie[node].nn_child; child != -1;
+					child = namtrie[child].nn_sibling) {
+			if (namtrie[child].nn_ch == name[len]) {
 				break;
 			}
-			pptr++;
-			optr++;
 		}
-		if (*pptr != NULLCH) {	/* Prefix does not match */
-			continue;
+		if (child == -1) {
+			break;
 		}
-
-		/* Found a match - check that replacement string plus	*/
-		/* bytes remaining at the end of the original name will	*/
-		/* fit into new name buffer.  Ignore null on replacement*/
-		/* string, but keep null on remainder of name.		*/
-
-		olen = namlen(name ,NM_MAXLEN);
-		rlen = namlen(namptr->nreplace,NM_MAXLEN) - 1;
-		remain = olen - plen;
-		if ( (rlen + remain) > NM_MAXLEN) {
-			return (did32)SYSERR;
+		node = child;
+		if (namtrie[node].nn_entry != -1) {
+			entry = namtrie[node].nn_entry;
+			plen = len + 1;
 		}
+	}
+	if (entry == -1) {
+		return (did32)SYSERR;
+	}
+	namptr = &nametab[entry];
+	optr = name + plen;
+
+	/* Found a match - check that replacement string plus	*/
+	/* bytes remaining at the end of the original name will	*/
+	/* fit into new name buffer.  Ignore null on replacement*/
+	/* string, but keep null on remainder of name.		*/
+
+	olen = namlen(name ,NM_MAXLEN);
+	rlen = namlen(namptr->nreplace,NM_MAXLEN) - 1;
+	remain = olen - plen;
+	if ( (olen == SYSERR) || ((rlen + remain) > NM_MAXLEN) ) {
+		return (did32)SYSERR;
+	}
 
-		/* Place replacement string followed by remainder of	*/
-		/*   original name (and null) into the new name buffer	*/
+	/* Place replacement string followed by remainder of	*/
+	/*   original name (and null) into the new name buffer	*/
 
-		
-                nptr = newname;
-                rptr = namptr->nreplace;
-		for (; rlen>0 ; rlen--) {
-			*nptr++ = *rptr++;
-		}
-		for (; remain>0 ; remain--) {
-			*nptr++ = *optr++;
-		}
-		return namptr->ndevice;
+        nptr = newname;
+        rptr = namptr->nreplace;
+	for (; rlen>0 ; rlen--) {
+		*nptr++ = *rptr++;
+	}
+	for (; remain>0 ; remain--) {
+		*nptr++ = *optr++;
 	}
-	return (did32)SYSERR;
+	return namptr->ndevice;
 }
 
 /*------------------------------------------------------------------------
@@ -0,0 +1,81 @@
+/* namtrie.c - namtinsert, namtbuild */
+
+#include <xinu.h>
+
+struct	nmnode	namtrie[NM_NNODES];	/* The prefix trie		*/
+int32	nnodes;				/* Number of nodes allocated	*/
+
+/*------------------------------------------------------------------------
+ *  namtinsert  -  Add the prefix of a name table entry to the trie and
+ *		     empty the resolved-name cache (called with interrupts
+ *		     disabled)
+ *------------------------------------------------------------------------
+ */
+status	namtinsert(
+	  int32		entry		/* Index of entry in nametab	*/
+	)
+{
+	char	*pptr;			/* Walks through the prefix	*/
+	int32	node;			/* Current node of the trie	*/
+	int32	child;			/* Walks the children of a node	*/
+	struct	nmnode	*nodeptr;	/* Pointer to a new node	*/
+
+	/* Follow the prefix down the trie, adding nodes as needed */
+
+	node = 0;
+	for (pptr = nametab[entry].nprefix; *pptr != NULLCH; pptr++) {
+		for (child = namtrie[node].nn_child; child != -1;
+					child = namtrie[child].nn_sibling) {
+			if (namtrie[child].nn_ch == *pptr) {
+				break;
+			}
+		}
+		if (child == -1) {
+			if (nnodes >= NM_NNODES) {
+				return SYSERR;
+			}
+			child = nnodes++;
+			nodeptr = &namtrie[child];
+			nodeptr->nn_ch = *pptr;
+			nodeptr->nn_entry = -1;
+			nodeptr->nn_child = -1;
+			nodeptr->nn_sibling = namtrie[node].nn_child;
+			namtrie[node].nn_child = child;
+		}
+		node = child;
+	}
+
+	/* An earlier entry with the same prefix keeps precedence */
+
+	if (namtrie[node].nn_entry == -1) {
+		namtrie[node].nn_entry = entry;
+	}
+	Nam_cache.nc_count = 0;
+	Nam_cache.nc_gen++;
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ *  namtbuild  -  Compile the entire name table into a new trie (used
+ *		    when entries are removed; called with interrupts
+ *		    disabled)
+ *------------------------------------------------------------------------
+ */
+status	namtbuild(void)
+{
+	int32	i;			/* Index into nametab		*/
+
+	nnodes = 1;
+	namtrie[0].nn_ch = NULLCH;
+	namtrie[0].nn_entry = -1;
+	namtrie[0].nn_child = -1;
+	namtrie[0].nn_sibling = -1;
+	Nam_cache.nc_count = 0;
+	Nam_cache.nc_gen++;
+	for (i=0; i<nnames; i++) {
+		if (namtinsert(i) == SYSERR) {
+			return SYSERR;
+		}
+	}
+	return OK;
+}
@@ -0,0 +1,37 @@
+/* unmount.c - unmount */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ *  unmount  -  Remove a prefix mapping from the name space
+ *------------------------------------------------------------------------
+ */
+syscall	unmount(
+	  char		*prefix		/* Prefix to remove		*/
+)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	int32	i;			/* Index into name table	*/
+	status	retval;			/* Value to return		*/
+
+	mask = disable();
+	for (i=0; i<nnames; i++) {
+		if (strncmp(prefix, nametab[i].nprefix, NM_PRELEN) == 0) {
+			break;
+		}
+	}
+	if (i >= nnames) {
+		restore(mask);
+		return SYSERR;
+	}
+
+	/* Close the gap in the table and compile the rest again */
+
+	for (; i<nnames-1; i++) {
+		nametab[i] = nametab[i+1];
+	}
+	nnames--;
+	retval = namtbuild();
+	restore(mask);
+	return retval;
+}
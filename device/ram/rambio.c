@@ -0,0 +1,41 @@
+/* rambio.c  -  rambio */
+
+#include <xinu.h>
+#include <ramdisk.h>
+
+/*------------------------------------------------------------------------
+ * rambio  -  Perform an asynchronous transfer (a chain of requests
+ *		linked by bio_next) on a ram disk, copying each request
+ *		in one operation
+ *------------------------------------------------------------------------
+ */
+devcall	rambio (
+	  struct dentry	*devptr,	/* Entry in device switch table	*/
+	  struct bioreq	*req		/* First request to perform	*/
+	)
+{
+	struct	bioreq	*nextreq;	/* Next request in the transfer	*/
+	char	*dskptr;		/* Blocks of the request	*/
+	uint32	nbytes;			/* Bytes in the request		*/
+
+	/* Completing a request may let its owner reuse it, so take	*/
+	/*   what is needed from each request before completing it	*/
+
+	for (; req != (struct bioreq *)NULL; req = nextreq) {
+		nextreq = req->bio_next;
+		if ( (req->bio_blk >= Ram.nblks) ||
+		     (req->bio_nblks > Ram.nblks - req->bio_blk) ) {
+			biodone(req, req->bio_nblks, SYSERR);
+			continue;
+		}
+		dskptr = &Ram.disk[req->bio_blk * RM_BLKSIZ];
+		nbytes = req->bio_nblks * RM_BLKSIZ;
+		if (req->bio_op == BIO_READ) {
+			memcpy(req->bio_buf, dskptr, nbytes);
+		} else {
+			memcpy(dskptr, req->bio_buf, nbytes);
+		}
+		biodone(req, req->bio_nblks, OK);
+	}
+	return OK;
+}
@@ -0,0 +1,75 @@
+/* ramcontrol.c  -  ramcontrol */
+
+#include <xinu.h>
+#include <ramdisk.h>
+
+/*------------------------------------------------------------------------
+ * ramcontrol  -  Provide control functions for a ram disk
+ *------------------------------------------------------------------------
+ */
+devcall	ramcontrol (
+	 struct dentry	*devptr,	/* Entry in device switch table	*/
+	 int32	func,			/* The control function to use	*/
+	 int32	arg1,			/* Argument #1			*/
+	 int32	arg2			/* Argument #2			*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	char	*newdisk;		/* Memory for a resized disk	*/
+	uint32	nbytes;			/* Bytes to keep when resizing	*/
+
+	mask = disable();
+	switch (func) {
+
+	/* Report the size of the disk in blocks */
+
+	case RM_CTL_SIZE:
+		restore(mask);
+		return (devcall)Ram.nblks;
+
+	/* Move the disk to memory for arg1 blocks, keeping the	*/
+	/*   contents of the blocks that remain (dirty cached blocks	*/
+	/*   are written first, and the cache is discarded after)	*/
+
+	case RM_CTL_RESIZE:
+		if ( (arg1 < RM_MINBLKS) ||
+		     (bcsync(devptr->dvnum) == SYSERR) ) {
+			restore(mask);
+			return SYSERR;
+		}
+		newdisk = getmem((uint32)arg1 * RM_BLKSIZ);
+		if (newdisk == (char *)SYSERR) {
+			restore(mask);
+			return SYSERR;
+		}
+		nbytes = RM_BLKSIZ * (((uint32)arg1 < Ram.nblks) ?
+						(uint32)arg1 : Ram.nblks);
+		memcpy(newdisk, Ram.disk, nbytes);
+		memset(newdisk + nbytes, NULLCH,
+				(uint32)arg1 * RM_BLKSIZ - nbytes);
+		freemem(Ram.disk, Ram.nblks * RM_BLKSIZ);
+		Ram.disk = newdisk;
+		Ram.nblks = (uint32)arg1;
+		bcinval(devptr->dvnum);
+		restore(mask);
+		return arg1;
+
+	/* Return the address of arg2 blocks starting at block arg1	*/
+	/*   (after writing dirty cached blocks, so the memory is	*/
+	/*   current)							*/
+
+	case RM_CTL_BLKPTR:
+		if ( (arg1 < 0) || (arg2 <= 0) ||
+		     ((uint32)arg1 + (uint32)arg2 > Ram.nblks) ||
+		     (bcsync(devptr->dvnum) == SYSERR) ) {
+			restore(mask);
+			return SYSERR;
+		}
+		restore(mask);
+		return (devcall)&Ram.disk[(uint32)arg1 * RM_BLKSIZ];
+
+	default:
+		restore(mask);
+		return SYSERR;
+	}
+}
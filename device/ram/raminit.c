@@ -6,14 +6,40 @@
 struct	ramdisk	Ram;
 
 /*------------------------------------------------------------------------
- *  raminit  -  Initialize the remote disk system device
+ *  raminit  -  Initialize the ram disk, sizing it from the memory that
+ *		  is available
  *------------------------------------------------------------------------
  */
 devcall	raminit (
 	  struct dentry	*devptr		/* Entry in device switch table	*/
 	)
 {
+	struct	memblk	*memptr;	/* Walks the free memory list	*/
+	uint32	maxfree;		/* Largest free block in bytes	*/
+	uint32	nblks;			/* Number of blocks for the disk*/
+
+	maxfree = 0;
+	for (memptr = memlist.mnext; memptr != NULL;
+					memptr = memptr->mnext) {
+		if (memptr->mlength > maxfree) {
+			maxfree = memptr->mlength;
+		}
+	}
+	nblks = RM_BLKS;
+	if (nblks > maxfree / RM_MEMDIV / RM_BLKSIZ) {
+		nblks = maxfree / RM_MEMDIV / RM_BLKSIZ;
+	}
+	if (nblks < RM_MINBLKS) {
+		nblks = RM_MINBLKS;
+	}
+	Ram.disk = getmem(nblks * RM_BLKSIZ);
+	if (Ram.disk == (char *)SYSERR) {
+		Ram.disk = NULL;
+		Ram.nblks = 0;
+		return SYSERR;
+	}
+	Ram.nblks = nblks;
 	memcpy(Ram.disk, "hopeless", 8);
-	memcpy( &Ram.disk[8], Ram.disk, RM_BLKSIZ * RM_BLKS - 8);
+	memcpy( &Ram.disk[8], Ram.disk, RM_BLKSIZ * nblks - 8);
 	return OK;
 }
@@ -15,6 +15,9 @@ devcall	ramwrite (
 {
 	int32	bpos;			/* Byte position of blk		*/
 
+	if ( (blk < 0) || ((uint32)blk >= Ram.nblks) ) {
+		return SYSERR;
+	}
 	bpos = RM_BLKSIZ * blk;
 	memcpy(&Ram.disk[bpos], buff, RM_BLKSIZ);
 	return OK;
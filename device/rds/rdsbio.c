@@ -0,0 +1,98 @@
+/* rdsbio.c - rdsbio */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ * rdsbio  -  Start an asynchronous transfer (a chain of requests
+ *		linked by bio_next) on a remote disk: blocks held locally
+ *		complete at once, and the rest are queued for the
+ *		communication process; rdsprocess (writes) and rdsrecv
+ *		(reads) complete them later
+ *------------------------------------------------------------------------
+ */
+devcall	rdsbio (
+	  struct dentry	*devptr,	/* Entry in device switch table	*/
+	  struct bioreq	*req		/* Request to start		*/
+	)
+{
+	struct	rdscblk	*rdptr;		/* Pointer to the control block	*/
+					/*   for the disk device	*/
+	struct	rdqnode	*rptr;		/* Pointer to a request node	*/
+	struct	bioreq	*nextreq;	/* Next request in the transfer	*/
+	intmask	mask;			/* Saved interrupt mask		*/
+	char	*buff;			/* Caller's buffer for a block	*/
+	char	*buf;			/* Buffer of the request	*/
+	uint32	blk;			/* Block number			*/
+	uint32	firstblk;		/* First block of the request	*/
+	uint32	nblks;			/* Blocks in the request	*/
+	int32	op;			/* Operation of the request	*/
+	uint32	i;			/* Index of block in request	*/
+
+	/* If the device not currently open, report an error */
+
+	mask = disable();
+	rdptr = &rdstab[devptr->dvminor];
+	if (rdptr->rd_state != RD_OPEN) {
+		restore(mask);
+		return SYSERR;
+	}
+
+	/* Ensure the communication process is runnning */
+
+	if ( ! rdptr->rd_comruns ) {
+		rdptr->rd_comruns = TRUE;
+		resume(rdptr->rd_comproc);
+	}
+
+	/* Completing a request may let its owner reuse it, so take	*/
+	/*   what is needed from each request before its blocks start	*/
+
+	for (; req != (struct bioreq *)NULL; req = nextreq) {
+		nextreq = req->bio_next;
+		op = req->bio_op;
+		buf = req->bio_buf;
+		firstblk = req->bio_blk;
+		nblks = req->bio_nblks;
+		for (i=0; i<nblks; i++) {
+			buff = buf + i * RD_BLKSIZ;
+			blk = firstblk + i;
+
+			/* Complete the block at once if possible */
+
+			if (op == BIO_READ) {
+				if (rdsrlocal(rdptr, buff, blk)) {
+					biodone(req, 1, OK);
+					continue;
+				}
+				rdptr->rd_cmisses++;
+			} else if (rdswlocal(rdptr, buff, blk)) {
+				biodone(req, 1, OK);
+				continue;
+			}
+
+			/* Obtain one of the request nodes set aside	*/
+			/*   for asynchronous requests (waiting, while	*/
+			/*   earlier blocks are sent, if all are in use)*/
+
+			wait(rdptr->rd_biosem);
+
+			/* Queue a request that no process waits for;	*/
+			/*   the block completes the asynchronous	*/
+			/*   request					*/
+
+			rptr = rdptr->rd_qfree;
+			rdptr->rd_qfree = rptr->rd_next;
+			rptr->rd_op = (op == BIO_READ) ? RD_OP_READ :
+							RD_OP_WRITE;
+			rptr->rd_blknum = blk;
+			rptr->rd_callbuf = buff;
+			rptr->rd_statp = NULL;
+			rptr->rd_pid = -1;
+			rptr->rd_bio = req;
+			rdqinsert(rdptr, rptr);
+			signal(rdptr->rd_comsem);
+		}
+	}
+	restore(mask);
+	return OK;
+}
@@ -15,17 +15,18 @@ devcall	rdscontrol (
 {
 	struct	rdscblk	*rdptr;		/* Pointer to control block	*/
 	struct	rdqnode	*rptr;		/* Pointer to a request node	*/
-	struct	rd_msg_dreq msg;	/* Buffer for delete request	*/
-	struct	rd_msg_dres resp;	/* Buffer for delete response	*/
-	char	*to, *from;		/* Used during name copy	*/
-	int32	retval;			/* Return value			*/
-	uint32	mypid;			/* PID of the calling process	*/
+	intmask	mask;			/* Saved interrupt mask		*/
+	status	retval;			/* Outcome of a delete request	*/
+	bool8	werr;			/* Did a write back fail before	*/
+					/*   a sync started?		*/
 	pri16	myprio;			/* Process priority		*/
 
 	/* If the device not currently open, report an error */
 
+	mask = disable();
 	rdptr = &rdstab[devptr->dvminor];
 	if (rdptr->rd_state != RD_OPEN) {
+		restore(mask);
 		return SYSERR;
 	}
 
@@ -42,12 +43,24 @@ devcall	rdscontrol (
 
 	case RDS_CTL_SYNC:
 
-		/* If request queue is empty, return immediately */
+		/* If no request is queued or outstanding at the server	*/
+		/*   and no cached block awaits write back, return	*/
+		/*   immediately					*/
 
-		if (rdptr->rd_qhead == (struct rdqnode *)NULL) {
-			return OK;
+		if ( (rdptr->rd_qhead == (struct rdqnode *)NULL) &&
+		     (rdptr->rd_npend == 0) && (rdptr->rd_ndirty == 0) ) {
+			retval = rdptr->rd_werr ? SYSERR : OK;
+			rdptr->rd_werr = FALSE;
+			restore(mask);
+			return retval;
 		}
 
+		/* Clear an earlier write back failure, so the sync	*/
+		/*   retries the blocks it left dirty, but report it	*/
+
+		werr = rdptr->rd_werr;
+		rdptr->rd_werr = FALSE;
+
 		/* Allocate a request node and fill in a sync request */
 
 		rptr = rdptr->rd_qfree;
@@ -55,18 +68,13 @@ devcall	rdscontrol (
 		rptr->rd_op = RD_OP_SYNC;
 		rptr->rd_blknum = 0;		/* unused */
 		rptr->rd_callbuf = NULL;	/* unused */
-		mypid = getpid();
-		rptr->rd_pid = mypid;
+		rptr->rd_statp = NULL;		/* unused */
+		rptr->rd_pid = getpid();
+		rptr->rd_bio = (struct bioreq *)NULL;
 
 		/* Insert the new request at the tail of the queue */
 
-		rptr->rd_next = (struct rdqnode *)NULL;
-		rptr->rd_prev = rdptr->rd_qtail;
-		if (rdptr->rd_qtail == (struct rdqnode *)NULL) {
-			/* Request queue was empty */
-			rdptr->rd_qhead = rptr;
-		}
-		rdptr->rd_qtail = rptr;
+		rdqinsert(rdptr, rptr);
 
 		/* Atomically signal the comm. process semaphore and	*/
 		/*   suspend the current process by temporarily setting	*/
@@ -79,43 +87,47 @@ devcall	rdscontrol (
 		signal(rdptr->rd_comsem);
 		suspend(getpid());
 		myprio = rdssetprio(myprio);
+		if (werr || rdptr->rd_werr) {
+			rdptr->rd_werr = FALSE;
+			restore(mask);
+			return SYSERR;
+		}
+		restore(mask);
 		return OK;
 
 		/* Delete the remote disk (entirely remove it) */
 
 	case RDS_CTL_DEL:
 
-		/* Handcraft a message for the server that requests	*/
-		/*	deleting the disk with the specified ID		*/
-
-		msg.rd_type = htons(RD_MSG_DREQ);/* Request deletion	*/
-		msg.rd_status = htons(0);
-		msg.rd_seq = 0;	/* rdscomm will insert sequence # later	*/
-		to = msg.rd_id;
-		memset(to, NULLCH, RD_IDLEN);	/* Initialize to zeroes	*/
-		from = rdptr->rd_id;
-		while ( (*to++ = *from++) != NULLCH ) {	/* copy ID	*/
-			;
-		}
+		/* Discard the cache, including blocks not yet written	*/
 
-		/* Send message and receive response */
+		while (rdptr->rd_chead != (struct rdcnode *)NULL) {
+			rdcunlink(rdptr, rdptr->rd_chead);
+		}
 
-		retval = rdscomm((struct rd_msg_hdr *)&msg,
-					sizeof(struct rd_msg_dreq),
-			 (struct rd_msg_hdr *)&resp,
-					sizeof(struct rd_msg_dres),
-					rdptr);
+		/* Queue a delete request; the communication process	*/
+		/*   sends it once earlier requests have completed	*/
 
-		/* Check the response */
+		rptr = rdptr->rd_qfree;
+		rdptr->rd_qfree = rptr->rd_next;
+		rptr->rd_op = RD_OP_DEL;
+		rptr->rd_blknum = 0;		/* unused */
+		rptr->rd_callbuf = NULL;	/* unused */
+		rptr->rd_statp = &retval;
+		rptr->rd_pid = getpid();
+		rptr->rd_bio = (struct bioreq *)NULL;
+		rdqinsert(rdptr, rptr);
 
-		if ( (retval == SYSERR) || (retval == TIMEOUT) ||
-		     (ntohs(resp.rd_status) != 0) ) {
-			return SYSERR;
-		}
-		return OK;
+		myprio = rdssetprio(MAXPRIO);
+		signal(rdptr->rd_comsem);
+		suspend(getpid());
+		myprio = rdssetprio(myprio);
+		restore(mask);
+		return retval;
 
 	default:
-		kprintf("rsscontrol: invalid function %d\n");
+		kprintf("rsscontrol: invalid function %d\n", func);
+		restore(mask);
 		return SYSERR;
 	}
 	return OK;
@@ -3,7 +3,9 @@
 #include <xinu.h>
 
 /*------------------------------------------------------------------------
- * rdsopen  -  Open a remote disk device and specify an ID to use
+ * rdsopen  -  Open a remote disk device and specify an ID to use (the
+ *		mode may include a decimal number of blocks to cache,
+ *		e.g., "rw1024"; the default is RD_CNODES)
  *------------------------------------------------------------------------
  */
 
@@ -27,6 +29,9 @@ devcall	rdsopen (
 	char	*pend;			/* Address beyond the nodes	*/
 	char	*pprev;			/* Address of previous buffer	*/
 					/*  when linking them		*/
+	int32	i;			/* Index into outstanding table	*/
+	int32	csize;			/* Number of cache nodes	*/
+	uint32	hsize;			/* Number of hash table entries	*/
 
 	/* Find the control block for this remote disk device */
 
@@ -62,6 +67,22 @@ devcall	rdsopen (
 		return SYSERR;
 	}
 
+	/* Obtain the cache size from the mode string, if present */
+
+	csize = 0;
+	for (p = mode; (p != NULL) && (*p != NULLCH); p++) {
+		if ( (*p >= '0') && (*p <= '9') ) {
+			csize = 10*csize + (*p - '0');
+			if (csize > RD_CMAX) {
+				rdptr->rd_state = RD_CLOSED;
+				return SYSERR;
+			}
+		}
+	}
+	if (csize == 0) {
+		csize = RD_CNODES;
+	}
+
 	/* Hand-craft an open request message to be sent to the server */
 
 	msg.rd_type = htons(RD_MSG_OREQ);/* Request an open		*/
@@ -105,6 +126,11 @@ devcall	rdsopen (
 
 	rdptr->rd_comsem = semcreate(0);
 
+	/* Create a semaphore that limits the request nodes used by	*/
+	/*   asynchronous requests					*/
+
+	rdptr->rd_biosem = semcreate(RD_BIOMAX);
+
 
 	/* Create the communication process for this remote deisk */
 
@@ -115,7 +141,26 @@ devcall	rdsopen (
 		rdptr->rd_state = RD_CLOSED;
 		return SYSERR;
 	}
-	
+
+	/* Create the process that receives replies from the server	*/
+
+	rdptr->rd_recvproc = create(rdsrecv, RD_STACK, RD_PRIO,
+						"rdsrecv", 1, rdptr);
+	if (rdptr->rd_recvproc == SYSERR) {
+		kprintf("rdsopen: cannot create remote disk process");
+		rdptr->rd_state = RD_CLOSED;
+		return SYSERR;
+	}
+
+	/* Initialize the table of outstanding requests to empty */
+
+	for (i=0; i<RD_WINDOW; i++) {
+		rdptr->rd_pent[i].rd_op = RD_OP_NONE;
+		rdptr->rd_pent[i].rd_xmit = FALSE;
+	}
+	rdptr->rd_npend = 0;
+	rdptr->rd_retrans = 0;
+
 	/* Initialize the request queue to empty */
 
 	rdptr->rd_qhead = rdptr->rd_qtail = (struct rdqnode *) NULL;
@@ -143,10 +188,42 @@ devcall	rdsopen (
 	/* Initialize the cache to empty */
 
 	rdptr->rd_chead = rdptr->rd_ctail = (struct rdcnode *) NULL;
+	rdptr->rd_csize = csize;
+	rdptr->rd_ndirty = 0;
+	rdptr->rd_chits = rdptr->rd_cmisses = 0;
+	rdptr->rd_cwbacks = rdptr->rd_ccoalesce = 0;
+	rdptr->rd_werr = FALSE;
+
+	/* Initialize the readahead streams to unused */
+
+	for (i=0; i<RD_NSTREAM; i++) {
+		rdptr->rd_stream[i].rd_spid = -1;
+		rdptr->rd_stream[i].rd_sused = 0;
+	}
+	rdptr->rd_sclock = 0;
+	rdptr->rd_nra = 0;
+	rdptr->rd_raissued = rdptr->rd_rahits = 0;
+
+	/* Allocate a hash table with a power-of-two number of entries	*/
+	/*   (at least the number of cache nodes) and clear it		*/
+
+	for (hsize = 1; hsize < csize; hsize <<= 1) {
+		;
+	}
+	rdptr->rd_chmask = hsize - 1;
+	rdptr->rd_chash = (struct rdcnode **)getmem(hsize *
+					sizeof(struct rdcnode *));
+	if ((int32)rdptr->rd_chash == SYSERR) {
+		kprintf("rdsopen: cannot allocate cache hash table\n");
+		rdptr->rd_state = RD_CLOSED;
+		return SYSERR;
+	}
+	memset((char *)rdptr->rd_chash, NULLCH,
+				hsize * sizeof(struct rdcnode *));
 
 	/* Allocate cache nodes and link them onto a cache free list	*/
 
-	size = sizeof(struct rdcnode) * RD_CNODES;
+	size = sizeof(struct rdcnode) * csize;
 
 	p = getmem(size);
 	if ((int32)p == SYSERR) {
@@ -167,6 +244,7 @@ devcall	rdsopen (
 	/*    block waiting on the semaphore				*/
 
 	resume(rdptr->rd_comproc);
+	resume(rdptr->rd_recvproc);
 
 	/* Change state of device to open */
 
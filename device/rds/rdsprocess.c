@@ -1,14 +1,25 @@
-/* rdsprocess.c - rdsprocess */
-
-/*DEBUG*/ int	go = 1;
+/* rdsprocess.c - rdsprocess, rdsconflict, rdsadjacent, rdsaddreq,	*/
+/*		  rdsflush, rdspent					*/
 
 #include <xinu.h>
 
+local	bool8	rdsconflict(struct rdscblk *, int32, uint32);
+local	struct	rdqnode	*rdsadjacent(struct rdscblk *, int32, uint32);
+local	void	rdsaddreq(struct rdscblk *, struct rdpent *,
+				struct rdqnode *);
+local	void	rdsflush(struct rdscblk *, bool8);
+local	struct	rdpent	*rdspent(struct rdscblk *, int32, uint32);
+
 /*------------------------------------------------------------------------
  * rdsprocess  -  High-priority background process that repeatedly
- *		  extracts an item from the request queue, sends the
- *		  request to the remote disk server, and handles the
- *		  response, including caching responses blocks
+ *		  extracts items from the request queue and sends them to
+ *		  the remote disk server, keeping up to RD_WINDOW requests
+ *		  outstanding (replies are handled by rdsrecv), and that
+ *		  writes dirty cache blocks back to the server; queued
+ *		  reads or writes of adjacent blocks are merged into one
+ *		  multi-block request.  Requests are chosen while
+ *		  rescheduling is deferred, but sent after the deferral
+ *		  ends, because sending can block
  *------------------------------------------------------------------------
  */
 
@@ -16,163 +27,353 @@ void	rdsprocess (
 	  struct rdscblk    *rdptr	/* Ptr to device control block	*/
 	)
 {
-	struct	rd_msg_wreq msg;	/* Message to be sent		*/
-					/*   (includes data area)	*/
-	struct	rd_msg_rres resp;	/* Buffer to hold response	*/
-					/*   (includes data area)	*/
-	int32	retval;			/* Return value from rdscomm	*/
-	char	*idto;			/* Ptr to ID string for copy	*/
-	char	*idfrom;		/* Ptr into ID string for copu	*/
+	intmask	mask;			/* Saved interrupt mask		*/
 	struct	rdqnode	*rptr;		/* Ptr to a node in the request	*/
 					/*    queue			*/
-	struct	rdqnode	*tptr;		/* Temp pointer to a node in	*/
-					/*    the request queue		*/
-	uint32	blk;			/* Block number in current req.	*/
+	struct	rdpent	*pptr;		/* Ptr to an outstanding entry	*/
 
 	while (TRUE) {			/* Do forever */
 
-	    /* Wait until a request arrives and node */
+	    /* Wait until a request arrives, a reply frees an entry, or	*/
+	    /*   rdsrecv finds dirty blocks waiting to be written back	*/
 
 	    wait(rdptr->rd_comsem);
-	    rptr = rdptr->rd_qhead;
-	    if (rptr == (struct rdqnode *)NULL) {
-		/* A request was satisfied early */
-		continue;
-	    }
-	    blk = rptr->rd_blknum;
-
-	    /* Use operation in request to determine action */
 
-	   switch (rptr->rd_op) {
+	    mask = disable();
+	    resched_cntl(DEFER_START);
 
-	   case RD_OP_SYNC:
-		resume(rptr->rd_pid);
-		rptr = rdqunlink(rdptr, rptr);
-		break;
+	    /* Start requests in queue order until the queue is empty,	*/
+	    /*   the window is full, or the head request must wait	*/
 
-	   case RD_OP_READ:
+	    while ( (rptr = rdptr->rd_qhead) != (struct rdqnode *)NULL) {
 
-		/* Build a read request message for the server */
+		/* A sync completes once all earlier requests have	*/
+		/*   and all dirty blocks have been written back, or	*/
+		/*   once nothing is outstanding after a write back	*/
+		/*   failed (so a sync does not retry forever)		*/
 
-		msg.rd_type = htons(RD_MSG_RREQ);	/* Read request	*/
-		msg.rd_status = htons(0);
-		msg.rd_seq = 0;		/* rdscomm fills in the value	*/
-		idto = msg.rd_id;
-		memset(idto, NULLCH, RD_IDLEN);/* Initialize ID to zero	*/
-		idfrom = rdptr->rd_id;
-		while ( (*idto++ = *idfrom++) != NULLCH ) { /* Copy ID	*/
-			;
-		msg.rd_blk = htonl(blk);
+		if (rptr->rd_op == RD_OP_SYNC) {
+			if ( (rdptr->rd_npend > 0) ||
+			     ((rdptr->rd_ndirty > 0) && !rdptr->rd_werr) ) {
+				break;
+			}
+			resume(rptr->rd_pid);
+			rdqunlink(rdptr, rptr);
+			continue;
 		}
 
-		/* Send the message and receive a response */
+		if ( (rdptr->rd_npend >= RD_WINDOW) ||
+		     ((rptr->rd_op == RD_OP_DEL) && (rdptr->rd_npend > 0))
+		     || rdsconflict(rdptr, rptr->rd_op, rptr->rd_blknum) ) {
+			break;
+		}
 
-		retval = rdscomm((struct rd_msg_hdr *)&msg,
-					sizeof(struct rd_msg_rreq),
-				 (struct rd_msg_hdr *)&resp,
-					sizeof(struct rd_msg_rres),
-				  rdptr );
+		pptr = rdspent(rdptr, rptr->rd_op, rptr->rd_blknum);
+		rdsaddreq(rdptr, pptr, rptr);
 
-		/* Check response */
+		/* Merge queued requests for the blocks that follow */
 
-		if ( (retval == SYSERR) || (retval == TIMEOUT) ||
-				(ntohs(resp.rd_status) != 0) ) {
-			panic("remite disk error contacting server");
+		while ( (pptr->rd_op != RD_OP_DEL) &&
+			(pptr->rd_nblks < RD_MAXBLKS) ) {
+			rptr = rdsadjacent(rdptr, pptr->rd_op,
+					pptr->rd_blknum + pptr->rd_nblks);
+			if (rptr == (struct rdqnode *)NULL) {
+				break;
+			}
+			rdsaddreq(rdptr, pptr, rptr);
 		}
 
-		/* Copy data from the reply into the buffer */
+		/* Send the request once rescheduling is allowed */
 
-		memcpy(rptr->rd_callbuf, resp.rd_data, RD_BLKSIZ);
+		pptr->rd_xmit = TRUE;
+	    }
 
-		/* Resume the waiting process (will not run until the	*/
-		/*     communication process blocks			*/
+	    /* Write back all dirty blocks before a sync, the oldest	*/
+	    /*   ones under pressure, and otherwise only those that	*/
+	    /*   have been dirty for RD_WBDELAY ms (so that repeated	*/
+	    /*   writes of a block coalesce in the cache)		*/
 
-		resume(rptr->rd_pid);
+	    if (rdptr->rd_ndirty > 0) {
+		rptr = rdptr->rd_qhead;
+		rdsflush(rdptr, ((rptr != (struct rdqnode *)NULL) &&
+				 (rptr->rd_op == RD_OP_SYNC)) ||
+			(rdptr->rd_ndirty >= RD_DIRTYHI(rdptr->rd_csize)));
+	    }
 
-		tptr = rdqunlink(rdptr, rptr);
+	    resched_cntl(DEFER_STOP);
+	    restore(mask);
 
-		/* Walk the request queue and satisfy subsequent read	*/
-		/*    requests for the same block			*/
+	    /* Send the requests just started; if a send fails, rdsrecv	*/
+	    /*   retransmits on timeout					*/
 
-		rptr = rdptr->rd_qhead;
-		while (rptr != (struct rdqnode *)NULL) {
-		    if (rptr->rd_blknum != blk) {
-			rptr = rptr->rd_next;
-			continue;
-		    }
-		    /* block number matches */
-		    if (rptr->rd_op == RD_OP_WRITE) {
-			/* Stop on a write for the block */
-			break;
-		    }
-		    if ( rptr->rd_op == RD_OP_READ ) {
-			/* Satisfy a subsequent read for the block */
-			memcpy(rptr->rd_callbuf,resp.rd_data,RD_BLKSIZ);
-			resume(rptr->rd_pid);
-			rptr = rdqunlink(rdptr, rptr);
-		    } else {
-			rptr = rptr->rd_next;
-		    }
+	    rdsxmitpend(rdptr);
+	}
+}
+
+/*------------------------------------------------------------------------
+ * rdsconflict  -  Determine whether a request must wait because an
+ *		     outstanding request refers to the same block (the
+ *		     server might process the two out of order, or the
+ *		     outstanding reply will satisfy the request)
+ *------------------------------------------------------------------------
+ */
+local	bool8	rdsconflict (
+	  struct rdscblk    *rdptr,	/* Ptr to device control block	*/
+	  int32		    op,		/* Operation to be started	*/
+	  uint32	    blk		/* Block to be read or written	*/
+	)
+{
+	struct	rdpent	*pptr;		/* Ptr to an outstanding entry	*/
+	int32	i;			/* Index into outstanding table	*/
+
+	if (op == RD_OP_DEL) {
+		return FALSE;
+	}
+	for (i=0; i<RD_WINDOW; i++) {
+		pptr = &rdptr->rd_pent[i];
+		if (pptr->rd_op == RD_OP_DEL) {
+			return TRUE;	/* Nothing passes a delete	*/
 		}
-		break;
 
-	    case RD_OP_WRITE:
+		/* A write must wait for any other request; a read	*/
+		/*   waits for an outstanding read of the block (for	*/
+		/*   example, a readahead) whose reply will satisfy it	*/
 
-		/* Build a write request message for the server */
+		if ( (pptr->rd_op != RD_OP_NONE) && rdpholds(pptr, blk) ) {
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
 
-		msg.rd_type = htons(RD_MSG_WREQ);	/* Write request*/
-		msg.rd_status = htons(0);
-		msg.rd_seq = 0;		/* Rdscomb fills in an entry	*/
-		idto = msg.rd_id;
-		memset(idto, NULLCH, RD_IDLEN);/* Initialize ID to zero	*/
-		idfrom = rdptr->rd_id;
-		while ( (*idto++ = *idfrom++) != NULLCH ) { /* Copy ID	*/
-			;
+/*------------------------------------------------------------------------
+ * rdsadjacent  -  Find a queued request that can be merged into an
+ *		     outstanding entry as block blk, i.e., the earliest
+ *		     queued request with the same operation for blk that
+ *		     can be moved ahead of the requests before it
+ *------------------------------------------------------------------------
+ */
+local	struct	rdqnode	*rdsadjacent (
+	  struct rdscblk    *rdptr,	/* Ptr to device control block	*/
+	  int32		    op,		/* Operation (read or write)	*/
+	  uint32	    blk		/* Block that would extend run	*/
+	)
+{
+	struct	rdqnode	*rptr;		/* Walks the request queue	*/
+
+	if (rdsconflict(rdptr, op, blk)) {
+		return (struct rdqnode *)NULL;
+	}
+	for (rptr = rdptr->rd_qhead; rptr != (struct rdqnode *)NULL;
+						rptr = rptr->rd_next) {
+
+		/* Never move a request ahead of a sync or delete */
+
+		if ( (rptr->rd_op == RD_OP_SYNC) ||
+		     (rptr->rd_op == RD_OP_DEL) ) {
+			break;
 		}
-		msg.rd_blk = htonl(blk);
-		memcpy(msg.rd_data, rptr->rd_callbuf, RD_BLKSIZ);
+		if (rptr->rd_blknum == blk) {
 
-		/* Check request queue for subsequent writes of blk */
+			/* The first request for blk decides: the same	*/
+			/*   operation merges, a different one must be	*/
+			/*   sent first					*/
 
-		tptr = rptr->rd_next;
-		while (tptr != (struct rdqnode *)NULL) {
-			if ( (tptr->rd_blknum == blk) &&
-			     (tptr->rd_op == RD_OP_WRITE) ) {
-				break;
+			if (rptr->rd_op == op) {
+				return rptr;
+			}
+			break;
+		}
+	}
+	return (struct rdqnode *)NULL;
+}
+
+/*------------------------------------------------------------------------
+ * rdsaddreq  -  Move a queued request into an outstanding entry as the
+ *		   next block of its run
+ *------------------------------------------------------------------------
+ */
+local	void	rdsaddreq (
+	  struct rdscblk    *rdptr,	/* Ptr to device control block	*/
+	  struct rdpent	    *pptr,	/* Outstanding entry		*/
+	  struct rdqnode    *rptr	/* Queued request to add	*/
+	)
+{
+	struct	rdqnode	*tptr;		/* Temp pointer to a node in	*/
+					/*    the request queue		*/
+	char	*data;			/* Where the block's data goes	*/
+	uint32	blk;			/* Block number in the request	*/
+
+	blk = rptr->rd_blknum;
+	if (rptr->rd_op != RD_OP_WRITE) {
+
+		/* Reads and deletes wait for the reply; keep the node	*/
+		/*   on the entry's list, in block order		*/
+
+		rdqremove(rdptr, rptr);
+		rptr->rd_next = (struct rdqnode *)NULL;
+		if (pptr->rd_reqs == (struct rdqnode *)NULL) {
+			pptr->rd_reqs = rptr;
+		} else {
+			for (tptr = pptr->rd_reqs;
+			     tptr->rd_next != (struct rdqnode *)NULL;
+			     tptr = tptr->rd_next) {
+				;
 			}
-				
+			tptr->rd_next = rptr;
 		}
-		if (tptr == (struct rdqnode *)NULL) {
-			/* No subsequent writes, so add to cache */
-			rdcinsert(rdptr, blk, msg.rd_data);
+		if (rptr->rd_op == RD_OP_READ) {
+			pptr->rd_nblks++;
 		}
+		return;
+	}
+
+	/* Keep a copy of the data for retransmission */
+
+	data = pptr->rd_data + pptr->rd_nblks * RD_BLKSIZ;
+	memcpy(data, rptr->rd_callbuf, RD_BLKSIZ);
+	pptr->rd_nblks++;
 
-		/* Resume the process (comm. pocess continues to run) */
+	/* Check request queue for subsequent writes of blk */
 
+	tptr = rptr->rd_next;
+	while (tptr != (struct rdqnode *)NULL) {
+		if ( (tptr->rd_blknum == blk) &&
+		     (tptr->rd_op == RD_OP_WRITE) ) {
+			break;
+		}
+		tptr = tptr->rd_next;
+	}
+	if (tptr == (struct rdqnode *)NULL) {
+		/* No subsequent writes, so add to cache */
+		rdcinsert(rdptr, blk, data);
+	}
+
+	/* The writer need not wait for the reply (for an asynchronous	*/
+	/*   request, the block is complete once its data is copied)	*/
+
+	if (rptr->rd_pid != -1) {
 		resume(rptr->rd_pid);
+	}
+	if (rptr->rd_bio != (struct bioreq *)NULL) {
+		biodone(rptr->rd_bio, 1, OK);
+		signal(rdptr->rd_biosem);
+	}
+	rdqunlink(rdptr, rptr);
+	return;
+}
 
-		/* Unlink the node from the request queue */
+/*------------------------------------------------------------------------
+ * rdsflush  -  Send write requests for dirty cache blocks, oldest first,
+ *		  while the window has room (all dirty blocks if force is
+ *		  TRUE, otherwise only those older than RD_WBDELAY); dirty
+ *		  blocks adjacent to the chosen one go in the same request
+ *		  (the caller sends the requests with rdsxmitpend)
+ *------------------------------------------------------------------------
+ */
+local	void	rdsflush (
+	  struct rdscblk    *rdptr,	/* Ptr to device control block	*/
+	  bool8		    force	/* Ignore the age of a block?	*/
+	)
+{
+	struct	rdcnode	*cptr;		/* Walks the cache from the LRU	*/
+					/*   end toward the MRU end	*/
+	struct	rdcnode	*nptr;		/* Node for an adjacent block	*/
+	struct	rdpent	*pptr;		/* Ptr to an outstanding entry	*/
+	uint32	first;			/* First block of the run	*/
+	int32	n;			/* Blocks in the run		*/
+	int32	i;			/* Index of a block in the run	*/
+
+	for (cptr = rdptr->rd_ctail; cptr != (struct rdcnode *)NULL;
+						cptr = cptr->rd_prev) {
+		if (rdptr->rd_npend >= RD_WINDOW) {
+			return;
+		}
+		if (!cptr->rd_dirty) {
+			continue;
+		}
+		if ( !force && (ctr1000 - cptr->rd_dtime < RD_WBDELAY) ) {
+			continue;
+		}
 
-		rptr = rdqunlink(rdptr, rptr);
+		/* An earlier write of the block must finish first */
 
-		/* Send the message and receive a response */
+		if (rdsconflict(rdptr, RD_OP_WRITE, cptr->rd_blknum)) {
+			continue;
+		}
 
-		retval = rdscomm((struct rd_msg_hdr *)&msg,
-					sizeof(struct rd_msg_wreq),
-				 (struct rd_msg_hdr *)&resp,
-					sizeof(struct rd_msg_wres),
-				  rdptr );
+		/* Extend the run to dirty blocks below and above */
 
-		/* Check the response */
+		first = cptr->rd_blknum;
+		n = 1;
+		while ( (n < RD_MAXBLKS) && (first > 0) ) {
+			nptr = rdclookup(rdptr, first - 1);
+			if ( (nptr == (struct rdcnode *)NULL) ||
+			     !nptr->rd_dirty ||
+			     rdsconflict(rdptr, RD_OP_WRITE, first - 1) ) {
+				break;
+			}
+			first--;
+			n++;
+		}
+		while (n < RD_MAXBLKS) {
+			nptr = rdclookup(rdptr, first + n);
+			if ( (nptr == (struct rdcnode *)NULL) ||
+			     !nptr->rd_dirty ||
+			     rdsconflict(rdptr, RD_OP_WRITE, first + n) ) {
+				break;
+			}
+			n++;
+		}
 
-		if ( (retval == SYSERR) || (retval == TIMEOUT) ||
-				(ntohs(resp.rd_status) != 0) ) {
-			panic("remote disk access failed");
+		/* Copy the blocks into the entry; each becomes clean	*/
+		/*   now, since the entry is retransmitted until the	*/
+		/*   write is acknowledged or fails			*/
+
+		pptr = rdspent(rdptr, RD_OP_WRITE, first);
+		for (i=0; i<n; i++) {
+			nptr = rdclookup(rdptr, first + i);
+			memcpy(pptr->rd_data + i*RD_BLKSIZ, nptr->rd_data,
+							RD_BLKSIZ);
+			nptr->rd_dirty = FALSE;
+			rdptr->rd_ndirty--;
+			rdptr->rd_cwbacks++;
 		}
-		break;
+		pptr->rd_nblks = n;
+		pptr->rd_xmit = TRUE;
+	}
+	return;
+}
+
+/*------------------------------------------------------------------------
+ * rdspent  -  Allocate and initialize a free entry in the table of
+ *		 outstanding requests (the caller has checked that
+ *		 rd_npend < RD_WINDOW)
+ *------------------------------------------------------------------------
+ */
+local	struct	rdpent	*rdspent (
+	  struct rdscblk    *rdptr,	/* Ptr to device control block	*/
+	  int32		    op,		/* Operation for the entry	*/
+	  uint32	    blk		/* First block of the entry	*/
+	)
+{
+	struct	rdpent	*pptr;		/* Ptr to an outstanding entry	*/
+	int32	i;			/* Index into outstanding table	*/
 
-	   default:
-		break;/* SHould never happen */
-	   }
+	for (i=0; i<RD_WINDOW-1; i++) {
+		if (rdptr->rd_pent[i].rd_op == RD_OP_NONE) {
+			break;
+		}
 	}
+	pptr = &rdptr->rd_pent[i];
+	pptr->rd_op = op;
+	pptr->rd_seq = rdptr->rd_seq++;
+	pptr->rd_blknum = blk;
+	pptr->rd_nblks = 0;
+	pptr->rd_reqs = (struct rdqnode *)NULL;
+	pptr->rd_xmit = FALSE;
+	pptr->rd_sent = ctr1000;
+	pptr->rd_tries = 0;
+	rdptr->rd_npend++;
+	return pptr;
 }
@@ -1,48 +1,50 @@
-/* rdsqfcns.c - rdqunlink, rdcunlink, rdcinsert, rdqdump, rdcdump */
+/* rdsqfcns.c - rdqremove, rdqunlink, rdqinsert, rdclookup, rdcremove,	*/
+/*		rdcunlink, rdcmru, rdcalloc, rdcinsert, rdqdump,	*/
+/*		rdcdump							*/
 
 #include <xinu.h>
 
 
 /*------------------------------------------------------------------------
- * rdqunlink  -  unlink a node from the request queue, place the node on
- *		the free list,  and return the address of the next node
- *		on the request queue (or NULL, if unlinking the tail)
+ * rdqremove  -  remove a node from the request queue without freeing it
+ *		and return the address of the next node on the request
+ *		queue (or NULL, if removing the tail)
  *------------------------------------------------------------------------
  */
-struct rdqnode * rdqunlink (struct rdscblk *rdptr, struct rdqnode *rptr) {
+struct rdqnode * rdqremove (struct rdscblk *rdptr, struct rdqnode *rptr) {
 
 	struct rdqnode *nptr;		/* Pointer to next node		*/
 	struct rdqnode *pptr;		/* Pointer to previous node	*/
 
 	nptr = rptr->rd_next;		/* Point to next node or NULL	*/
+	pptr = rptr->rd_prev;		/* Point to prev node or NULL	*/
 
-	/* Handle unlinking the head of the request queue */
-
-	if (rptr == rdptr->rd_qhead) {
-		/* See if queue contains multiple nodes */
-		if (rptr == rdptr->rd_qtail) {
-			/* This is the only node on the queue */
-			rdptr->rd_qhead = rdptr->rd_qtail =
-				(struct rdqnode *)NULL;
-		} else {
-			/* The queue contains other nodes */
-			rdptr->rd_qhead = nptr;
-		}
+	if (pptr == (struct rdqnode *)NULL) {
+		rdptr->rd_qhead = nptr;
+	} else {
+		pptr->rd_next = nptr;
+	}
+	if (nptr == (struct rdqnode *)NULL) {
+		rdptr->rd_qtail = pptr;
+	} else {
+		nptr->rd_prev = pptr;
+	}
+	return nptr;
+}
 
-	/* Handle unlinking the tail of the request queue */
 
-	} else if (rptr == rdptr->rd_qtail) {
-		pptr = rptr->rd_prev;
-		rdptr->rd_qtail = pptr;
-		pptr->rd_next = (struct rdqnode *)NULL;
+/*------------------------------------------------------------------------
+ * rdqunlink  -  unlink a node from the request queue, place the node on
+ *		the free list,  and return the address of the next node
+ *		on the request queue (or NULL, if unlinking the tail)
+ *------------------------------------------------------------------------
+ */
+struct rdqnode * rdqunlink (struct rdscblk *rdptr, struct rdqnode *rptr) {
 
-	/* Handle unlinking a node in the middle of the queue */
+	struct rdqnode *nptr;		/* Pointer to next node		*/
+
+	nptr = rdqremove(rdptr, rptr);
 
-	} else {		
-		pptr = rptr->rd_prev;
-		pptr->rd_next = nptr;
-		nptr->rd_prev = pptr;
-	}
 	/* Add the unlinked node to free list */
 	rptr->rd_next = rdptr->rd_qfree;
 	rdptr->rd_qfree = rptr;
@@ -74,107 +76,186 @@ void rdqinsert (
 
 
 /*------------------------------------------------------------------------
- * rdcunlink  -  unlink a node from the cache and place the node on the
- *		free list.
+ * rdclookup  -  find the cache node for a block (NULL if not cached)
  *------------------------------------------------------------------------
  */
-void	rdcunlink (
-	struct rdscblk *rdptr,		/* Remode disk control block	*/
-	struct rdcnode *cptr		/* Node to unlink		*/
+struct rdcnode * rdclookup (
+	struct rdscblk *rdptr,		/* Remote disk control block	*/
+	uint32 blk			/* Block number to find		*/
 ) {
-	struct rdcnode *nptr;		/* Pointer to next node		*/
-	struct rdcnode *pptr;		/* Pointer to previous node	*/
+	struct rdcnode *cptr;		/* Walks a hash chain		*/
 
-	nptr = cptr->rd_next;		/* Point to next node or NULL	*/
-
-	/* Handle unlinking the head of the cache */
-
-	if (cptr == rdptr->rd_chead) {
-		/* See if queue contains multiple nodes */
-		if (cptr == rdptr->rd_ctail) {
-			/* This is the only node in the queue */
-			rdptr->rd_chead = rdptr->rd_ctail =
-				(struct rdcnode *)NULL;
-		} else {
-			/* The cache contains other nodes */
-			rdptr->rd_chead = nptr;
-			nptr->rd_prev = (struct rdcnode *)NULL;
+	if (rdptr->rd_csize == 0) {
+		return (struct rdcnode *)NULL;
+	}
+	cptr = rdptr->rd_chash[rdchash(rdptr, blk)];
+	while (cptr != (struct rdcnode *)NULL) {
+		if (cptr->rd_blknum == blk) {
+			return cptr;
 		}
+		cptr = cptr->rd_hnext;
+	}
+	return (struct rdcnode *)NULL;
+}
+
 
-	/* Handle unlinking the tail of the cache */
+/*------------------------------------------------------------------------
+ * rdcremove  -  remove a node from the LRU list and its hash chain
+ *		 (the node is not placed on the free list)
+ *------------------------------------------------------------------------
+ */
+local void rdcremove (
+	struct rdscblk *rdptr,		/* Remote disk control block	*/
+	struct rdcnode *cptr		/* Node to remove		*/
+) {
+	struct rdcnode **hpp;		/* Walks the hash chain		*/
 
-	} else if (cptr == rdptr->rd_ctail) {
-		pptr = cptr->rd_prev;
-		rdptr->rd_ctail = pptr;
-		pptr->rd_next = (struct rdcnode *)NULL;
+	if (cptr->rd_prev == (struct rdcnode *)NULL) {
+		rdptr->rd_chead = cptr->rd_next;
+	} else {
+		cptr->rd_prev->rd_next = cptr->rd_next;
+	}
+	if (cptr->rd_next == (struct rdcnode *)NULL) {
+		rdptr->rd_ctail = cptr->rd_prev;
+	} else {
+		cptr->rd_next->rd_prev = cptr->rd_prev;
+	}
 
-	/* Handle unlinking a node in the middle of the queue */
+	hpp = &rdptr->rd_chash[rdchash(rdptr, cptr->rd_blknum)];
+	while (*hpp != cptr) {
+		hpp = &(*hpp)->rd_hnext;
+	}
+	*hpp = cptr->rd_hnext;
 
-	} else {		
-		pptr = cptr->rd_prev;
-		pptr->rd_next = nptr;
-		nptr->rd_prev = pptr;
+	if (cptr->rd_dirty) {
+		cptr->rd_dirty = FALSE;
+		rdptr->rd_ndirty--;
 	}
-	/* Add the unlinked node to free list */
+	return;
+}
+
+
+/*------------------------------------------------------------------------
+ * rdcunlink  -  unlink a node from the cache and place the node on the
+ *		free list (dirty contents are discarded)
+ *------------------------------------------------------------------------
+ */
+void	rdcunlink (
+	struct rdscblk *rdptr,		/* Remode disk control block	*/
+	struct rdcnode *cptr		/* Node to unlink		*/
+) {
+	rdcremove(rdptr, cptr);
 	cptr->rd_next = rdptr->rd_cfree;
 	rdptr->rd_cfree = cptr;
 	return;
 }
 
+
 /*------------------------------------------------------------------------
- * rdcinsert  -  insert a node in the cache for a specified block and
- *		 contents of the block
+ * rdcmru  -  make a node the most recently used one in the cache
  *------------------------------------------------------------------------
  */
-void rdcinsert (struct rdscblk *rdptr, uint32 blk, char *data) {
+void	rdcmru (
+	struct rdscblk *rdptr,		/* Remode disk control block	*/
+	struct rdcnode *cptr		/* Node that was just used	*/
+) {
+	if (cptr == rdptr->rd_chead) {
+		return;
+	}
 
-	struct	rdcnode	*cptr;		/* Pointer to a cache node	*/
-	struct	rdcnode	*tptr;		/* Additional cache node pointer*/
+	/* Unlink from the LRU list (the node is not the head) */
 
-	if (RD_CNODES == 0) {
-		/* No cache is being used */
-		return;
+	cptr->rd_prev->rd_next = cptr->rd_next;
+	if (cptr->rd_next == (struct rdcnode *)NULL) {
+		rdptr->rd_ctail = cptr->rd_prev;
+	} else {
+		cptr->rd_next->rd_prev = cptr->rd_prev;
 	}
 
-	/* Allocate a node from the free list, if available */
+	/* Link at the head */
+
+	cptr->rd_prev = (struct rdcnode *)NULL;
+	cptr->rd_next = rdptr->rd_chead;
+	rdptr->rd_chead->rd_prev = cptr;
+	rdptr->rd_chead = cptr;
+	return;
+}
+
+
+/*------------------------------------------------------------------------
+ * rdcalloc  -  allocate a clean cache node for a block that is not in
+ *		the cache, reusing the least recently used clean node if
+ *		the free list is empty; return NULL if every node is dirty
+ *------------------------------------------------------------------------
+ */
+struct rdcnode * rdcalloc (
+	struct rdscblk *rdptr,		/* Remote disk control block	*/
+	uint32 blk			/* Block the node will hold	*/
+) {
+	struct	rdcnode	*cptr;		/* Pointer to a cache node	*/
+	struct	rdcnode	**hpp;		/* Head of the hash chain	*/
 
 	cptr = rdptr->rd_cfree;
 	if (cptr != (struct rdcnode *)NULL) {
 		/* Unlink from the free list */
 		rdptr->rd_cfree = cptr->rd_next;
 	} else {
-		/* Use the tail of the cache list */
+		/* Evict the least recently used clean node */
 		cptr = rdptr->rd_ctail;
-		if (rdptr->rd_chead == rdptr->rd_ctail) {
-			/* Exactly one node in the cache, so unlink it */
-			rdptr->rd_chead = rdptr->rd_ctail =
-				(struct rdcnode *)NULL;
-		} else {
-			/* More than one node in the cache */
-			tptr = cptr->rd_prev;
-			tptr->rd_next = (struct rdcnode *)NULL;
-			rdptr->rd_ctail = tptr;
+		while ( (cptr != (struct rdcnode *)NULL) && cptr->rd_dirty ) {
+			cptr = cptr->rd_prev;
+		}
+		if (cptr == (struct rdcnode *)NULL) {
+			return (struct rdcnode *)NULL;
 		}
+		rdcremove(rdptr, cptr);
 	}
 
-	/* Fill in block number and data */
-
 	cptr->rd_blknum = blk;
-	memcpy(cptr->rd_data, data, RD_BLKSIZ);
+	cptr->rd_dirty = FALSE;
+	cptr->rd_ra = FALSE;
+
+	/* Add the node to its hash chain and the head of the cache */
 
-	/* Add the node to head of the cache */
+	hpp = &rdptr->rd_chash[rdchash(rdptr, blk)];
+	cptr->rd_hnext = *hpp;
+	*hpp = cptr;
 
-	tptr = rdptr->rd_chead;
-	cptr->rd_next = tptr;
 	cptr->rd_prev = (struct rdcnode *)NULL;
-	rdptr->rd_chead = cptr;
-	if (tptr == (struct rdcnode *)NULL) {
-		/* Insert in an empty cache */
-		rdptr->rd_chead = rdptr->rd_ctail = cptr;
+	cptr->rd_next = rdptr->rd_chead;
+	if (rdptr->rd_chead == (struct rdcnode *)NULL) {
+		rdptr->rd_ctail = cptr;
 	} else {
-		tptr->rd_prev = cptr;
+		rdptr->rd_chead->rd_prev = cptr;
 	}
-	return;
+	rdptr->rd_chead = cptr;
+	return cptr;
+}
+
+
+/*------------------------------------------------------------------------
+ * rdcinsert  -  insert a clean copy of a block in the cache, unless the
+ *		 cache already holds the block (the cached copy is then
+ *		 at least as recent) or no clean node can be reused, and
+ *		 return the new node (NULL if the block was not inserted)
+ *------------------------------------------------------------------------
+ */
+struct rdcnode * rdcinsert (struct rdscblk *rdptr, uint32 blk, char *data) {
+
+	struct	rdcnode	*cptr;		/* Pointer to a cache node	*/
+
+	if (rdptr->rd_csize == 0) {
+		/* No cache is being used */
+		return (struct rdcnode *)NULL;
+	}
+	if (rdclookup(rdptr, blk) != (struct rdcnode *)NULL) {
+		return (struct rdcnode *)NULL;
+	}
+	cptr = rdcalloc(rdptr, blk);
+	if (cptr != (struct rdcnode *)NULL) {
+		memcpy(cptr->rd_data, data, RD_BLKSIZ);
+	}
+	return cptr;
 }
 
 
@@ -270,7 +351,8 @@ void edcdump (
 	n = 0;
 	while (cptr != (struct rdcnode *)NULL) {
 		n++;
-		kprintf("\nNode %2d    blk%4d\n", n, cptr->rd_blknum);
+		kprintf("\nNode %2d    blk%4d%s\n", n, cptr->rd_blknum,
+			cptr->rd_dirty ? "  (dirty)" : "");
 		for (i = 0; i < RD_BLKSIZ; i++) {
 			ch = 0xff & cptr->rd_data[i];
 			if ( (ch >= 'a' && ch <= 'z') ||
@@ -1,7 +1,9 @@
-/* rdsread.c - rdsread */
+/* rdsread.c - rdsread, rdsrlocal, rdsreadahead */
 
 #include <xinu.h>
 
+local	void	rdsreadahead(struct rdscblk *, uint32);
+
 /*------------------------------------------------------------------------
  * rdsread  -  Read a block from a remote disk
  *------------------------------------------------------------------------
@@ -14,17 +16,17 @@ devcall	rdsread (
 {
 	struct	rdscblk	*rdptr;		/* Pointer to the control block	*/
 					/*   for the disk device	*/
-	struct	rdqnode	*rptr;		/* Pointer that walks the	*/
-					/*   request queue		*/
-	struct	rdqnode	*tptr;		/* Pointer to tail node on the	*/
-					/*   request queue		*/
-	struct	rdcnode	*cptr;		/* Pointer that walks the cache	*/
+	struct	rdqnode	*rptr;		/* Pointer to a request node	*/
+	intmask	mask;			/* Saved interrupt mask		*/
+	status	retval;			/* Outcome of the request	*/
 	pri16	myprio;			/* Temp storage for my priority	*/
 
 	/* If the device not currently open, report an error */
 
+	mask = disable();
 	rdptr = &rdstab[devptr->dvminor];
 	if (rdptr->rd_state != RD_OPEN) {
+		restore(mask);
 		return SYSERR;
 	}
 
@@ -35,16 +37,83 @@ devcall	rdsread (
 		resume(rdptr->rd_comproc);
 	}
 
+	/* Use a copy of the block held locally, if there is one */
+
+	if (rdsrlocal(rdptr, buff, blk)) {
+		rdsreadahead(rdptr, blk);
+		restore(mask);
+		return RD_BLKSIZ;
+	}
+
+	/* The block must be fetched from the server */
+
+	rdptr->rd_cmisses++;
+
+	/* Allocate a request node and fill in a read request */
+
+	rptr = rdptr->rd_qfree;
+	rdptr->rd_qfree = rptr->rd_next;
+	rptr->rd_op = RD_OP_READ;
+	rptr->rd_blknum = blk;
+	rptr->rd_callbuf = buff;
+	rptr->rd_statp = &retval;
+	rptr->rd_pid = getpid();
+	rptr->rd_bio = (struct bioreq *)NULL;
+
+	/* Insert the new request at the tail of the queue */
+
+	rdqinsert(rdptr, rptr);
+
+	/* Atomically signal the comm. process semaphore and suspend	*/
+	/*   the current process by temporarily setting the process	*/
+	/*   prirority to the highest possible value, performing the	*/
+	/*   two actions, and then resetting the priority to its	*/
+	/*   original value when the process is awakened		*/
+
+	myprio = 0xffff & rdssetprio(MAXPRIO);
+	rdsreadahead(rdptr, blk);
+	signal(rdptr->rd_comsem);
+	suspend(getpid());
+	rdssetprio(myprio);
+	restore(mask);
+	if (retval != OK) {
+		return SYSERR;
+	}
+	return RD_BLKSIZ;
+}
+
+/*------------------------------------------------------------------------
+ * rdsrlocal  -  Copy a block into a buffer without asking the server if
+ *		   the block is cached, queued to be written, or part of
+ *		   a write outstanding at the server (returns TRUE if the
+ *		   block was copied; called with interrupts disabled)
+ *------------------------------------------------------------------------
+ */
+bool8	rdsrlocal (
+	  struct rdscblk    *rdptr,	/* Ptr to device control block	*/
+	  char		    *buff,	/* Buffer to hold disk block	*/
+	  uint32	    blk		/* Block number of block to read*/
+	)
+{
+	struct	rdqnode	*rptr;		/* Pointer that walks the	*/
+					/*   request queue		*/
+	struct	rdcnode	*cptr;		/* Pointer that walks the cache	*/
+	struct	rdpent	*pptr;		/* Pointer to outstanding entry	*/
+	int32	i;			/* Index into outstanding table	*/
+
 	/* Search the cache for the specified block */
 
-	cptr = rdptr->rd_chead;
-	while (cptr != (struct rdcnode *)NULL) {
-		if (cptr->rd_blknum == blk) {
-			/* Satisfu the request */
-			memcpy(buff, cptr->rd_data, RD_BLKSIZ);
-			return RD_BLKSIZ;
+	cptr = rdclookup(rdptr, blk);
+	if (cptr != (struct rdcnode *)NULL) {
+		/* Satisfy the request */
+		memcpy(buff, cptr->rd_data, RD_BLKSIZ);
+		rdcmru(rdptr, cptr);
+		rdptr->rd_chits++;
+		if (cptr->rd_ra) {
+			cptr->rd_ra = FALSE;
+			rdptr->rd_rahits++;
 		}
-		cptr = cptr->rd_next;
+		return TRUE;
 	}
 
 	/* Search backward in the request queue for the most recent	*/
@@ -63,46 +132,140 @@ devcall	rdsread (
 		if (rptr->rd_op == RD_OP_WRITE) {
 			/* Satisfy the reqeust */
 			memcpy(buff, rptr->rd_callbuf, RD_BLKSIZ);
-			return RD_BLKSIZ;
+			return TRUE;
 		} else {
 			/* Read request */
 			break;
 		}
 	}
 
-	/* Allocate a request node and fill in a read request */
+	/* If no request is queued for the block, a write of the block	*/
+	/*   may be outstanding at the server				*/
 
-	rptr = rdptr->rd_qfree;
-	rdptr->rd_qfree = rptr->rd_next;
-	rptr->rd_op = RD_OP_READ;
-	rptr->rd_blknum = blk;
-	rptr->rd_callbuf = buff;
-	rptr->rd_pid = getpid();
+	if (rptr == (struct rdqnode *)NULL) {
+		for (i=0; i<RD_WINDOW; i++) {
+			pptr = &rdptr->rd_pent[i];
+			if ( (pptr->rd_op == RD_OP_WRITE) &&
+			     rdpholds(pptr, blk) ) {
+				memcpy(buff, pptr->rd_data +
+				    (blk - pptr->rd_blknum) * RD_BLKSIZ,
+				    RD_BLKSIZ);
+				return TRUE;
+			}
+		}
+	}
+	return FALSE;
+}
 
-	/* Insert the new request at the tail of the queue */
+/*------------------------------------------------------------------------
+ * rdsreadahead  -  Track the sequential stream of the calling process
+ *		    and queue readahead requests for the blocks that
+ *		    follow blk (the window doubles on each sequential read
+ *		    up to RD_RAMAX and collapses on a random read)
+ *------------------------------------------------------------------------
+ */
+local	void	rdsreadahead (
+	  struct rdscblk    *rdptr,	/* Ptr to device control block	*/
+	  uint32	    blk		/* Block just read		*/
+	)
+{
+	struct	rdstream *sptr;		/* Stream of the caller		*/
+	struct	rdstream *optr;		/* Least recently used stream	*/
+	struct	rdqnode	*rptr;		/* Walks the request queue	*/
+	struct	rdpent	*pptr;		/* Ptr to an outstanding entry	*/
+	pid32	pid;			/* ID of the calling process	*/
+	uint32	b;			/* Block to read ahead		*/
+	int32	i;			/* Index into a table		*/
+
+	/* Find the caller's stream, or reuse the least recently used	*/
+
+	pid = getpid();
+	sptr = optr = &rdptr->rd_stream[0];
+	for (i=0; i<RD_NSTREAM; i++) {
+		sptr = &rdptr->rd_stream[i];
+		if (sptr->rd_spid == pid) {
+			break;
+		}
+		if (sptr->rd_sused < optr->rd_sused) {
+			optr = sptr;
+		}
+	}
+	if (i >= RD_NSTREAM) {
+		sptr = optr;
+		sptr->rd_spid = pid;
+		sptr->rd_snext = blk + 1;	/* Not yet sequential	*/
+		sptr->rd_swin = 0;
+	}
+	sptr->rd_sused = ++rdptr->rd_sclock;
+
+	/* Grow the window on a sequential read, collapse it otherwise	*/
 
-	if (rdptr->rd_qhead == (struct rdqnode *)NULL) {
-		/* Request queue is empty */
-		rdptr->rd_qhead = rdptr->rd_qtail = rptr;
-		rptr->rd_next = rptr->rd_prev =
-			(struct rdqnode *)NULL;
+	if (blk == sptr->rd_snext) {
+		if (sptr->rd_swin == 0) {
+			sptr->rd_swin = RD_RAMIN;
+		} else if (sptr->rd_swin < RD_RAMAX) {
+			sptr->rd_swin *= 2;
+			if (sptr->rd_swin > RD_RAMAX) {
+				sptr->rd_swin = RD_RAMAX;
+			}
+		}
 	} else {
-		tptr = rdptr->rd_qtail;
-		tptr->rd_next = rptr;
-		rptr->rd_prev = tptr;
-		rptr->rd_next = (struct rdqnode *)NULL;
-		rdptr->rd_qtail = rptr;
+		sptr->rd_swin = 0;
+		sptr->rd_sranext = blk + 1;
+	}
+	sptr->rd_snext = blk + 1;
+	if (sptr->rd_sranext < blk + 1) {
+		sptr->rd_sranext = blk + 1;
 	}
 
-	/* Atomically signal the comm. process semaphore and suspend	*/
-	/*   the current process by temporarily setting the process	*/
-	/*   prirority to the highest possible value, performing the	*/
-	/*   two actions, and then resetting the priority to its	*/
-	/*   original value when the process is awakened		*/
+	/* Queue reads for blocks in the window that are not cached,	*/
+	/*   queued, or outstanding					*/
 
-	myprio = 0xffff & rdssetprio(MAXPRIO);
-	signal(rdptr->rd_comsem);
-	suspend(getpid());
-	rdssetprio(myprio);
-	return RD_BLKSIZ;
+	while ( (sptr->rd_swin > 0) &&
+		(sptr->rd_sranext <= blk + sptr->rd_swin) &&
+		(rdptr->rd_nra < RD_RAMAX) ) {
+		b = sptr->rd_sranext++;
+		if (rdclookup(rdptr, b) != (struct rdcnode *)NULL) {
+			continue;
+		}
+		for (rptr = rdptr->rd_qhead; rptr != (struct rdqnode *)NULL;
+						rptr = rptr->rd_next) {
+			if ( (rptr->rd_blknum == b) &&
+			     ( (rptr->rd_op == RD_OP_READ) ||
+			       (rptr->rd_op == RD_OP_WRITE) ) ) {
+				break;
+			}
+		}
+		if (rptr != (struct rdqnode *)NULL) {
+			continue;
+		}
+		for (i=0; i<RD_WINDOW; i++) {
+			pptr = &rdptr->rd_pent[i];
+			if ( ( (pptr->rd_op == RD_OP_READ) ||
+			       (pptr->rd_op == RD_OP_WRITE) ) &&
+			     rdpholds(pptr, b) ) {
+				break;
+			}
+		}
+		if (i < RD_WINDOW) {
+			continue;
+		}
+
+		/* Queue a read that no process waits for; the reply	*/
+		/*   only fills the cache				*/
+
+		rptr = rdptr->rd_qfree;
+		rdptr->rd_qfree = rptr->rd_next;
+		rptr->rd_op = RD_OP_READ;
+		rptr->rd_blknum = b;
+		rptr->rd_callbuf = NULL;
+		rptr->rd_statp = NULL;
+		rptr->rd_pid = -1;
+		rptr->rd_bio = (struct bioreq *)NULL;
+		rdqinsert(rdptr, rptr);
+		rdptr->rd_nra++;
+		rdptr->rd_raissued++;
+		signal(rdptr->rd_comsem);
+	}
+	return;
 }
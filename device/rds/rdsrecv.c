@@ -0,0 +1,307 @@
+/* rdsrecv.c - rdsrecv, rdsdone, rdsblkdone */
+
+#include <xinu.h>
+
+local	void	rdsdone(struct rdscblk *, struct rdpent *, char *, status);
+local	void	rdsblkdone(struct rdscblk *, struct rdqnode *, char *,
+				status);
+
+/*------------------------------------------------------------------------
+ * rdsrecv  -  Background process that receives replies from the remote
+ *		 disk server, matches each reply to an outstanding
+ *		 request by sequence number, completes the request, and
+ *		 retransmits requests for which a reply is overdue
+ *------------------------------------------------------------------------
+ */
+process	rdsrecv (
+	  struct rdscblk    *rdptr	/* Ptr to device control block	*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	struct	rd_msg_mrres resp;	/* Buffer to hold a reply (a	*/
+					/*   multi-block read reply is	*/
+					/*   largest)			*/
+	int32	retval;			/* Return value from udp_recv	*/
+	uint32	seq;			/* Sequence number in a reply	*/
+	uint16	rtype;			/* Expected reply type		*/
+	char	*data;			/* Data in a read reply		*/
+	int32	minlen;			/* Length of a complete reply	*/
+	struct	rdpent	*pptr;		/* Walks the outstanding table	*/
+	int32	i;			/* Index into outstanding table	*/
+
+	while (TRUE) {			/* Do forever */
+
+	    retval = udp_recv(rdptr->rd_udpslot, (char *)&resp,
+					sizeof(resp), RD_TICK);
+
+	    mask = disable();
+	    resched_cntl(DEFER_START);
+
+	    /* Match a reply against the outstanding requests (a reply	*/
+	    /*   that matches nothing is a duplicate and is ignored)	*/
+
+	    if (retval >= (int32)sizeof(struct rd_msg_hdr)) {
+		seq = ntohl(resp.rd_seq);
+		for (i=0; i<RD_WINDOW; i++) {
+		    pptr = &rdptr->rd_pent[i];
+		    if ( (pptr->rd_op == RD_OP_NONE) ||
+			 (pptr->rd_seq != seq) ) {
+			continue;
+		    }
+		    data = NULL;
+		    minlen = sizeof(struct rd_msg_hdr);
+		    switch (pptr->rd_op) {
+		    case RD_OP_READ:
+			if (pptr->rd_nblks > 1) {
+				rtype = RD_MSG_MRRES;
+				data = resp.rd_data;
+			} else {
+				rtype = RD_MSG_RRES;
+				data = ((struct rd_msg_rres *)&resp)->rd_data;
+			}
+			minlen = (data - (char *)&resp) +
+					pptr->rd_nblks * RD_BLKSIZ;
+			break;
+		    case RD_OP_WRITE:
+			rtype = (pptr->rd_nblks > 1) ? RD_MSG_MWRES :
+							RD_MSG_WRES;
+			break;
+		    default:
+			rtype = RD_MSG_DRES;
+			break;
+		    }
+		    if (ntohs(resp.rd_type) != rtype) {
+			break;
+		    }
+		    if (ntohs(resp.rd_status) != 0) {
+			rdsdone(rdptr, pptr, NULL, SYSERR);
+		    } else if (retval >= minlen) {
+			rdsdone(rdptr, pptr, data, OK);
+		    }
+		    break;
+		}
+	    }
+
+	    /* Mark each request whose reply is overdue for		*/
+	    /*   retransmission, and fail a request after RD_RETRIES	*/
+	    /*   transmissions						*/
+
+	    for (i=0; i<RD_WINDOW; i++) {
+		pptr = &rdptr->rd_pent[i];
+		if ( (pptr->rd_op == RD_OP_NONE) || pptr->rd_xmit ||
+		     (ctr1000 - pptr->rd_sent < RD_TIMEOUT) ) {
+			continue;
+		}
+		if (pptr->rd_tries >= RD_RETRIES) {
+			kprintf("Timeout on exchange with remote disk "
+				"server\n\r");
+			rdsdone(rdptr, pptr, NULL, TIMEOUT);
+			continue;
+		}
+		rdptr->rd_retrans++;
+		pptr->rd_xmit = TRUE;
+	    }
+
+	    /* Let the communication process write back dirty blocks	*/
+	    /*   that have aged						*/
+
+	    if ( (rdptr->rd_ndirty > 0) &&
+		 (semcount(rdptr->rd_comsem) <= 0) ) {
+		signal(rdptr->rd_comsem);
+	    }
+
+	    resched_cntl(DEFER_STOP);
+	    restore(mask);
+
+	    /* Retransmit outside the deferral, because sending can block */
+
+	    rdsxmitpend(rdptr);
+	}
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ * rdsdone  -  Complete an outstanding request, free its entry, and
+ *		 allow the communication process to send another request
+ *		 (called with interrupts disabled)
+ *------------------------------------------------------------------------
+ */
+local	void	rdsdone (
+	  struct rdscblk    *rdptr,	/* Ptr to device control block	*/
+	  struct rdpent	    *pptr,	/* Request that has completed	*/
+	  char		    *data,	/* Blocks from a read reply	*/
+	  status	    stat	/* Outcome of the request	*/
+	)
+{
+	struct	rdqnode	*rptr;		/* Request waiting for reply	*/
+	struct	rdqnode	*nptr;		/* Next request on the list	*/
+	struct	rdcnode	*cptr;		/* Cache node for a block	*/
+	int32	i;			/* Index of a block in the run	*/
+
+	switch (pptr->rd_op) {
+
+	case RD_OP_READ:
+
+		/* Complete the read of each block in the run */
+
+		for (rptr = pptr->rd_reqs; rptr != (struct rdqnode *)NULL;
+							rptr = nptr) {
+			nptr = rptr->rd_next;
+			rdsblkdone(rdptr, rptr, (stat != OK) ? NULL :
+			    data + (rptr->rd_blknum - pptr->rd_blknum) *
+							RD_BLKSIZ, stat);
+		}
+		break;
+
+	case RD_OP_WRITE:
+
+		/* On failure, make each block of the run that is still	*/
+		/*   cached dirty again (unless a newer write already	*/
+		/*   did) so it is written back later, and record the	*/
+		/*   error for the next sync				*/
+
+		if (stat != OK) {
+			kprintf("rdsrecv: write of blocks %d-%d failed\n\r",
+				pptr->rd_blknum,
+				pptr->rd_blknum + pptr->rd_nblks - 1);
+			for (i=0; i<pptr->rd_nblks; i++) {
+				cptr = rdclookup(rdptr, pptr->rd_blknum + i);
+				if ( (cptr == (struct rdcnode *)NULL) ||
+				     cptr->rd_dirty ) {
+					continue;
+				}
+				memcpy(cptr->rd_data,
+					pptr->rd_data + i*RD_BLKSIZ, RD_BLKSIZ);
+				cptr->rd_dirty = TRUE;
+				cptr->rd_dtime = ctr1000;
+				rdptr->rd_ndirty++;
+				rdptr->rd_cwbacks--;
+			}
+			rdptr->rd_werr = TRUE;
+		}
+		break;
+
+	case RD_OP_DEL:
+
+		/* Report the outcome and resume the waiting process */
+
+		rptr = pptr->rd_reqs;
+		*rptr->rd_statp = stat;
+		resume(rptr->rd_pid);
+		rptr->rd_next = rdptr->rd_qfree;
+		rdptr->rd_qfree = rptr;
+		break;
+
+	default:
+		break;
+	}
+
+	pptr->rd_op = RD_OP_NONE;
+	pptr->rd_xmit = FALSE;
+	rdptr->rd_npend--;
+	signal(rdptr->rd_comsem);
+	return;
+}
+
+/*------------------------------------------------------------------------
+ * rdsblkdone  -  Complete the read of one block: give the data to the
+ *		    reader or asynchronous request (if any) and to later
+ *		    queued reads of the block, cache it, and free the
+ *		    request node
+ *------------------------------------------------------------------------
+ */
+local	void	rdsblkdone (
+	  struct rdscblk    *rdptr,	/* Ptr to device control block	*/
+	  struct rdqnode    *rptr,	/* Read request for the block	*/
+	  char		    *data,	/* Data for the block		*/
+	  status	    stat	/* Outcome of the read		*/
+	)
+{
+	struct	rdqnode	*qptr;		/* Walks the request queue	*/
+	struct	rdcnode	*cptr;		/* Cache node for the block	*/
+	uint32	blk;			/* Block number in the request	*/
+	bool8	used;			/* Did a queued read use it?	*/
+
+	blk = rptr->rd_blknum;
+	if (rptr->rd_callbuf == NULL) {
+		rdptr->rd_nra--;	/* Readahead has finished	*/
+	}
+
+	if (stat == OK) {
+		if (rptr->rd_callbuf != NULL) {
+			memcpy(rptr->rd_callbuf, data, RD_BLKSIZ);
+		}
+		used = FALSE;
+
+		/* Walk the request queue and satisfy subsequent	*/
+		/*    read requests for the same block			*/
+
+		qptr = rdptr->rd_qhead;
+		while (qptr != (struct rdqnode *)NULL) {
+		    if (qptr->rd_blknum != blk) {
+			qptr = qptr->rd_next;
+			continue;
+		    }
+		    if (qptr->rd_op == RD_OP_WRITE) {
+			/* Stop on a write for the block */
+			break;
+		    }
+		    if (qptr->rd_op == RD_OP_READ) {
+			if (qptr->rd_callbuf != NULL) {
+				memcpy(qptr->rd_callbuf, data, RD_BLKSIZ);
+				used = TRUE;
+			} else {
+				rdptr->rd_nra--;
+			}
+			if (qptr->rd_statp != NULL) {
+				*qptr->rd_statp = OK;
+			}
+			if (qptr->rd_pid != -1) {
+				resume(qptr->rd_pid);
+			}
+			if (qptr->rd_bio != (struct bioreq *)NULL) {
+				biodone(qptr->rd_bio, 1, OK);
+				signal(rdptr->rd_biosem);
+			}
+			qptr = rdqunlink(rdptr, qptr);
+		    } else {
+			qptr = qptr->rd_next;
+		    }
+		}
+
+		/* Cache the block unless a later write of it is	*/
+		/*   queued (rdcinsert keeps a newer cached copy)	*/
+
+		if (qptr == (struct rdqnode *)NULL) {
+			cptr = rdcinsert(rdptr, blk, data);
+
+			/* Mark a block read ahead, so the first use	*/
+			/*   counts as a readahead hit			*/
+
+			if ( (rptr->rd_callbuf == NULL) && !used &&
+			     (cptr != (struct rdcnode *)NULL) ) {
+				cptr->rd_ra = TRUE;
+			}
+		}
+		if ( (rptr->rd_callbuf == NULL) && used ) {
+			rdptr->rd_rahits++;
+		}
+	}
+
+	/* Report the outcome and resume the waiting process or	*/
+	/*   complete the block of an asynchronous request, if any	*/
+
+	if (rptr->rd_statp != NULL) {
+		*rptr->rd_statp = stat;
+	}
+	if (rptr->rd_pid != -1) {
+		resume(rptr->rd_pid);
+	}
+	if (rptr->rd_bio != (struct bioreq *)NULL) {
+		biodone(rptr->rd_bio, 1, stat);
+		signal(rdptr->rd_biosem);
+	}
+	rptr->rd_next = rdptr->rd_qfree;
+	rdptr->rd_qfree = rptr;
+	return;
+}
@@ -1,4 +1,4 @@
-/* rdswrite.c - rdswrite */
+/* rdswrite.c - rdswrite, rdswlocal */
 
 #include <xinu.h>
 
@@ -14,15 +14,16 @@ devcall	rdswrite (
 {
 	struct	rdscblk	*rdptr;		/* Pointer to the control block	*/
 					/*   for the disk device	*/
-	struct	rdqnode	*rptr;		/* Pointer that walks the	*/
-					/*   request list		*/
-	struct	rdcnode	*cptr;		/* Pointer that walks the cache	*/
+	struct	rdqnode	*rptr;		/* Pointer to a request node	*/
+	intmask	mask;			/* Saved interrupt mask		*/
 	pri16	myprio;			/* Temp storage for my priority	*/
 
 	/* If the device not currently open, report an error */
 
+	mask = disable();
 	rdptr = &rdstab[devptr->dvminor];
 	if (rdptr->rd_state != RD_OPEN) {
+		restore(mask);
 		return SYSERR;
 	}
 
@@ -34,18 +35,16 @@ devcall	rdswrite (
 	}
 
 
-	/* If block is present in the cache, remove it and return the	*/
-	/*   node to the free list					*/
+	/* Place the data in the cache if possible */
 
-	cptr = rdptr->rd_chead;
-	while (cptr != (struct rdcnode *)NULL) {
-	    if (cptr->rd_blknum == blk) {
-		rdcunlink(rdptr, cptr);
-		break;
-	    }
-	    cptr = cptr->rd_next;
+	if (rdswlocal(rdptr, buff, blk)) {
+		restore(mask);
+		return OK;
 	}
 
+	/* No clean cache node is available (or an earlier write of	*/
+	/*   the block is queued), so queue the write for the server	*/
+
 	/* Allocate a request node and fill in a write request */
 
 	rptr = rdptr->rd_qfree;
@@ -53,7 +52,10 @@ devcall	rdswrite (
 	rptr->rd_op = RD_OP_WRITE;
 	rptr->rd_blknum = blk;
 	rptr->rd_callbuf = buff;
+	rptr->rd_statp = NULL;		/* Writer does not wait for	*/
+					/*   the server's reply		*/
 	rptr->rd_pid = getpid();
+	rptr->rd_bio = (struct bioreq *)NULL;
 
 	/* Insert the new request at the tail of the queue */
 
@@ -69,5 +71,63 @@ devcall	rdswrite (
 	signal(rdptr->rd_comsem);
 	suspend(getpid());
 	rdssetprio(myprio);
+	restore(mask);
 	return OK;
 }
+
+/*------------------------------------------------------------------------
+ * rdswlocal  -  Place a block being written in the cache, marked dirty,
+ *		   unless an earlier write of the block is queued or no
+ *		   clean cache node is available (returns TRUE if the
+ *		   block was cached; called with interrupts disabled)
+ *------------------------------------------------------------------------
+ */
+bool8	rdswlocal (
+	  struct rdscblk    *rdptr,	/* Ptr to device control block	*/
+	  char		    *buff,	/* Buffer that holds a disk blk	*/
+	  uint32	    blk		/* Block number to write	*/
+	)
+{
+	struct	rdqnode	*rptr;		/* Pointer that walks the	*/
+					/*   request list		*/
+	struct	rdcnode	*cptr;		/* Pointer that walks the cache	*/
+
+	/* Search backward in the request queue for a write of the	*/
+	/*   block; if there is one, this write must follow it		*/
+
+	rptr = rdptr->rd_qtail;
+	while (rptr != (struct rdqnode *)NULL) {
+		if ( (rptr->rd_blknum == blk) &&
+		     (rptr->rd_op == RD_OP_WRITE) ) {
+			break;
+		}
+		rptr = rptr->rd_prev;
+	}
+
+	/* Otherwise, place the data in the cache and mark it dirty;	*/
+	/*   the communication process writes it back later		*/
+
+	if (rptr == (struct rdqnode *)NULL) {
+		cptr = rdclookup(rdptr, blk);
+		if (cptr == (struct rdcnode *)NULL) {
+			cptr = rdcalloc(rdptr, blk);
+		} else {
+			rdcmru(rdptr, cptr);
+		}
+		if (cptr != (struct rdcnode *)NULL) {
+			memcpy(cptr->rd_data, buff, RD_BLKSIZ);
+			if (cptr->rd_dirty) {
+				rdptr->rd_ccoalesce++;
+			} else {
+				cptr->rd_dirty = TRUE;
+				cptr->rd_dtime = ctr1000;
+				rdptr->rd_ndirty++;
+			}
+			if (rdptr->rd_ndirty >= RD_DIRTYHI(rdptr->rd_csize)) {
+				signal(rdptr->rd_comsem);
+			}
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
@@ -0,0 +1,127 @@
+/* rdsxmit.c - rdsxmit, rdsxmitpend */
+
+#include <xinu.h>
+#include <string.h>
+
+/*------------------------------------------------------------------------
+ * rdsxmit  -  Build the message for an outstanding request that is
+ *		 marked for transmission directly in a network buffer and
+ *		 send it to the remote disk server (used for the first
+ *		 transmission and for retransmission); a run of more than
+ *		 one block uses a multi-block message.  Because obtaining
+ *		 the buffer and sending can block, the caller must not
+ *		 have deferred rescheduling.
+ *------------------------------------------------------------------------
+ */
+status	rdsxmit (
+	  struct rdscblk    *rdptr,	/* Ptr to device control block	*/
+	  struct rdpent	    *pptr	/* Request to send		*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	struct	netpacket *pkt;		/* Packet that carries the msg	*/
+	struct	rd_msg_wreq *msg;	/* Message in the packet (all	*/
+					/*   single-block requests are	*/
+					/*   a prefix of a write)	*/
+	struct	rd_msg_mwreq *mmsg;	/* Same, for multi-block msgs	*/
+	int32	mlen;			/* Length of the message	*/
+
+	/* Obtain a buffer before examining the entry, since this may	*/
+	/*   block							*/
+
+	pkt = udp_getpkt(rdptr->rd_udpslot, 0, 0);
+
+	mask = disable();
+
+	/* Another process may have sent the entry, or a reply may have	*/
+	/*   completed it, in the meantime				*/
+
+	if ( !pptr->rd_xmit || (pptr->rd_op == RD_OP_NONE) ) {
+		restore(mask);
+		if ((int32)pkt != SYSERR) {
+			freebuf((char *)pkt);
+		}
+		return OK;
+	}
+	pptr->rd_xmit = FALSE;
+
+	/* Count the attempt even if no buffer is available, so a	*/
+	/*   request cannot be retried forever				*/
+
+	pptr->rd_sent = ctr1000;
+	pptr->rd_tries++;
+
+	if ((int32)pkt == SYSERR) {
+		restore(mask);
+		return SYSERR;
+	}
+	msg = (struct rd_msg_wreq *)pkt->net_udpdata;
+	mmsg = (struct rd_msg_mwreq *)msg;
+	msg->rd_status = htons(0);
+	msg->rd_seq = htonl(pptr->rd_seq);
+	strncpy(msg->rd_id, rdptr->rd_id, RD_IDLEN);	/* Zero-fills	*/
+
+	switch (pptr->rd_op) {
+
+	case RD_OP_READ:
+		if (pptr->rd_nblks > 1) {
+			mmsg->rd_type = htons(RD_MSG_MRREQ);
+			mmsg->rd_blk = htonl(pptr->rd_blknum);
+			mmsg->rd_nblks = htonl(pptr->rd_nblks);
+			mlen = sizeof(struct rd_msg_mrreq);
+			break;
+		}
+		msg->rd_type = htons(RD_MSG_RREQ);
+		msg->rd_blk = htonl(pptr->rd_blknum);
+		mlen = sizeof(struct rd_msg_rreq);
+		break;
+
+	case RD_OP_WRITE:
+		if (pptr->rd_nblks > 1) {
+			mmsg->rd_type = htons(RD_MSG_MWREQ);
+			mmsg->rd_blk = htonl(pptr->rd_blknum);
+			mmsg->rd_nblks = htonl(pptr->rd_nblks);
+			memcpy(mmsg->rd_data, pptr->rd_data,
+					pptr->rd_nblks * RD_BLKSIZ);
+			mlen = RD_MHDRLEN + pptr->rd_nblks * RD_BLKSIZ;
+			break;
+		}
+		msg->rd_type = htons(RD_MSG_WREQ);
+		msg->rd_blk = htonl(pptr->rd_blknum);
+		memcpy(msg->rd_data, pptr->rd_data, RD_BLKSIZ);
+		mlen = sizeof(struct rd_msg_wreq);
+		break;
+
+	case RD_OP_DEL:
+		msg->rd_type = htons(RD_MSG_DREQ);
+		mlen = sizeof(struct rd_msg_dreq);
+		break;
+
+	default:
+		restore(mask);
+		freebuf((char *)pkt);
+		return SYSERR;
+	}
+	restore(mask);
+
+	return udp_sendpkt(pkt, mlen);
+}
+
+/*------------------------------------------------------------------------
+ * rdsxmitpend  -  Send every outstanding request that is marked for
+ *		     transmission (rescheduling must not be deferred)
+ *------------------------------------------------------------------------
+ */
+void	rdsxmitpend (
+	  struct rdscblk    *rdptr	/* Ptr to device control block	*/
+	)
+{
+	int32	i;			/* Index into outstanding table	*/
+
+	for (i=0; i<RD_WINDOW; i++) {
+		if (rdptr->rd_pent[i].rd_xmit) {
+			rdsxmit(rdptr, &rdptr->rd_pent[i]);
+		}
+	}
+	return;
+}
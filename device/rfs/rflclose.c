@@ -16,63 +16,74 @@ devcall	rflclose (
 	struct	rf_msg_cres resp;	/* Buffer for response		*/
 	char	*from, *to;		/* Used during name copy	*/
 	int32	len;			/* Length of name		*/
+	status	syncstat;		/* Outcome of writing back data	*/
 
-	/* Wait for exclusive access */
-
-	wait(Rf_data.rf_mutex);
-
-	/* Verify remote file device is open */
+	/* Wait for exclusive access to the file */
 
 	rfptr = &rfltab[devptr->dvminor];
+	wait(rfptr->rfmutex);
 
 	/* If device not currently in use, report an error */
 
-	if (rfptr->rfstate == RF_FREE) {
-		signal(Rf_data.rf_mutex);
+	if (rfptr->rfstate != RF_USED) {
+		signal(rfptr->rfmutex);
 		return SYSERR;
 	}
 
-	/* Form read request */
+	/* Write back dirty pages and wait for all transfers */
 
-	msg.rf_type = htons(RF_MSG_CREQ);
-	msg.rf_status = htons(0);
-	msg.rf_seq = 0;			/* Rfscomm will set sequence	*/
-	from = rfptr->rfname;
-	to = msg.rf_name;
-	memset(to, NULLCH, RF_NAMLEN);	/* Start name as all zero bytes	*/
-	len = 0;
+	syncstat = rflpsync(rfptr);
 
-	while ( (*to++ = *from++) ) {	/* Copy name to request		*/
-		if (++len >= RF_NAMLEN) {
-			signal(Rf_data.rf_mutex);
-			return SYSERR;
+	/* Tell the server the file is closed, unless the open was	*/
+	/*	answered from the metadata cache			*/
+
+	if (rfptr->rfsrvopen) {
+
+		/* Form close request */
+
+		msg.rf_type = htons(RF_MSG_CREQ);
+		msg.rf_status = htons(0);
+		msg.rf_seq = 0;		/* Rfscomm will set sequence	*/
+		from = rfptr->rfname;
+		to = msg.rf_name;
+		memset(to, NULLCH, RF_NAMLEN);	/* Start name as zeros	*/
+		len = 0;
+
+		while ( (*to++ = *from++) ) {	/* Copy name to request	*/
+			if (++len >= RF_NAMLEN) {
+				signal(rfptr->rfmutex);
+				return SYSERR;
+			}
 		}
-	}
 
-	/* Send message and receive response */
+		/* Send message and receive response */
 
-	retval = rfscomm((struct rf_msg_hdr *)&msg,
-					sizeof(struct rf_msg_creq),
-			 (struct rf_msg_hdr *)&resp,
-					sizeof(struct rf_msg_cres) );
+		retval = rfscomm((struct rf_msg_hdr *)&msg,
+						sizeof(struct rf_msg_creq),
+				 (struct rf_msg_hdr *)&resp,
+						sizeof(struct rf_msg_cres) );
 
-	/* Check response */
+		/* Check response */
 
-	if (retval == SYSERR) {
-		signal(Rf_data.rf_mutex);
-		return SYSERR;
-	} else if (retval == TIMEOUT) {
-		kprintf("Timeout during remote file read\n");
-		signal(Rf_data.rf_mutex);
-		return SYSERR;
-	} else if (ntohs(resp.rf_status) != 0) {
-		signal(Rf_data.rf_mutex);
-		return SYSERR;
+		if (retval == SYSERR) {
+			signal(rfptr->rfmutex);
+			return SYSERR;
+		} else if (retval == TIMEOUT) {
+			kprintf("Timeout during remote file close\n");
+			signal(rfptr->rfmutex);
+			return SYSERR;
+		} else if (ntohs(resp.rf_status) != 0) {
+			signal(rfptr->rfmutex);
+			return SYSERR;
+		}
 	}
 
-	/* Mark device closed */
+	/* Release the page cache and mark device closed */
 
+	freemem((char *)rfptr->rfpages,
+				RF_NPAGES * sizeof(struct rfpage));
+	rfptr->rfpages = (struct rfpage *)NULL;
 	rfptr->rfstate = RF_FREE;
-	signal(Rf_data.rf_mutex);
-	return OK;
+	signal(rfptr->rfmutex);
+	return syncstat;
 }
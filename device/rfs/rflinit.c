@@ -25,5 +25,12 @@ devcall	rflinit(
 		rflptr->rfname[i] = NULLCH;
 	}
 	rflptr->rfpos = rflptr->rfmode = 0;
+
+	/* Create a mutual exclusion semaphore for the file */
+
+	if ( (rflptr->rfmutex = semcreate(1)) == SYSERR ) {
+		panic("Cannot create remote file semaphore");
+	}
+	rflptr->rfpages = (struct rfpage *)NULL;
 	return OK;
 }
@@ -0,0 +1,262 @@
+/* rflpfcns.c - rflplookup, rflpalloc, rflpfetch, rflpflush, rflpwait, */
+/*		rflpsync, rflpinval, rflpreq				*/
+
+#include <xinu.h>
+
+local	void	rflpreq(struct rflcblk *, struct rfpent *, uint16);
+
+/*------------------------------------------------------------------------
+ * rflplookup  -  Find the cached page of a file at a given position
+ *------------------------------------------------------------------------
+ */
+struct	rfpage	*rflplookup (
+	  struct rflcblk *rfptr,	/* Ptr to control block		*/
+	  uint32	pos		/* Position of the page		*/
+	)
+{
+	struct	rfpage	*pgptr;		/* Walks the page cache		*/
+	int32	i;			/* Index into page cache	*/
+
+	for (i=0; i<RF_NPAGES; i++) {
+		pgptr = &rfptr->rfpages[i];
+		if (pgptr->rf_pused && (pgptr->rf_ppos == pos)) {
+			return pgptr;
+		}
+	}
+	return (struct rfpage *)NULL;
+}
+
+/*------------------------------------------------------------------------
+ * rflpalloc  -  Allocate an empty page for a position, reusing the least
+ *		   recently used clean page (a dirty page is written back
+ *		   first, and a page being read or written is waited for)
+ *------------------------------------------------------------------------
+ */
+struct	rfpage	*rflpalloc (
+	  struct rflcblk *rfptr,	/* Ptr to control block		*/
+	  uint32	pos		/* Position of the page		*/
+	)
+{
+	struct	rfpage	*pgptr;		/* Walks the page cache		*/
+	struct	rfpage	*clean;		/* LRU clean idle page		*/
+	struct	rfpage	*dirty;		/* LRU dirty idle page		*/
+	struct	rfpage	*busy;		/* LRU page in transfer		*/
+	int32	i;			/* Index into page cache	*/
+
+	while (TRUE) {
+		clean = dirty = busy = (struct rfpage *)NULL;
+		for (i=0; i<RF_NPAGES; i++) {
+			pgptr = &rfptr->rfpages[i];
+			if (! pgptr->rf_pused) {
+				clean = pgptr;
+				break;
+			}
+			if (pgptr->rf_pent != (struct rfpent *)NULL) {
+				if ( (busy == (struct rfpage *)NULL) ||
+				     (pgptr->rf_ptime < busy->rf_ptime) ) {
+					busy = pgptr;
+				}
+			} else if (pgptr->rf_pdlo != pgptr->rf_pdhi) {
+				if ( (dirty == (struct rfpage *)NULL) ||
+				     (pgptr->rf_ptime < dirty->rf_ptime) ) {
+					dirty = pgptr;
+				}
+			} else if ( (clean == (struct rfpage *)NULL) ||
+				    (pgptr->rf_ptime < clean->rf_ptime) ) {
+				clean = pgptr;
+			}
+		}
+		if (clean != (struct rfpage *)NULL) {
+			break;
+		}
+
+		/* No clean page: write back the oldest dirty page, or	*/
+		/*   wait for a transfer, and try again			*/
+
+		if (dirty != (struct rfpage *)NULL) {
+			if (rflpflush(rfptr, dirty) == SYSERR) {
+				return (struct rfpage *)NULL;
+			}
+			rflpwait(dirty);
+		} else {
+			rflpwait(busy);
+		}
+	}
+
+	clean->rf_pused = TRUE;
+	clean->rf_pvalid = FALSE;
+	clean->rf_ppos = pos;
+	clean->rf_plen = 0;
+	clean->rf_pdlo = clean->rf_pdhi = 0;
+	clean->rf_pent = (struct rfpent *)NULL;
+	clean->rf_ptime = ++rfptr->rfpclock;
+	return clean;
+}
+
+/*------------------------------------------------------------------------
+ * rflpfetch  -  Start reading a page from the server; the page must be
+ *		   clean and idle (rfsrecv fills it in when the reply
+ *		   arrives)
+ *------------------------------------------------------------------------
+ */
+status	rflpfetch (
+	  struct rflcblk *rfptr,	/* Ptr to control block		*/
+	  struct rfpage	*pgptr,		/* Page to read			*/
+	  bool8		block		/* Wait for a free request	*/
+					/*   entry if none is free?	*/
+	)
+{
+	struct	rfpent	*pptr;		/* Entry for the request	*/
+	struct	rf_msg_rreq *msg;	/* Request in the entry		*/
+
+	pptr = rfsalloc(block);
+	if (pptr == (struct rfpent *)NULL) {
+		return SYSERR;
+	}
+	msg = (struct rf_msg_rreq *)&pptr->rf_req;
+	rflpreq(rfptr, pptr, RF_MSG_RREQ);
+	msg->rf_pos = htonl(pgptr->rf_ppos);
+	msg->rf_len = htonl((uint32)RF_DATALEN);
+	pptr->rf_page = pgptr;
+	pgptr->rf_pent = pptr;
+	if (rfssend(pptr, sizeof(struct rf_msg_rreq)) == SYSERR) {
+		pgptr->rf_pent = (struct rfpent *)NULL;
+		return SYSERR;
+	}
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ * rflpflush  -  Start writing the dirty bytes of a page to the server
+ *		   (after any earlier write of the page completes, so the
+ *		   writes of a page reach the server in order)
+ *------------------------------------------------------------------------
+ */
+status	rflpflush (
+	  struct rflcblk *rfptr,	/* Ptr to control block		*/
+	  struct rfpage	*pgptr		/* Page to write		*/
+	)
+{
+	struct	rfpent	*pptr;		/* Entry for the request	*/
+	struct	rf_msg_wreq *msg;	/* Request in the entry		*/
+	int32	len;			/* Number of dirty bytes	*/
+
+	len = pgptr->rf_pdhi - pgptr->rf_pdlo;
+	if (len <= 0) {
+		return OK;
+	}
+	rflpwait(pgptr);
+
+	pptr = rfsalloc(TRUE);
+	msg = &pptr->rf_req;
+	rflpreq(rfptr, pptr, RF_MSG_WREQ);
+	msg->rf_pos = htonl(pgptr->rf_ppos + pgptr->rf_pdlo);
+	msg->rf_len = htonl(len);
+	memcpy(msg->rf_data, &pgptr->rf_pdata[pgptr->rf_pdlo], len);
+	memset(&msg->rf_data[len], NULLCH, RF_DATALEN - len);
+	pptr->rf_page = pgptr;
+	pgptr->rf_pent = pptr;
+	if (rfssend(pptr, sizeof(struct rf_msg_wreq)) == SYSERR) {
+		pgptr->rf_pent = (struct rfpent *)NULL;
+		return SYSERR;
+	}
+	pgptr->rf_pdlo = pgptr->rf_pdhi = 0;
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ * rflpwait  -  Wait until no read or write of a page is in progress
+ *------------------------------------------------------------------------
+ */
+void	rflpwait (
+	  struct rfpage	*pgptr		/* Page to wait for		*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	struct	rfpent	*pptr;		/* Request in progress		*/
+
+	mask = disable();
+	pptr = pgptr->rf_pent;
+	if (pptr != (struct rfpent *)NULL) {
+		pptr->rf_nwait++;
+		wait(pptr->rf_sem);
+	}
+	restore(mask);
+	return;
+}
+
+/*------------------------------------------------------------------------
+ * rflpsync  -  Write all dirty pages of a file (the writes proceed
+ *		  concurrently), wait for every transfer to complete, and
+ *		  report whether any write behind failed
+ *------------------------------------------------------------------------
+ */
+status	rflpsync (
+	  struct rflcblk *rfptr		/* Ptr to control block		*/
+	)
+{
+	int32	i;			/* Index into page cache	*/
+	status	retval;			/* Return value			*/
+
+	retval = OK;
+	for (i=0; i<RF_NPAGES; i++) {
+		if (rflpflush(rfptr, &rfptr->rfpages[i]) == SYSERR) {
+			retval = SYSERR;
+		}
+	}
+	for (i=0; i<RF_NPAGES; i++) {
+		rflpwait(&rfptr->rfpages[i]);
+	}
+	if (rfptr->rferr) {
+		rfptr->rferr = FALSE;
+		retval = SYSERR;
+	}
+	rfptr->rfdirty = FALSE;
+	return retval;
+}
+
+/*------------------------------------------------------------------------
+ * rflpinval  -  Discard the cached pages of a file, including any dirty
+ *		   data, once transfers in progress have completed
+ *------------------------------------------------------------------------
+ */
+void	rflpinval (
+	  struct rflcblk *rfptr		/* Ptr to control block		*/
+	)
+{
+	struct	rfpage	*pgptr;		/* Walks the page cache		*/
+	int32	i;			/* Index into page cache	*/
+
+	for (i=0; i<RF_NPAGES; i++) {
+		pgptr = &rfptr->rfpages[i];
+		rflpwait(pgptr);
+		pgptr->rf_pused = FALSE;
+		pgptr->rf_pdlo = pgptr->rf_pdhi = 0;
+	}
+	rfptr->rfdirty = FALSE;
+	rfptr->rferr = FALSE;
+	return;
+}
+
+/*------------------------------------------------------------------------
+ * rflpreq  -  Fill in the header of an asynchronous page request
+ *------------------------------------------------------------------------
+ */
+local	void	rflpreq (
+	  struct rflcblk *rfptr,	/* Ptr to control block		*/
+	  struct rfpent	*pptr,		/* Entry for the request	*/
+	  uint16	type		/* Message type			*/
+	)
+{
+	struct	rf_msg_hdr *msg;	/* Header of the request	*/
+
+	msg = (struct rf_msg_hdr *)&pptr->rf_req;
+	msg->rf_type = htons(type);
+	msg->rf_status = htons(0);
+	msg->rf_seq = 0;		/* Rfssend will set sequence	*/
+	memset(msg->rf_name, NULLCH, RF_NAMLEN);
+	strncpy(msg->rf_name, rfptr->rfname, RF_NAMLEN);
+	pptr->rf_async = TRUE;
+	pptr->rf_file = rfptr;
+	return;
+}
@@ -1,9 +1,11 @@
-/* rflread.c - rflread */
+/* rflread.c - rflread, rflprefetch */
 
 #include <xinu.h>
 
+local	void	rflprefetch(struct rflcblk *, uint32, uint32);
+
 /*------------------------------------------------------------------------
- * rflread  -  Read data from a remote file
+ * rflread  -  Read data from a remote file through the page cache
  *------------------------------------------------------------------------
  */
 devcall	rflread (
@@ -13,91 +15,174 @@ devcall	rflread (
 	)
 {
 	struct	rflcblk	*rfptr;		/* Pointer to control block	*/
-	int32	retval;			/* Return value			*/
-	struct	rf_msg_rreq  msg;	/* Request message to send	*/
-	struct	rf_msg_rres resp;	/* Buffer for response		*/
-	int32	i;			/* Counts bytes copied		*/
-	char	*from, *to;		/* Used during name copy	*/
-	int32	len;			/* Length of name		*/
-
-	/* Wait for exclusive access */
-
-	wait(Rf_data.rf_mutex);
+	struct	rfpage	*pgptr;		/* Page that holds the data	*/
+	uint32	base;			/* Position of the page		*/
+	int32	off;			/* Offset of data in the page	*/
+	int32	avail;			/* Bytes available in the page	*/
+	int32	n;			/* Bytes to copy from the page	*/
+	int32	nread;			/* Bytes copied so far		*/
+	status	retval;			/* Outcome of the page accesses	*/
 
 	/* Verify count is legitimate */
 
-	if ( (count <= 0) || (count > RF_DATALEN) ) {
-		signal(Rf_data.rf_mutex);
+	if (count <= 0) {
 		return SYSERR;
 	}
 
-	/* Verify pseudo-device is in use */
+	/* Wait for exclusive access to the file */
 
 	rfptr = &rfltab[devptr->dvminor];
+	wait(rfptr->rfmutex);
 
 	/* If device not currently in use, report an error */
 
-	if (rfptr->rfstate == RF_FREE) {
-		signal(Rf_data.rf_mutex);
+	if (rfptr->rfstate != RF_USED) {
+		signal(rfptr->rfmutex);
 		return SYSERR;
 	}
 
 	/* Verify pseudo-device allows reading */
 
 	if ((rfptr->rfmode & RF_MODE_R) == 0) {
-		signal(Rf_data.rf_mutex);
+		signal(rfptr->rfmutex);
 		return SYSERR;
 	}
 
-	/* Form read request */
-
-	msg.rf_type = htons(RF_MSG_RREQ);
-	msg.rf_status = htons(0);
-	msg.rf_seq = 0;			/* Rfscomm will set sequence	*/
-	from = rfptr->rfname;
-	to = msg.rf_name;
-	memset(to, NULLCH, RF_NAMLEN);	/* Start name as all zero bytes	*/
-	len = 0;
-	while ( (*to++ = *from++) ) {	/* Copy name to request		*/
-		if (++len >= RF_NAMLEN) {
-			signal(Rf_data.rf_mutex);
-			return SYSERR;
+	/* A read that continues the previous one doubles the readahead	*/
+	/*	window, and any other read collapses it			*/
+
+	if (rfptr->rfpos == rfptr->rfnext) {
+		if (rfptr->rfra == 0) {
+			rfptr->rfra = RF_RAMIN;
+		} else if (rfptr->rfra < RF_RAMAX) {
+			rfptr->rfra *= 2;
+			if (rfptr->rfra > RF_RAMAX) {
+				rfptr->rfra = RF_RAMAX;
+			}
 		}
+	} else {
+		rfptr->rfra = 0;
 	}
-	msg.rf_pos = htonl(rfptr->rfpos);/* Set file position		*/
-	msg.rf_len = htonl(count);	/* Set count of bytes to read	*/
 
-	/* Send message and receive response */
+	/* Copy data from one page at a time */
+
+	retval = OK;
+	nread = 0;
+	while (nread < count) {
+		off = rfptr->rfpos % RF_DATALEN;
+		base = rfptr->rfpos - off;
+		pgptr = rflplookup(rfptr, base);
+
+		/* On a miss, first send data written to the file to the	*/
+		/*   server, and then start reading the page		*/
+
+		if ( (pgptr == NULL) || ! pgptr->rf_pvalid ) {
+			if (rfptr->rfdirty && (rflpsync(rfptr) == SYSERR)) {
+				retval = SYSERR;
+				break;
+			}
+			pgptr = rflplookup(rfptr, base);
+			if (pgptr == NULL) {
+				pgptr = rflpalloc(rfptr, base);
+				if (pgptr == NULL) {
+					retval = SYSERR;
+					break;
+				}
+			}
+			if ( ! pgptr->rf_pvalid && (pgptr->rf_pent == NULL) &&
+			     (rflpfetch(rfptr, pgptr, TRUE) == SYSERR) ) {
+				pgptr->rf_pused = FALSE;
+				retval = SYSERR;
+				break;
+			}
+		}
+		pgptr->rf_ptime = ++rfptr->rfpclock;
 
-	retval = rfscomm((struct rf_msg_hdr *)&msg,
-					sizeof(struct rf_msg_rreq),
-			 (struct rf_msg_hdr *)&resp,
-					sizeof(struct rf_msg_rres) );
+		/* Start reading the pages that follow, so their replies	*/
+		/*   arrive while this page is copied			*/
 
-	/* Check response */
+		rflprefetch(rfptr, base, rfptr->rfpos + (count - nread));
 
-	if (retval == SYSERR) {
-		signal(Rf_data.rf_mutex);
-		return SYSERR;
-	} else if (retval == TIMEOUT) {
-		kprintf("Timeout during remote file read\n");
-		signal(Rf_data.rf_mutex);
-		return SYSERR;
-	} else if (ntohs(resp.rf_status) != 0) {
-		signal(Rf_data.rf_mutex);
+		/* Wait for the page to arrive */
+
+		if ( ! pgptr->rf_pvalid ) {
+			rflpwait(pgptr);
+			if ( ! pgptr->rf_pused || ! pgptr->rf_pvalid ) {
+				retval = SYSERR;
+				break;
+			}
+		}
+
+		/* Copy data to the application buffer and update file	*/
+		/*   position (a page shorter than RF_DATALEN ends the	*/
+		/*   file)						*/
+
+		avail = pgptr->rf_plen - off;
+		if (avail <= 0) {
+			break;
+		}
+		n = (avail < count - nread) ? avail : count - nread;
+		memcpy(&buff[nread], &pgptr->rf_pdata[off], n);
+		nread += n;
+		rfptr->rfpos += n;
+		if ( (pgptr->rf_plen < RF_DATALEN) &&
+		     (off + n == pgptr->rf_plen) ) {
+			break;
+		}
+	}
+	rfptr->rfnext = rfptr->rfpos;
+	signal(rfptr->rfmutex);
+
+	if (nread > 0) {
+		return nread;
+	} else if (retval == SYSERR) {
 		return SYSERR;
 	}
+	return EOF;
+}
+
+/*------------------------------------------------------------------------
+ * rflprefetch  -  Start reading the pages after a given page that the
+ *		     rest of a read spans, plus the readahead window, up
+ *		     to RF_RAMAX pages (stops when no request entry is free)
+ *------------------------------------------------------------------------
+ */
+local	void	rflprefetch (
+	  struct rflcblk *rfptr,	/* Ptr to control block		*/
+	  uint32	base,		/* Position of the current page	*/
+	  uint32	end		/* Position after the read	*/
+	)
+{
+	struct	rfpage	*pgptr;		/* Page to read			*/
+	uint32	pos;			/* Position of the page		*/
+	int32	npages;			/* Number of pages to read	*/
+	int32	i;			/* Counts pages			*/
 
-	/* Copy data to application buffer and update file position */
+	/* Data that has been written but not sent would make a page	*/
+	/*	read from the server stale				*/
 
-	for (i=0; i<ntohl(resp.rf_len); i++) {
-		*buff++ = resp.rf_data[i];
+	if (rfptr->rfdirty) {
+		return;
 	}
-	rfptr->rfpos += ntohl(resp.rf_len);
 
-	signal(Rf_data.rf_mutex);
-	if (ntohl(resp.rf_len) == 0) {
-		return EOF;
+	npages = (end - base + RF_DATALEN - 1) / RF_DATALEN - 1 + rfptr->rfra;
+	if (npages > RF_RAMAX) {
+		npages = RF_RAMAX;	/* Less than RF_NPAGES, so the	*/
+					/*   current page is not evicted*/
+	}
+	for (i=1; i<=npages; i++) {
+		pos = base + i * RF_DATALEN;
+		if (rflplookup(rfptr, pos) != NULL) {
+			continue;
+		}
+		pgptr = rflpalloc(rfptr, pos);
+		if (pgptr == NULL) {
+			return;
+		}
+		if (rflpfetch(rfptr, pgptr, FALSE) == SYSERR) {
+			pgptr->rf_pused = FALSE;
+			return;
+		}
 	}
-	return ntohl(resp.rf_len);
+	return;
 }
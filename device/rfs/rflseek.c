@@ -13,21 +13,21 @@ devcall	rflseek (
 {
 	struct	rflcblk	*rfptr;		/* Pointer to control block	*/
 
-	/* Wait for exclusive access */
+	/* Wait for exclusive access to the file */
 
-	wait(Rf_data.rf_mutex);
+	rfptr = &rfltab[devptr->dvminor];
+	wait(rfptr->rfmutex);
 
 	/* Verify remote file device is open */
 
-	rfptr = &rfltab[devptr->dvminor];
-	if (rfptr->rfstate == RF_FREE) {
-		signal(Rf_data.rf_mutex);
+	if (rfptr->rfstate != RF_USED) {
+		signal(rfptr->rfmutex);
 		return SYSERR;
 	}
 
 	/* Set the new position */
 
 	rfptr->rfpos = pos;
-	signal(Rf_data.rf_mutex);
+	signal(rfptr->rfmutex);
 	return OK;
 }
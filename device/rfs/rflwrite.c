@@ -3,7 +3,8 @@
 #include <xinu.h>
 
 /*------------------------------------------------------------------------
- * rflwrite  -  Write data to a remote file
+ * rflwrite  -  Write data to a remote file through the page cache (a
+ *		  page is written behind as soon as it is full)
  *------------------------------------------------------------------------
  */
 devcall	rflwrite (
@@ -13,85 +14,141 @@ devcall	rflwrite (
 	)
 {
 	struct	rflcblk	*rfptr;		/* Pointer to control block	*/
-	int32	retval;			/* Return value			*/
-	struct	rf_msg_wreq  msg;	/* Request message to send	*/
-	struct	rf_msg_wres resp;	/* Buffer for response		*/
-	char	*from, *to;		/* Used to copy name		*/
-	int	i;			/* Counts bytes copied into req	*/
-	int32	len;			/* Length of name		*/
-
-	/* Wait for exclusive access */
-
-	wait(Rf_data.rf_mutex);
+	struct	rfpage	*pgptr;		/* Page that receives the data	*/
+	uint32	base;			/* Position of the page		*/
+	uint32	start;			/* Position of first page	*/
+	int32	off;			/* Offset of data in the page	*/
+	int32	lo;			/* Start of new dirty bytes	*/
+	int32	n;			/* Bytes to copy to the page	*/
+	int32	nwritten;		/* Bytes copied so far		*/
+	int32	i;			/* Index into page cache	*/
 
 	/* Verify count is legitimate */
 
-	if ( (count <= 0) || (count > RF_DATALEN) ) {
-		signal(Rf_data.rf_mutex);
+	if (count <= 0) {
 		return SYSERR;
 	}
 
 	/* Verify pseudo-device is in use and mode allows writing */
 
 	rfptr = &rfltab[devptr->dvminor];
-	if ( (rfptr->rfstate == RF_FREE) ||
+	wait(rfptr->rfmutex);
+	if ( (rfptr->rfstate != RF_USED) ||
 	     ! (rfptr->rfmode & RF_MODE_W) ) {
-		signal(Rf_data.rf_mutex);
+		signal(rfptr->rfmutex);
 		return SYSERR;
 	}
 
-	/* Form write request */
-
-	msg.rf_type = htons(RF_MSG_WREQ);
-	msg.rf_status = htons(0);
-	msg.rf_seq = 0;			/* Rfscomm will set sequence	*/
-	from = rfptr->rfname;
-	to = msg.rf_name;
-	memset(to, NULLCH, RF_NAMLEN);	/* Start name as all zero bytes	*/
-	len = 0;
-	while ( (*to++ = *from++) ) {	/* Copy name to request		*/
-		if (++len >= RF_NAMLEN) {
-			signal(Rf_data.rf_mutex);
-			return SYSERR;
-		}
-	}
-	while ( (*to++ = *from++) ) {	/* Copy name into request	*/
-		;
-	}
-	msg.rf_pos = htonl(rfptr->rfpos);/* Set file position		*/
-	msg.rf_len = htonl(count);	/* Set count of bytes to write	*/
-	for (i=0; i<count; i++) {	/* Copy data into message	*/
-		msg.rf_data[i] = *buff++;
-	}
-	while (i < RF_DATALEN) {
-		msg.rf_data[i++] = NULLCH;
+	/* Report the failure of an earlier write behind */
+
+	if (rfptr->rferr) {
+		rfptr->rferr = FALSE;
+		signal(rfptr->rfmutex);
+		return SYSERR;
 	}
 
-	/* Send message and receive response */
+	start = rfptr->rfpos - (rfptr->rfpos % RF_DATALEN);
+	nwritten = 0;
+	while (nwritten < count) {
+		off = rfptr->rfpos % RF_DATALEN;
+		base = rfptr->rfpos - off;
+		n = RF_DATALEN - off;
+		if (n > count - nwritten) {
+			n = count - nwritten;
+		}
 
-	retval = rfscomm((struct rf_msg_hdr *)&msg,
-					sizeof(struct rf_msg_wreq),
-			 (struct rf_msg_hdr *)&resp,
-				sizeof(struct rf_msg_wres) );
+		/* Find the page, waiting for a read of it to finish */
 
-	/* Check response */
+		pgptr = rflplookup(rfptr, base);
+		if ( (pgptr != NULL) && ! pgptr->rf_pvalid ) {
+			rflpwait(pgptr);
+			if ( ! pgptr->rf_pused ) {
+				pgptr = NULL;	/* The read failed	*/
+			}
+		}
+		if (pgptr == NULL) {
+			pgptr = rflpalloc(rfptr, base);
+			if (pgptr == NULL) {
+				signal(rfptr->rfmutex);
+				return SYSERR;
+			}
+		}
 
-	if (retval == SYSERR) {
-		signal(Rf_data.rf_mutex);
-		return SYSERR;
-	} else if (retval == TIMEOUT) {
-		kprintf("Timeout during remote file read\n");
-		signal(Rf_data.rf_mutex);
-		return SYSERR;
-	} else if (ntohs(resp.rf_status) != 0) {
-		signal(Rf_data.rf_mutex);
-		return SYSERR;
+		/* A page that was not read from the server holds only	*/
+		/*   one run of dirty bytes, so write back the run if the	*/
+		/*   new data does not touch it; in a page that was read,	*/
+		/*   zeros fill any gap after the end of the file		*/
+
+		lo = off;
+		if ( ! pgptr->rf_pvalid ) {
+			if ( (pgptr->rf_pdlo != pgptr->rf_pdhi) &&
+			     ( (off > pgptr->rf_pdhi) ||
+			       (off + n < pgptr->rf_pdlo) ) &&
+			     (rflpflush(rfptr, pgptr) == SYSERR) ) {
+				signal(rfptr->rfmutex);
+				return SYSERR;
+			}
+		} else if (off > pgptr->rf_plen) {
+			memset(&pgptr->rf_pdata[pgptr->rf_plen], NULLCH,
+						off - pgptr->rf_plen);
+			lo = pgptr->rf_plen;
+		}
+
+		/* Copy the data and extend the dirty bytes */
+
+		memcpy(&pgptr->rf_pdata[off], &buff[nwritten], n);
+		if (pgptr->rf_pdlo == pgptr->rf_pdhi) {
+			pgptr->rf_pdlo = lo;
+			pgptr->rf_pdhi = off + n;
+		} else {
+			if (lo < pgptr->rf_pdlo) {
+				pgptr->rf_pdlo = lo;
+			}
+			if (off + n > pgptr->rf_pdhi) {
+				pgptr->rf_pdhi = off + n;
+			}
+		}
+		if (pgptr->rf_pvalid) {
+			if (off + n > pgptr->rf_plen) {
+				pgptr->rf_plen = off + n;
+			}
+		} else if ( (pgptr->rf_pdlo == 0) &&
+			    (pgptr->rf_pdhi == RF_DATALEN) ) {
+			pgptr->rf_pvalid = TRUE;  /* Every byte is known */
+			pgptr->rf_plen = RF_DATALEN;
+		}
+		pgptr->rf_ptime = ++rfptr->rfpclock;
+		rfptr->rfdirty = TRUE;
+		nwritten += n;
+		rfptr->rfpos += n;
+
+		/* Write behind a page as soon as it is full */
+
+		if ( (off + n == RF_DATALEN) &&
+		     (rflpflush(rfptr, pgptr) == SYSERR) ) {
+			signal(rfptr->rfmutex);
+			return SYSERR;
+		}
+	}
+
+	/* A cached page that ended the file before the write no longer	*/
+	/*	does: the server fills the gap with zeros		*/
+
+	for (i=0; i<RF_NPAGES; i++) {
+		pgptr = &rfptr->rfpages[i];
+		if ( pgptr->rf_pused && pgptr->rf_pvalid &&
+		     (pgptr->rf_ppos < start) &&
+		     (pgptr->rf_plen < RF_DATALEN) ) {
+			memset(&pgptr->rf_pdata[pgptr->rf_plen], NULLCH,
+					RF_DATALEN - pgptr->rf_plen);
+			pgptr->rf_plen = RF_DATALEN;
+		}
 	}
 
-	/* Report results to caller */
+	/* Keep a cached file size current */
 
-	rfptr->rfpos += ntohl(resp.rf_len);
+	rfsmgrow(rfptr->rfname, rfptr->rfpos);
 
-	signal(Rf_data.rf_mutex);
-	return ntohl(resp.rf_len);
+	signal(rfptr->rfmutex);
+	return count;
 }
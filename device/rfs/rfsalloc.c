@@ -0,0 +1,61 @@
+/* rfsalloc.c - rfsalloc, rfsfree */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ * rfsalloc  -  Reserve an entry in the table of outstanding requests,
+ *		  waiting for one to become free if requested
+ *------------------------------------------------------------------------
+ */
+struct	rfpent	*rfsalloc (
+	  bool8		block		/* Wait if no entry is free?	*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	struct	rfpent	*pptr;		/* Walks the outstanding table	*/
+	int32	i;			/* Index into outstanding table	*/
+
+	mask = disable();
+	if (!block && (semcount(Rf_data.rf_wsem) <= 0)) {
+		restore(mask);
+		return (struct rfpent *)NULL;
+	}
+	wait(Rf_data.rf_wsem);
+
+	/* The semaphore guarantees that an entry is free */
+
+	for (i=0; i<RF_WINDOW; i++) {
+		pptr = &Rf_data.rf_pent[i];
+		if (pptr->rf_state == RF_PFREE) {
+			break;
+		}
+	}
+	pptr->rf_state = RF_PINIT;
+	pptr->rf_async = FALSE;
+	pptr->rf_reply = (struct rf_msg_hdr *)NULL;
+	pptr->rf_rlen = 0;
+	pptr->rf_retval = 0;
+	pptr->rf_file = (struct rflcblk *)NULL;
+	pptr->rf_page = (struct rfpage *)NULL;
+	pptr->rf_nwait = 0;
+	pptr->rf_tries = 0;
+	restore(mask);
+	return pptr;
+}
+
+/*------------------------------------------------------------------------
+ * rfsfree  -  Free an entry in the table of outstanding requests
+ *------------------------------------------------------------------------
+ */
+void	rfsfree (
+	  struct rfpent	*pptr		/* Entry to free		*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+
+	mask = disable();
+	pptr->rf_state = RF_PFREE;
+	signal(Rf_data.rf_wsem);
+	restore(mask);
+	return;
+}
@@ -1,7 +1,9 @@
-/* rfscontrol.c - rfscontrol */
+/* rfscontrol.c - rfscontrol, rfscache */
 
 #include <xinu.h>
 
+local	void	rfscache(char *, bool8);
+
 /*------------------------------------------------------------------------
  * rfscontrol  -  Provide control functions for the remote file system
  *------------------------------------------------------------------------
@@ -18,10 +20,7 @@ devcall	rfscontrol (
 	struct	rf_msg_sres resp;	/* Buffer for size response	*/
 	char	*to, *from;		/* Used during name copy	*/
 	int32	retval;			/* Return value			*/
-
-	/* Wait for exclusive access */
-
-	wait(Rf_data.rf_mutex);
+	struct	rfmeta	meta;		/* Cached metadata for the file	*/
 
 	/* Check length of name (copy during the check even though the	*/
 	/*	copy is only used for a size request)			*/
@@ -33,7 +32,6 @@ devcall	rfscontrol (
 	while ( (*to++ = *from++) ) {	/* Copy name to message		*/
 		len++;
 		if (len >= (RF_NAMLEN - 1) ) {
-			signal(Rf_data.rf_mutex);
 			return SYSERR;
 		}
 	}
@@ -43,28 +41,30 @@ devcall	rfscontrol (
 	/* Delete a file */
 
 	case RFS_CTL_DEL:
+		rfscache((char *)arg1, FALSE);
 		if (rfsndmsg(RF_MSG_DREQ, (char *)arg1) == SYSERR) {
-			signal(Rf_data.rf_mutex);
+			rfsminval((char *)arg1);
 			return SYSERR;
 		}
+		rfsmset((char *)arg1, RF_MMISSING, 0, -1);
 		break;
 
 	/* Truncate a file */
 
 	case RFS_CTL_TRUNC:
+		rfscache((char *)arg1, FALSE);
 		if (rfsndmsg(RF_MSG_TREQ, (char *)arg1) == SYSERR) {
-			signal(Rf_data.rf_mutex);
+			rfsminval((char *)arg1);
 			return SYSERR;
 		}
+		rfsmset((char *)arg1, RF_MEXISTS, 0, 0);
 		break;
 
-
-
 	/* Make a directory */
 
 	case RFS_CTL_MKDIR:
+		rfsminval((char *)arg1);
 		if (rfsndmsg(RF_MSG_MREQ, (char *)arg1) == SYSERR) {
-			signal(Rf_data.rf_mutex);
 			return SYSERR;
 		}
 		break;
@@ -72,8 +72,8 @@ devcall	rfscontrol (
 	/* Remove a directory */
 
 	case RFS_CTL_RMDIR:
+		rfsminval((char *)arg1);
 		if (rfsndmsg(RF_MSG_XREQ, (char *)arg1) == SYSERR) {
-			signal(Rf_data.rf_mutex);
 			return SYSERR;
 		}
 		break;
@@ -83,6 +83,20 @@ devcall	rfscontrol (
 
 	case RFS_CTL_SIZE:
 
+		/* Answer from the metadata cache if it can */
+
+		if (rfsmget((char *)arg1, &meta) == OK) {
+			if (meta.rf_mstate == RF_MMISSING) {
+				return SYSERR;
+			} else if (meta.rf_msize >= 0) {
+				return meta.rf_msize;
+			}
+		}
+
+		/* Data written behind must reach the server first */
+
+		rfscache((char *)arg1, TRUE);
+
 		/* Hand-craft a size request message */
 
 		msg.rf_type = htons(RF_MSG_SREQ);
@@ -96,19 +110,47 @@ devcall	rfscontrol (
 				  (struct rf_msg_hdr *)&resp,
 					sizeof(struct rf_msg_sres) );
 		if ( (retval == SYSERR) || (retval == TIMEOUT) ) {
-			signal(Rf_data.rf_mutex);
 			return SYSERR;
-		} else {
-			signal(Rf_data.rf_mutex);
-			return ntohl(resp.rf_size);
+		} else if (ntohs(resp.rf_status) != 0) {
+			rfsmset((char *)arg1, RF_MMISSING, 0, -1);
+			return SYSERR;
 		}
+		rfsmset((char *)arg1, RF_MEXISTS, 0, ntohl(resp.rf_size));
+		return ntohl(resp.rf_size);
 
 	default:
 		kprintf("rfscontrol: function %d not valid\n", func);
-		signal(Rf_data.rf_mutex);
 		return SYSERR;
 	}
 
-	signal(Rf_data.rf_mutex);
 	return OK;
 }
+
+/*------------------------------------------------------------------------
+ * rfscache  -  Write back or discard the cached pages of each open
+ *		  remote file that has a given name
+ *------------------------------------------------------------------------
+ */
+local	void	rfscache (
+	 char	*name,			/* Null-terminated file name	*/
+	 bool8	sync			/* Write back (TRUE) or discard	*/
+	)
+{
+	struct	rflcblk	*rfptr;		/* Ptr to control block entry	*/
+	int32	i;			/* Index into control blocks	*/
+
+	for (i=0; i<Nrfl; i++) {
+		rfptr = &rfltab[i];
+		wait(rfptr->rfmutex);
+		if ( (rfptr->rfstate == RF_USED) &&
+		     (strncmp(rfptr->rfname, name, RF_NAMLEN) == 0) ) {
+			if (sync) {
+				rflpsync(rfptr);
+			} else {
+				rflpinval(rfptr);
+			}
+		}
+		signal(rfptr->rfmutex);
+	}
+	return;
+}
@@ -12,7 +12,8 @@ devcall	rfsinit(
 	  struct dentry	*devptr		/* Entry in device switch table	*/
 	)
 {
-
+	struct	rfpent	*pptr;		/* Walks the outstanding table	*/
+	int32	i;			/* Index into outstanding table	*/
 
 	/* Set an initial message sequence number */
 
@@ -37,5 +38,27 @@ devcall	rfsinit(
 
 	Rf_data.rf_registered = FALSE;
 
+	/* Mark all outstanding request entries free; the receiver is	*/
+	/*	created when the UDP slot is registered			*/
+
+	if ( (Rf_data.rf_wsem = semcreate(RF_WINDOW)) == SYSERR ) {
+		panic("Cannot create remote file system semaphore");
+	}
+	for (i=0; i<RF_WINDOW; i++) {
+		pptr = &Rf_data.rf_pent[i];
+		pptr->rf_state = RF_PFREE;
+		if ( (pptr->rf_sem = semcreate(0)) == SYSERR ) {
+			panic("Cannot create remote file system semaphore");
+		}
+	}
+	Rf_data.rf_recvproc = -1;
+	Rf_data.rf_retrans = 0;
+
+	/* Start with an empty metadata cache */
+
+	for (i=0; i<RF_NMETA; i++) {
+		Rf_data.rf_meta[i].rf_mstate = RF_MFREE;
+	}
+
 	return OK;
 }
@@ -0,0 +1,155 @@
+/* rfsmeta.c - rfsmget, rfsmset, rfsmgrow, rfsminval, rfsmfind */
+
+#include <xinu.h>
+
+local	struct	rfmeta	*rfsmfind(char *);
+
+/*------------------------------------------------------------------------
+ * rfsmget  -  Obtain a copy of the cached metadata for a name, if an
+ *		 entry exists that has not expired
+ *------------------------------------------------------------------------
+ */
+status	rfsmget (
+	  char		*name,		/* Null-terminated file name	*/
+	  struct rfmeta	*mptr		/* Buffer for the metadata	*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	struct	rfmeta	*eptr;		/* Entry for the name		*/
+
+	mask = disable();
+	eptr = rfsmfind(name);
+	if ( (eptr == (struct rfmeta *)NULL) ||
+	     (ctr1000 - eptr->rf_mtime >= RF_MTIMEOUT) ) {
+		restore(mask);
+		return SYSERR;
+	}
+	memcpy((char *)mptr, (char *)eptr, sizeof(struct rfmeta));
+	restore(mask);
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ * rfsmset  -  Record what the server has reported about a name (the
+ *		 access rights are added to those of an entry that has
+ *		 not expired; a negative size leaves the size unchanged)
+ *------------------------------------------------------------------------
+ */
+void	rfsmset (
+	  char		*name,		/* Null-terminated file name	*/
+	  int32		state,		/* RF_MEXISTS or RF_MMISSING	*/
+	  int32		mode,		/* Access rights granted	*/
+	  int32		size		/* Size of file, or -1		*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	struct	rfmeta	*eptr;		/* Entry for the name		*/
+	struct	rfmeta	*mptr;		/* Walks the metadata cache	*/
+	bool8	fresh;			/* Does the entry still hold?	*/
+	int32	i;			/* Index into metadata cache	*/
+
+	mask = disable();
+	eptr = rfsmfind(name);
+
+	/* Without an entry, use a free one or the oldest */
+
+	if (eptr == (struct rfmeta *)NULL) {
+		for (i=0; i<RF_NMETA; i++) {
+			mptr = &Rf_data.rf_meta[i];
+			if (mptr->rf_mstate == RF_MFREE) {
+				eptr = mptr;
+				break;
+			}
+			if ( (eptr == (struct rfmeta *)NULL) ||
+			     (ctr1000 - mptr->rf_mtime >
+						ctr1000 - eptr->rf_mtime) ) {
+				eptr = mptr;
+			}
+		}
+		eptr->rf_mstate = RF_MFREE;
+		strncpy(eptr->rf_mname, name, RF_NAMLEN);
+	}
+
+	fresh = (eptr->rf_mstate == state) &&
+			(ctr1000 - eptr->rf_mtime < RF_MTIMEOUT);
+	if (! fresh) {
+		eptr->rf_mmode = 0;
+		eptr->rf_msize = -1;
+	}
+	eptr->rf_mstate = state;
+	if (state == RF_MEXISTS) {
+		eptr->rf_mmode |= mode & RF_MODE_RW;
+		if (size >= 0) {
+			eptr->rf_msize = size;
+		}
+	}
+	eptr->rf_mtime = ctr1000;
+	restore(mask);
+	return;
+}
+
+/*------------------------------------------------------------------------
+ * rfsmgrow  -  Extend the cached size of a file after a local write
+ *		  (only if the size is known)
+ *------------------------------------------------------------------------
+ */
+void	rfsmgrow (
+	  char		*name,		/* Null-terminated file name	*/
+	  uint32	size		/* Position after the write	*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	struct	rfmeta	*eptr;		/* Entry for the name		*/
+
+	mask = disable();
+	eptr = rfsmfind(name);
+	if ( (eptr != (struct rfmeta *)NULL) &&
+	     (eptr->rf_mstate == RF_MEXISTS) &&
+	     (eptr->rf_msize >= 0) && ((int32)size > eptr->rf_msize) ) {
+		eptr->rf_msize = size;
+	}
+	restore(mask);
+	return;
+}
+
+/*------------------------------------------------------------------------
+ * rfsminval  -  Discard the cached metadata for a name
+ *------------------------------------------------------------------------
+ */
+void	rfsminval (
+	  char		*name		/* Null-terminated file name	*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	struct	rfmeta	*eptr;		/* Entry for the name		*/
+
+	mask = disable();
+	eptr = rfsmfind(name);
+	if (eptr != (struct rfmeta *)NULL) {
+		eptr->rf_mstate = RF_MFREE;
+	}
+	restore(mask);
+	return;
+}
+
+/*------------------------------------------------------------------------
+ * rfsmfind  -  Find the entry for a name (called with interrupts
+ *		  disabled)
+ *------------------------------------------------------------------------
+ */
+local	struct	rfmeta	*rfsmfind (
+	  char		*name		/* Null-terminated file name	*/
+	)
+{
+	struct	rfmeta	*mptr;		/* Walks the metadata cache	*/
+	int32	i;			/* Index into metadata cache	*/
+
+	for (i=0; i<RF_NMETA; i++) {
+		mptr = &Rf_data.rf_meta[i];
+		if ( (mptr->rf_mstate != RF_MFREE) &&
+		     (strncmp(mptr->rf_mname, name, RF_NAMLEN) == 0) ) {
+			return mptr;
+		}
+	}
+	return (struct rfmeta *)NULL;
+}
@@ -20,9 +20,15 @@ devcall	rfsopen (
 	int32	len;			/* Counts chars in name		*/
 	char	*nptr;			/* Pointer into name string	*/
 	char	*fptr;			/* Pointer into file name	*/
+	struct	rfpage	*pages;		/* Page cache for the file	*/
+	struct	rfmeta	meta;		/* Cached metadata for the file	*/
+	int32	srvopen;		/* TRUE if the server must see	*/
+					/*   the open, FALSE if it was	*/
+					/*   answered locally, SYSERR	*/
+					/*   if the open fails		*/
 	int32	i;			/* General loop index		*/
 
-	/* Wait for exclusive access */
+	/* Wait for exclusive access to the device table */
 
 	wait(Rf_data.rf_mutex);
 
@@ -66,42 +72,102 @@ devcall	rfsopen (
 		return SYSERR;
 	}
 
-	/* Form an open request to create a new file or open an old one */
+	/* Reserve the entry, so the table is not locked during the	*/
+	/*	exchange with the server				*/
 
-	msg.rf_type = htons(RF_MSG_OREQ);/* Request a file open		*/
-	msg.rf_status = htons(0);
-	msg.rf_seq = 0;			/* Rfscomm fills in seq. number	*/
-	nptr = msg.rf_name;
-	memset(nptr, NULLCH, RF_NAMLEN);/* Initialize name to zero bytes*/
-	while ( (*nptr++ = *name++) != NULLCH ) { /* Copy name to req.	*/
-		;
+	rfptr->rfstate = RF_OPENING;
+	signal(Rf_data.rf_mutex);
+
+	/* Allocate the page cache */
+
+	pages = (struct rfpage *)getmem(RF_NPAGES * sizeof(struct rfpage));
+	if ((int32)pages == SYSERR) {
+		rfptr->rfstate = RF_FREE;
+		return SYSERR;
+	}
+	for (i=0; i<RF_NPAGES; i++) {
+		pages[i].rf_pused = FALSE;
+		pages[i].rf_pdlo = pages[i].rf_pdhi = 0;
+		pages[i].rf_pent = (struct rfpent *)NULL;
 	}
-	msg.rf_mode = htonl(rfptr->rfmode); /* Set mode in request	*/
 
-	/* Send message and receive response */
+	/* Answer the open locally if the metadata cache shows that the	*/
+	/*	file exists and an open with these rights succeeded, or	*/
+	/*	shows the reply the server would give			*/
+
+	srvopen = TRUE;
+	if (rfsmget(rfptr->rfname, &meta) == OK) {
+		if (meta.rf_mstate == RF_MEXISTS) {
+			if (rfptr->rfmode & RF_MODE_N) {
+				srvopen = SYSERR; /* File already exists	*/
+			} else if ( (rfptr->rfmode & RF_MODE_RW &
+						~meta.rf_mmode) == 0 ) {
+				srvopen = FALSE;
+			}
+		} else if (rfptr->rfmode & RF_MODE_O) {
+			srvopen = SYSERR;	/* File does not exist	*/
+		}
+	}
 
-	retval = rfscomm((struct rf_msg_hdr *)&msg,
-					sizeof(struct rf_msg_oreq),
-			 (struct rf_msg_hdr *)&resp,
-					sizeof(struct rf_msg_ores) );
+	if (srvopen == TRUE) {
 
-	/* Check response */
+		/* Form an open request to create a new file or open	*/
+		/*	an old one					*/
 
-	if (retval == SYSERR) {
-		signal(Rf_data.rf_mutex);
-		return SYSERR;
-	} else if (retval == TIMEOUT) {
-		kprintf("Timeout during remote file open\n");
-		signal(Rf_data.rf_mutex);
-		return SYSERR;
-	} else if (ntohs(resp.rf_status) != 0) {
-		signal(Rf_data.rf_mutex);
+		msg.rf_type = htons(RF_MSG_OREQ);/* Request a file open	*/
+		msg.rf_status = htons(0);
+		msg.rf_seq = 0;		/* Rfscomm fills in seq. number	*/
+		nptr = msg.rf_name;
+		memset(nptr, NULLCH, RF_NAMLEN);/* Initialize name	*/
+		while ( (*nptr++ = *name++) != NULLCH ) { /* Copy name	*/
+			;
+		}
+		msg.rf_mode = htonl(rfptr->rfmode); /* Set mode		*/
+
+		/* Send message and receive response */
+
+		retval = rfscomm((struct rf_msg_hdr *)&msg,
+						sizeof(struct rf_msg_oreq),
+				 (struct rf_msg_hdr *)&resp,
+						sizeof(struct rf_msg_ores) );
+
+		/* Check response and record what it shows about the	*/
+		/*	file (a failed open of an old file means the	*/
+		/*	name does not exist)				*/
+
+		if ( (retval == SYSERR) || (retval == TIMEOUT) ) {
+			if (retval == TIMEOUT) {
+				kprintf("Timeout during remote file open\n");
+			}
+			srvopen = SYSERR;
+		} else if (ntohs(resp.rf_status) != 0) {
+			if (rfptr->rfmode & RF_MODE_O) {
+				rfsmset(rfptr->rfname, RF_MMISSING, 0, -1);
+			} else {
+				rfsminval(rfptr->rfname);
+			}
+			srvopen = SYSERR;
+		} else {
+			rfsmset(rfptr->rfname, RF_MEXISTS, rfptr->rfmode,
+				(rfptr->rfmode & RF_MODE_N) ? 0 : -1);
+		}
+	}
+	if (srvopen == SYSERR) {
+		freemem((char *)pages, RF_NPAGES * sizeof(struct rfpage));
+		rfptr->rfstate = RF_FREE;
 		return SYSERR;
 	}
 
-	/* Set initial file position */
+	/* Set initial file position and empty page cache */
 
 	rfptr->rfpos = 0;
+	rfptr->rfpages = pages;
+	rfptr->rfpclock = 0;
+	rfptr->rfnext = 0;
+	rfptr->rfra = 0;
+	rfptr->rfdirty = FALSE;
+	rfptr->rferr = FALSE;
+	rfptr->rfsrvopen = srvopen;
 
 	/* Mark state as currently used */
 
@@ -109,6 +175,5 @@ devcall	rfsopen (
 
 	/* Return device descriptor of newly created pseudo-device */
 
-	signal(Rf_data.rf_mutex);
 	return rfptr->rfdev;
 }
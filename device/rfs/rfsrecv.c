@@ -0,0 +1,164 @@
+/* rfsrecv.c - rfsrecv, rfsdone */
+
+#include <xinu.h>
+
+local	void	rfsdone(struct rfpent *, struct rf_msg_hdr *, int32);
+
+/*------------------------------------------------------------------------
+ * rfsrecv  -  Background process that receives replies from the remote
+ *		 file server, matches each reply to an outstanding
+ *		 request by sequence number, completes the request, and
+ *		 retransmits requests for which a reply is overdue (after
+ *		 ending the deferral of rescheduling, since sending can
+ *		 block)
+ *------------------------------------------------------------------------
+ */
+process	rfsrecv(void)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	struct	rf_msg_rres resp;	/* Buffer to hold a reply (a	*/
+					/*   read reply is largest)	*/
+	int32	retval;			/* Return value from udp_recv	*/
+	uint32	seq;			/* Sequence number in a reply	*/
+	struct	rfpent	*pptr;		/* Walks the outstanding table	*/
+	struct	rfpent	*resend[RF_WINDOW];/* Requests to retransmit	*/
+	uint32	rseq[RF_WINDOW];	/* Their sequence numbers	*/
+	int32	nresend;		/* Number of requests to resend	*/
+	int32	i;			/* Index into outstanding table	*/
+
+	while (TRUE) {			/* Do forever */
+
+	    retval = udp_recv(Rf_data.rf_udp_slot, (char *)&resp,
+					sizeof(resp), RF_TICK);
+
+	    mask = disable();
+	    resched_cntl(DEFER_START);
+
+	    /* Match a reply against the outstanding requests (a reply	*/
+	    /*   that matches nothing is a duplicate and is ignored)	*/
+
+	    if (retval >= (int32)sizeof(struct rf_msg_hdr)) {
+		seq = ntohl(resp.rf_seq);
+		for (i=0; i<RF_WINDOW; i++) {
+		    pptr = &Rf_data.rf_pent[i];
+		    if ( (pptr->rf_state != RF_PSENT) ||
+			 (pptr->rf_seq != seq) ) {
+			continue;
+		    }
+		    if (ntohs(resp.rf_type) == (ntohs(pptr->rf_req.rf_type)
+						| RF_MSG_RESPONSE) ) {
+			rfsdone(pptr, (struct rf_msg_hdr *)&resp, retval);
+		    }
+		    break;
+		}
+	    }
+
+	    /* Collect each request whose reply is overdue, and fail a	*/
+	    /*   request after RF_RETRIES transmissions			*/
+
+	    nresend = 0;
+	    for (i=0; i<RF_WINDOW; i++) {
+		pptr = &Rf_data.rf_pent[i];
+		if ( (pptr->rf_state != RF_PSENT) ||
+		     (ctr1000 - pptr->rf_sent < RF_TIMEOUT) ) {
+			continue;
+		}
+		if (pptr->rf_tries >= RF_RETRIES) {
+			kprintf("Timeout on exchange with remote file server\n");
+			rfsdone(pptr, (struct rf_msg_hdr *)NULL, TIMEOUT);
+			continue;
+		}
+		pptr->rf_sent = ctr1000;
+		pptr->rf_tries++;
+		Rf_data.rf_retrans++;
+		rseq[nresend] = pptr->rf_seq;
+		resend[nresend++] = pptr;
+	    }
+
+	    resched_cntl(DEFER_STOP);
+	    restore(mask);
+
+	    /* Retransmit now that sending may block (only this process	*/
+	    /*   completes requests, but skip an entry that changed)	*/
+
+	    for (i=0; i<nresend; i++) {
+		pptr = resend[i];
+		if ( (pptr->rf_state == RF_PSENT) &&
+		     (pptr->rf_seq == rseq[i]) ) {
+			udp_send(Rf_data.rf_udp_slot, (char *)&pptr->rf_req,
+							pptr->rf_mlen);
+		}
+	    }
+	}
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ * rfsdone  -  Complete an outstanding request: hand a reply to the
+ *		 waiting caller, or finish the read or write of a cached
+ *		 page and free the entry (called with interrupts disabled)
+ *------------------------------------------------------------------------
+ */
+local	void	rfsdone (
+	  struct rfpent	*pptr,		/* Request that has completed	*/
+	  struct rf_msg_hdr *resp,	/* Reply, or NULL on timeout	*/
+	  int32		len		/* Length of reply, or TIMEOUT	*/
+	)
+{
+	struct	rfpage	*pgptr;		/* Page read or written		*/
+	struct	rf_msg_rres *rres;	/* Reply to a page read		*/
+	int32	hlen;			/* Length of read reply header	*/
+	int32	n;			/* Bytes of data in a reply	*/
+	bool8	ok;			/* Did the request succeed?	*/
+
+	/* Give the reply to a caller waiting in rfswait */
+
+	if (! pptr->rf_async) {
+		if (resp != (struct rf_msg_hdr *)NULL) {
+			if (len > pptr->rf_rlen) {
+				len = pptr->rf_rlen;
+			}
+			memcpy((char *)pptr->rf_reply, (char *)resp, len);
+		}
+		pptr->rf_retval = len;
+		pptr->rf_state = RF_PDONE;
+		signal(pptr->rf_sem);
+		return;
+	}
+
+	/* Finish the read or write of a page */
+
+	pgptr = pptr->rf_page;
+	ok = (resp != (struct rf_msg_hdr *)NULL) &&
+				(ntohs(resp->rf_status) == 0);
+	if (ntohs(pptr->rf_req.rf_type) == RF_MSG_RREQ) {
+		rres = (struct rf_msg_rres *)resp;
+		hlen = sizeof(struct rf_msg_rres) - RF_DATALEN;
+		n = 0;
+		if (ok) {
+			n = ntohl(rres->rf_len);
+			ok = (n >= 0) && (n <= RF_DATALEN) &&
+						(len >= hlen + n);
+		}
+		if (ok) {
+			memcpy(pgptr->rf_pdata, rres->rf_data, n);
+			pgptr->rf_plen = n;
+			pgptr->rf_pvalid = TRUE;
+		} else {
+			pgptr->rf_pused = FALSE; /* Discard the page	*/
+		}
+	} else if (! ok) {
+		pptr->rf_file->rferr = TRUE;
+		kprintf("rfsrecv: write behind to %s failed\n",
+						pptr->rf_file->rfname);
+	}
+	pgptr->rf_pent = (struct rfpent *)NULL;
+
+	/* Release processes waiting for the page */
+
+	if (pptr->rf_nwait > 0) {
+		signaln(pptr->rf_sem, pptr->rf_nwait);
+	}
+	rfsfree(pptr);
+	return;
+}
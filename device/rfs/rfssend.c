@@ -0,0 +1,87 @@
+/* rfssend.c - rfssend, rfsregister */
+
+#include <xinu.h>
+
+local	status	rfsregister(void);
+
+/*------------------------------------------------------------------------
+ * rfssend  -  Assign a sequence number to a request that has been built
+ *		 in an outstanding request entry and send it to the server
+ *		 (rfsrecv matches the reply and retransmits if needed)
+ *------------------------------------------------------------------------
+ */
+status	rfssend (
+	  struct rfpent	*pptr,		/* Request to send		*/
+	  int32		mlen		/* Length of the request	*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+
+	/* For the first time after reboot, register the server port */
+
+	if ( ! Rf_data.rf_registered ) {
+		wait(Rf_data.rf_mutex);
+		if ( (! Rf_data.rf_registered) &&
+		     (rfsregister() == SYSERR) ) {
+			signal(Rf_data.rf_mutex);
+			rfsfree(pptr);
+			return SYSERR;
+		}
+		signal(Rf_data.rf_mutex);
+	}
+
+	/* Assign the request the next sequence number */
+
+	mask = disable();
+	pptr->rf_seq = Rf_data.rf_seq++;
+	pptr->rf_req.rf_seq = htonl(pptr->rf_seq);
+	pptr->rf_mlen = mlen;
+	pptr->rf_sent = ctr1000;
+	pptr->rf_tries = 1;
+	pptr->rf_state = RF_PSENT;
+	restore(mask);
+
+	if (udp_send(Rf_data.rf_udp_slot, (char *)&pptr->rf_req,
+							mlen) == SYSERR) {
+		kprintf("Cannot send to remote file server\n");
+		rfsfree(pptr);
+		return SYSERR;
+	}
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ * rfsregister  -  Register the UDP port for the server and start the
+ *		     process that receives replies
+ *------------------------------------------------------------------------
+ */
+local	status	rfsregister(void)
+{
+	int32	slot;			/* UDP slot			*/
+	char	err[128];		/* Error message buffer		*/
+
+	/* Convert the server name to an IP address */
+
+	if (dnslookup(RF_SERVER, &Rf_data.rf_ser_ip) == SYSERR) {
+		sprintf(err, "rfs server %s is invalid", RF_SERVER);
+		panic(err);
+	}
+
+	if ( (slot = udp_register(Rf_data.rf_ser_ip,
+			Rf_data.rf_ser_port,
+			Rf_data.rf_loc_port)) == SYSERR) {
+		return SYSERR;
+	}
+	Rf_data.rf_udp_slot = slot;
+
+	Rf_data.rf_recvproc = create(rfsrecv, RF_STACK, RF_PRIO,
+					"rfsrecv", 0);
+	if (Rf_data.rf_recvproc == SYSERR) {
+		kprintf("rfssend: cannot create remote file process\n");
+		udp_release(slot);
+		return SYSERR;
+	}
+	Rf_data.rf_registered = TRUE;
+	resume(Rf_data.rf_recvproc);
+	return OK;
+}
@@ -0,0 +1,23 @@
+/* rfswait.c - rfswait */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ * rfswait  -  Wait for the reply to a synchronous request, free its
+ *		 entry, and return the length of the reply or TIMEOUT
+ *------------------------------------------------------------------------
+ */
+int32	rfswait (
+	  struct rfpent	*pptr		/* Request that has been sent	*/
+	)
+{
+	int32	retval;			/* Return value			*/
+
+	/* Rfsrecv signals the semaphore exactly once when the request	*/
+	/*	completes, so the wait returns at once if it already has	*/
+
+	wait(pptr->rf_sem);
+	retval = pptr->rf_retval;
+	rfsfree(pptr);
+	return retval;
+}
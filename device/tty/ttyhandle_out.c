@@ -3,8 +3,8 @@
 #include <xinu.h>
 
 /*------------------------------------------------------------------------
- *  ttyhandle_out  -  Handle an output on a tty device by sending more
- *		     characters to the device FIFO (interrupts disabled)
+ *  ttyhandle_out  -  Handle an output on a tty device by filling the
+ *		     device's transmit FIFO (interrupts disabled)
  *------------------------------------------------------------------------
  */
 void	ttyhandle_out(
@@ -35,9 +35,17 @@ void	ttyhandle_out(
 		return;
 	}
 	
-	/* Initialize uspace to the size of the transmit FIFO */
+	/* Characters written by kputc after the interrupt was raised	*/
+	/*   may still be in the FIFO; if so, another interrupt will	*/
+	/*   follow when it empties					*/
 
-	uspace = UART_FIFO_SIZE;
+	if ( (io_inb(csrptr->lsr) & UART_LSR_THRE) == 0) {
+		return;
+	}
+
+	/* Initialize uspace to the size of the (empty) transmit FIFO */
+
+	uspace = typtr->tyfifosz;
 
 	/* While onboard FIFO is not full and the echo queue is	*/
 	/*   nonempty, xmit chars from the echo queue		*/
@@ -64,6 +72,10 @@ void	ttyhandle_out(
 		uspace--;
 		ochars++;
 	}
+
+	/* Let kputc use the rest of the FIFO without polling */
+
+	typtr->tyofree = uspace;
 	if (ochars > 0) {
 		signaln(typtr->tyosem, ochars);
 	}
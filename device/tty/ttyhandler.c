@@ -21,55 +21,74 @@ void ttyhandler(void) {
 
 	typtr = &ttytab[ devptr->dvminor ];
 
-	/* Decode hardware interrupt request from UART device */
+	/* Handle every cause the UART reports before returning, so a	*/
+	/*   cause that is pending behind another one (e.g., transmit	*/
+	/*   ready behind received data) is not lost; defer		*/
+	/*   rescheduling until all have been handled			*/
 
-        /* Check interrupt identification register */
-	iir = io_inb(csrptr->iir);
-        if (iir & UART_IIR_IRQ) {
-		return;
-        }
+	resched_cntl(DEFER_START);
 
-	/* Decode the interrupt cause based upon the value extracted	*/
-	/* from the UART interrupt identification register.  Clear	*/
-	/* the interrupt source and perform the appropriate handling	*/
-	/* to coordinate with the upper half of the driver		*/
+	while (TRUE) {
 
-        /* Decode the interrupt cause */
+		/* Check interrupt identification register */
 
-        iir &= UART_IIR_IDMASK;		/* Mask off the interrupt ID */
-        switch (iir) {
+		iir = io_inb(csrptr->iir);
+		if (iir & UART_IIR_IRQ) {
+			break;
+		}
 
-	    /* Receiver line status interrupt (error) */
+		/* Decode the interrupt cause based upon the value	*/
+		/* extracted from the UART interrupt identification	*/
+		/* register.  Clear the interrupt source and perform	*/
+		/* the appropriate handling to coordinate with the	*/
+		/* upper half of the driver				*/
 
-	    case UART_IIR_RLSI:
-		return;
+		iir &= UART_IIR_IDMASK;	/* Mask off the interrupt ID	*/
+		switch (iir) {
 
-	    /* Receiver data available or timed out */
+		    /* Receiver line status interrupt (error): reading	*/
+		    /*   the line status register clears it		*/
 
-	    case UART_IIR_RDA:
-	    case UART_IIR_RTO:
+		    case UART_IIR_RLSI:
+			io_inb(csrptr->lsr);
+			continue;
 
-		resched_cntl(DEFER_START);
+		    /* Receiver FIFO reached its trigger level, or it	*/
+		    /*   holds characters that have waited (timed out)	*/
 
-		/* While chars avail. in UART buffer, call ttyhandle_in	*/
+		    case UART_IIR_RDA:
+		    case UART_IIR_RTO:
 
-		while ( (io_inb(csrptr->lsr) & UART_LSR_DR) != 0) {
-			ttyhandle_in(typtr, csrptr);
-                }
+			typtr->tyrxints++;
 
-		resched_cntl(DEFER_STOP);
+			/* Drain the receive FIFO, calling ttyhandle_in	*/
+			/*   for each character				*/
 
-		return;
+			while ( (io_inb(csrptr->lsr) & UART_LSR_DR) != 0) {
+				ttyhandle_in(typtr, csrptr);
+			}
+			continue;
 
-            /* Transmitter output FIFO is empty (i.e., ready for more)	*/
+		    /* Transmitter FIFO is empty (i.e., ready for more)	*/
 
-	    case UART_IIR_THRE:
-		ttyhandle_out(typtr, csrptr);
-		return;
+		    case UART_IIR_THRE:
+			typtr->tytxints++;
+			ttyhandle_out(typtr, csrptr);
+			continue;
 
-	    /* Modem status change (simply ignore) */
+		    /* Modem status change: reading the modem status	*/
+		    /*   register clears it				*/
 
-	    case UART_IIR_MSC:
-		return;
-	    }
+		    case UART_IIR_MSC:
+			io_inb(csrptr->msr);
+			continue;
+
+		    default:
+			break;
+		}
+		break;
+	}
+
+	resched_cntl(DEFER_STOP);
+	return;
 }
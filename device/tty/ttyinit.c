@@ -14,6 +14,7 @@ devcall	ttyinit(
 {
 	struct	ttycblk	*typtr;		/* Pointer to ttytab entry	*/
 	struct	uart_csreg *uptr;	/* Address of UART's CSRs	*/
+	byte	iir;			/* Interrupt identification	*/
 
 	typtr = &ttytab[ devptr->dvminor ];
 
@@ -48,6 +49,10 @@ devcall	ttyinit(
 	typtr->tyocrlf = TRUE;			/* Send CRLF for NEWLINE*/
 	typtr->tyifullc = TY_FULLCH;		/* Send ^G when buffer	*/
 						/*   is full		*/
+	typtr->tyofree = 0;			/* UART FIFO not known	*/
+						/*   to be empty	*/
+	typtr->tyrxints = 0;			/* No interrupts yet	*/
+	typtr->tytxints = 0;
 
 	/* Initialize the UART */
 
@@ -58,8 +63,12 @@ devcall	ttyinit(
 	io_outb(uptr->dlm, 0x00);
 	io_outb(uptr->dll, 0x18);
 
+	/* A 16750 enables its 64-character FIFOs only when asked while	*/
+	/*   the divisor latch is accessible; other UARTs ignore the bit*/
+
+	io_outb(uptr->fcr, UART_FCR_EFIFO | UART_FCR_E64);
+
 	io_outb(uptr->lcr,UART_LCR_8N1);/* 8 bit char, No Parity, 1 Stop*/
-	io_outb(uptr->fcr, 0x00);	/* Disable FIFO for now		*/
 
 	/* Register the interrupt dispatcher for the tty device */
 
@@ -71,6 +80,18 @@ devcall	ttyinit(
 	io_outb(uptr->fcr, UART_FCR_EFIFO | UART_FCR_RRESET |
 			   UART_FCR_TRESET | UART_FCR_TRIG2);
 
+	/* Size the FIFOs from what the UART reports: an 8250 or 16450	*/
+	/*   has none, so each transmit interrupt can take one char	*/
+
+	iir = io_inb(uptr->iir);
+	if ( (iir & UART_IIR_FIFO) != UART_IIR_FIFO ) {
+		typtr->tyfifosz = 1;
+	} else if (iir & UART_IIR_F64) {
+		typtr->tyfifosz = UART_FIFO_SIZE64;
+	} else {
+		typtr->tyfifosz = UART_FIFO_SIZE;
+	}
+
 	/* Start the device */
 
 	ttykickout(uptr);
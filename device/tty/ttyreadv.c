@@ -0,0 +1,77 @@
+/* ttyreadv.c - ttyreadv */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ *  ttyreadv  -  Read characters from a tty device into a vector of
+ *		   buffers; in cooked mode, one line is read and spread
+ *		   across the buffers (interrupts disabled)
+ *------------------------------------------------------------------------
+ */
+devcall	ttyreadv(
+	  struct dentry	*devptr,	/* Entry in device switch table	*/
+	  struct iovec	*iov,		/* Buffers to fill in order	*/
+	  int32		iovcnt		/* Number of buffers		*/
+	)
+{
+	struct	ttycblk	*typtr;		/* Pointer to tty control block	*/
+	int32	nread;			/* Number of characters read	*/
+	int32	firstch;		/* First input character on line*/
+	char	ch;			/* Next input character		*/
+	uint32	pos;			/* Position in current buffer	*/
+	int32	i;			/* Index into the vector	*/
+
+	typtr= &ttytab[devptr->dvminor];
+
+	/* Skip empty buffers at the start of the vector */
+
+	for (i=0; (i<iovcnt) && (iov[i].iov_len == 0); i++) {
+		;
+	}
+	if (i >= iovcnt) {
+		return 0;
+	}
+
+	if (typtr->tyimode != TY_IMCOOKED) {
+		nread = 0;
+		for (; i<iovcnt; i++) {
+			for (pos=0; pos<iov[i].iov_len; pos++) {
+				iov[i].iov_base[pos] = (char) ttygetc(devptr);
+				nread++;
+			}
+		}
+		return nread;
+	}
+
+	/* Block until input arrives */
+
+	firstch = ttygetc(devptr);
+
+	/* Check for End-Of-File */
+
+	if (firstch == EOF) {
+		return EOF;
+	}
+
+	/* Read up to a line, moving to the next buffer as each fills */
+
+	ch = (char) firstch;
+	iov[i].iov_base[0] = ch;
+	pos = 1;
+	nread = 1;
+	while ( (ch != TY_NEWLINE) && (ch != TY_RETURN) ) {
+		if (pos >= iov[i].iov_len) {
+			for (i++; (i<iovcnt) && (iov[i].iov_len == 0); i++) {
+				;
+			}
+			if (i >= iovcnt) {
+				break;
+			}
+			pos = 0;
+		}
+		ch = ttygetc(devptr);
+		iov[i].iov_base[pos++] = ch;
+		nread++;
+	}
+	return nread;
+}
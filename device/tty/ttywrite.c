@@ -3,7 +3,9 @@
 #include <xinu.h>
 
 /*------------------------------------------------------------------------
- *  ttywrite  -  Write character(s) to a tty device (interrupts disabled)
+ *  ttywrite  -  Write character(s) to a tty device, moving as many as
+ *		   the output queue has room for in one step (interrupts
+ *		   disabled)
  *------------------------------------------------------------------------
  */
 devcall	ttywrite(
@@ -12,6 +14,14 @@ devcall	ttywrite(
 	  int32	count 			/* Count of character to write	*/
 	)
 {
+	struct	ttycblk	*typtr;		/* Pointer to tty control block	*/
+	int32	room;			/* Slots reserved in the queue	*/
+	int32	used;			/* Reserved slots filled	*/
+	int32	span;			/* Chars to copy in one piece	*/
+	int32	n;			/* Chars before a newline	*/
+	bool8	crsent;			/* CR already queued for the	*/
+					/*   newline at *buff?		*/
+
 	/* Handle negative and zero counts */
 
 	if (count < 0) {
@@ -20,10 +30,78 @@ devcall	ttywrite(
 		return OK;
 	}
 
-	/* Write count characters one at a time */
+	typtr = &ttytab[devptr->dvminor];
+	crsent = FALSE;
+
+	while (count > 0) {
+
+		/* Reserve every free slot in the output queue at once;	*/
+		/*   if none is free, start output and wait for one.	*/
+		/*   Interrupts stay disabled and nothing reschedules	*/
+		/*   until unused slots are given back below, as	*/
+		/*   semtake requires					*/
+
+		room = semtake(typtr->tyosem, TY_OBUFLEN);
+		if (room <= 0) {
+			ttykickout((struct uart_csreg *)devptr->dvcsr);
+			wait(typtr->tyosem);
+			room = 1 + semtake(typtr->tyosem, TY_OBUFLEN - 1);
+		}
+
+		/* Copy runs of characters into the reserved slots,	*/
+		/*   stopping at the end of the buffer and, when CRLF	*/
+		/*   is sent for NEWLINE, at each newline		*/
+
+		used = 0;
+		while ( (used < room) && (count > 0) ) {
+			if ( (*buff == TY_NEWLINE) && typtr->tyocrlf &&
+			     !crsent ) {
+				*typtr->tyotail++ = TY_RETURN;
+				crsent = TRUE;
+				n = 1;
+			} else {
+				span = room - used;
+				if (span > count) {
+					span = count;
+				}
+				if (span > &typtr->tyobuff[TY_OBUFLEN] -
+							typtr->tyotail) {
+					span = &typtr->tyobuff[TY_OBUFLEN] -
+							typtr->tyotail;
+				}
+				n = 1;
+				if (typtr->tyocrlf) {
+					while ( (n < span) &&
+						(buff[n] != TY_NEWLINE) ) {
+						n++;
+					}
+				} else {
+					n = span;
+				}
+				memcpy(typtr->tyotail, buff, n);
+				typtr->tyotail += n;
+				buff += n;
+				count -= n;
+				crsent = FALSE;
+			}
+			used += n;
+
+			/* Wrap around to beginning of buffer, if needed */
+
+			if (typtr->tyotail >= &typtr->tyobuff[TY_OBUFLEN]) {
+				typtr->tyotail = typtr->tyobuff;
+			}
+		}
+
+		/* Give back unused slots */
+
+		if (used < room) {
+			signaln(typtr->tyosem, room - used);
+		}
+
+		/* Start output in case device is idle */
 
-	for (; count>0 ; count--) {
-		ttyputc(devptr, *buff++);
+		ttykickout((struct uart_csreg *)devptr->dvcsr);
 	}
 	return OK;
 }
@@ -0,0 +1,28 @@
+/* ttywritev.c - ttywritev */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ *  ttywritev  -  Write a vector of buffers to a tty device as one
+ *		    sequence of characters (interrupts disabled)
+ *------------------------------------------------------------------------
+ */
+devcall	ttywritev(
+	  struct dentry	*devptr,	/* Entry in device switch table	*/
+	  struct iovec	*iov,		/* Buffers to write in order	*/
+	  int32		iovcnt		/* Number of buffers		*/
+	)
+{
+	int32	nwritten;		/* Characters written		*/
+	int32	i;			/* Index into the vector	*/
+
+	nwritten = 0;
+	for (i=0; i<iovcnt; i++) {
+		if (ttywrite(devptr, iov[i].iov_base,
+				(int32)iov[i].iov_len) == SYSERR) {
+			return SYSERR;
+		}
+		nwritten += iov[i].iov_len;
+	}
+	return nwritten;
+}
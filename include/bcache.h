@@ -0,0 +1,82 @@
+/* bcache.h - bchash */
+
+/************************************************************************/
+/*									*/
+/*	Block buffer cache shared by file systems that use a disk	*/
+/*									*/
+/*   The cache holds BC_NBUFS blocks, each found through a hash table	*/
+/* by (device, block number).  A process that calls bcget holds the	*/
+/* buffer until it calls bcrelse, so concurrent readers share one	*/
+/* copy and a held buffer is never replaced.  Buffers that are not	*/
+/* held are replaced in least-recently-used order.  A write only marks	*/
+/* the buffer dirty; the flush process, bcflushd, writes a dirty	*/
+/* buffer to the device once it has aged BC_AGE ms, and a dirty buffer	*/
+/* chosen for replacement is written first.  A buffer whose write	*/
+/* fails becomes dirty again, so bcflushd retries it.  Writes go	*/
+/* through the asynchronous block interface (see bio.h), so the cache	*/
+/* needs devices whose dvbio entry is not ioerr.  A process does not	*/
+/* wait for a write it starts, and buffers written together are	*/
+/* submitted with the device's queue plugged so they are sorted and	*/
+/* merged.								*/
+/*									*/
+/************************************************************************/
+
+#ifndef	BC_NBUFS
+#define	BC_NBUFS	64		/* Number of buffers in cache	*/
+#endif
+
+#define	BC_NHASH	64		/* Hash table size (power of 2)	*/
+#define	BC_BLKSIZ	512		/* Size of a block in bytes	*/
+#define	BC_NODEV	(did32) -1	/* Device ID of unused buffer	*/
+#define	BC_ALLDEV	(did32) -2	/* Select buffers of any device	*/
+
+#define	BC_FLUSHMS	1000		/* Period of the flush process	*/
+#define	BC_AGE		3000		/* Time a buffer stays dirty	*/
+					/*   before it is written (ms)	*/
+#define	BC_STACK	8192		/* Stack size of flush process	*/
+#define	BC_PRIO		30		/* Priority of flush process	*/
+
+/* Buffer flags */
+
+#define	BC_VALID	0x01		/* Buffer holds the block	*/
+#define	BC_DIRTY	0x02		/* Buffer differs from device	*/
+#define	BC_BUSY		0x04		/* Read or write in progress	*/
+#define	BC_WERR		0x08		/* Last write failed (the buffer*/
+					/*   stays dirty to be retried)	*/
+
+struct	bcbuf	{			/* One buffer in the cache	*/
+	did32	bc_dev;			/* Device of the block, or	*/
+					/*   BC_NODEV if unused		*/
+	uint32	bc_blk;			/* Block number on the device	*/
+	int32	bc_flags;		/* BC_VALID, BC_DIRTY, etc.	*/
+	int32	bc_refs;		/* Processes holding the buffer	*/
+	uint32	bc_dtime;		/* Time the buffer became dirty	*/
+	struct	bioreq	bc_bio;		/* Request for a write		*/
+	struct	bcbuf	*bc_hnext;	/* Next buffer on hash chain	*/
+	struct	bcbuf	*bc_prev;	/* Previous buffer in LRU order	*/
+	struct	bcbuf	*bc_next;	/* Next buffer in LRU order	*/
+	char	bc_data[BC_BLKSIZ];	/* Contents of the block	*/
+};
+
+struct	bcdata	{			/* Global data for the cache	*/
+	struct	bcbuf	bc_bufs[BC_NBUFS];/* The buffers		*/
+	struct	bcbuf	*bc_hash[BC_NHASH];/* Hash chains		*/
+	struct	bcbuf	*bc_lru;	/* Least recently used buffer	*/
+	struct	bcbuf	*bc_mru;	/* Most recently used buffer	*/
+	sid32	bc_wsem;		/* Processes waiting for a	*/
+	int32	bc_nwait;		/*   buffer to be released	*/
+	sid32	bc_iosem;		/* Processes waiting for a read	*/
+	int32	bc_niowait;		/*   or write of any buffer to	*/
+					/*   complete (they recheck	*/
+					/*   BC_BUSY when awakened)	*/
+	int32	bc_ndirty;		/* Number of dirty buffers	*/
+	uint32	bc_hits;		/* Blocks found in the cache	*/
+	uint32	bc_misses;		/* Blocks not found		*/
+	uint32	bc_writes;		/* Blocks written to devices	*/
+	uint32	bc_werrors;		/* Writes that failed		*/
+};
+
+extern	struct	bcdata	Bc_data;
+
+#define	bchash(dev, blk)	\
+		( (((uint32)(dev) * 31) + (blk)) & (BC_NHASH-1) )
@@ -0,0 +1,91 @@
+/* bio.h - definitions for asynchronous block I/O */
+
+/************************************************************************/
+/*									*/
+/*   A process describes a transfer of one or more contiguous blocks	*/
+/* with a bioreq, submits it with biosubmit, and continues.  The	*/
+/* driver for the device (the dvbio entry in the device switch table)	*/
+/* queues the blocks and calls biodone as they complete.  When the	*/
+/* last block completes, the request is marked done and the submitter	*/
+/* is notified in each way it asked for: a semaphore is signaled, a	*/
+/* message is sent, and/or a function is called (with interrupts	*/
+/* disabled).  biowait blocks until a request is done and returns	*/
+/* its outcome.  A driver without a queue of its own names bioemul	*/
+/* as its dvbio function, which performs the transfer synchronously	*/
+/* with the device's read and write functions.				*/
+/*									*/
+/*   Requests pass through a queue for each device, kept in block	*/
+/* order except that a request never moves ahead of an earlier one	*/
+/* that overlaps it when either writes.  When the queue is run,	*/
+/* successive requests for contiguous blocks with the same operation	*/
+/* are linked (through bio_next) and given to the driver as one	*/
+/* transfer.  A process that is about to submit a burst of requests	*/
+/* can plug the queue with bioplug so the burst is sorted and merged	*/
+/* before biounplug runs it; biowait runs the queue of a request	*/
+/* that is still queued, and BIO_QMAX queued requests run it anyway.	*/
+/*									*/
+/************************************************************************/
+
+#define	BIO_BLKSIZ	512		/* Size of a block in bytes	*/
+#define	BIO_QMAX	64		/* Queued requests that run a	*/
+					/*   plugged queue		*/
+#define	BIO_MAXMERGE	64		/* Max. blocks in one transfer	*/
+
+/* Operations */
+
+#define	BIO_READ	1		/* Read blocks into the buffer	*/
+#define	BIO_WRITE	2		/* Write blocks from the buffer	*/
+
+/* States of a request */
+
+#define	BIO_IDLE	0		/* Not submitted		*/
+#define	BIO_QUEUED	1		/* In the device's queue	*/
+#define	BIO_PEND	2		/* Given to the driver		*/
+#define	BIO_DONE	3		/* All blocks have completed	*/
+
+struct	bioreq	{			/* An asynchronous block request*/
+
+	/* Fields filled in by the submitter (see bioprep) */
+
+	int32	bio_op;			/* BIO_READ or BIO_WRITE	*/
+	uint32	bio_blk;		/* First block of the transfer	*/
+	uint32	bio_nblks;		/* Number of blocks		*/
+	char	*bio_buf;		/* Caller's buffer (must remain	*/
+					/*   valid until the request is	*/
+					/*   done)			*/
+	sid32	bio_sem;		/* Semaphore to signal when	*/
+					/*   done, or -1		*/
+	pid32	bio_pid;		/* Process to send bio_msg when	*/
+	umsg32	bio_msg;		/*   done, or -1		*/
+	void	(*bio_func)(struct bioreq *);/* Function to call when	*/
+					/*   done, or NULL		*/
+	void	*bio_arg;		/* For use by the submitter	*/
+
+	/* Fields maintained by biosubmit, the driver, and biodone */
+
+	did32	bio_dev;		/* Device the request is for	*/
+	int32	bio_state;		/* BIO_IDLE, BIO_QUEUED, ...	*/
+	status	bio_status;		/* OK, or the first error	*/
+	uint32	bio_nleft;		/* Blocks not yet completed	*/
+	pid32	bio_waiter;		/* Process in biowait, or -1	*/
+	struct	bioreq	*bio_next;	/* Next request in the device's	*/
+					/*   queue or in a transfer	*/
+};
+
+/* Request queue of a device */
+
+struct	bioqueue {			/* Entry in bioqtab		*/
+	struct	bioreq	*bq_head;	/* Queued requests, in the order*/
+					/*   they will be given to the	*/
+					/*   driver			*/
+	int32	bq_plugs;		/* Outstanding calls to bioplug	*/
+	int32	bq_depth;		/* Requests in the queue	*/
+	int32	bq_maxdepth;		/* Most requests ever queued	*/
+	uint32	bq_nreqs;		/* Requests submitted		*/
+	uint32	bq_nblks;		/* Blocks in those requests	*/
+	uint32	bq_nxfers;		/* Transfers given to the driver*/
+	uint32	bq_nmerged;		/* Requests that joined a	*/
+					/*   transfer of another one	*/
+};
+
+extern	struct	bioqueue bioqtab[];
@@ -5,7 +5,8 @@
 #endif
 
 #ifndef	BP_MAXB
-#define	BP_MAXB	8192		/* Maximum buffer size in bytes		*/
+#define	BP_MAXB	16384		/* Maximum buffer size in bytes (large	*/
+				/*   enough for a jumbo netpacket)	*/
 #endif
 
 #define	BP_MINB	8		/* Minimum buffer size in bytes		*/
@@ -18,7 +19,18 @@ struct	bpentry	{		/* Description of a single buffer pool	*/
 	sid32	bpsem;		/* semaphore that counts buffers	*/
 				/*    currently available in the pool	*/
 	uint32	bpsize;		/* size of buffers in this pool		*/
+	int32	bpnbufs;	/* total number of buffers in the pool	*/
+	int32	bpmaxused;	/* most buffers ever allocated at once	*/
+	uint32	bpexhaust;	/* times a request found the pool empty	*/
+	sid32	bpnsem;		/* getbufs callers waiting for enough	*/
+	int32	bpnwait;	/*    buffers to be freed		*/
 	};
 
+/* Number of buffers currently allocated from a pool (the semaphore	*/
+/*   count is negative when processes are waiting for a buffer)		*/
+
+#define	bpused(bpptr)	((bpptr)->bpnbufs - (semtab[(bpptr)->bpsem].scount > 0 \
+			? semtab[(bpptr)->bpsem].scount : 0))
+
 extern	struct	bpentry buftab[];/* Buffer pool table			*/
 extern	bpid32	nbpools;	/* current number of allocated pools	*/
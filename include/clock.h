@@ -11,6 +11,7 @@
 
 extern	uint32	clktime;		/* second since system boot	*/
 extern  uint32	count1000;		/* ticks since clktime		*/
+extern	uint32	ctr1000;		/* milliseconds since boot	*/
 
 extern	qid16	sleepq;			/* queue for sleeping processes	*/
 extern	uint32	preempt;		/* preemption counter		*/
@@ -175,6 +175,8 @@ static 	inline 	uint32 	eth_io_readl(
 #define E1000_RCTL_BAM 		0x00008000 	/* broadcast enable 	*/
 #define E1000_RCTL_SZ_2048 	0x00000000 	/* rx buffer size 2048 	*/
 #define E1000_RCTL_SZ_4096 	0x00030000 	/* rx buffer size 4096 	*/
+#define E1000_RCTL_SZ_8192 	0x00020000 	/* rx buffer size 8192 	*/
+#define E1000_RCTL_SZ_16384 	0x00010000 	/* rx buffer size 16384	*/
 #define E1000_RCTL_DPF 		0x00400000 	/* discard pause frames */
 #define E1000_RCTL_PMCF 	0x00800000 	/* pass MAC control 	*/
 						/* 	frames 		*/
@@ -24,16 +24,35 @@ struct	etherPkt {
 
 /* Ethernet DMA buffer sizes */
 
+#ifndef	ETH_MTU
 #define	ETH_MTU			1500	/* Maximum transmission unit	*/
+#endif
+
+#if	ETH_MTU < 1500 || ETH_MTU > 9000
+#error	"ETH_MTU must be between 1500 and 9000"
+#endif
+
 #define	ETH_VLAN_LEN		4	/* Length of Ethernet vlan tag	*/
 #define ETH_CRC_LEN		4	/* Length of CRC on Ethernet 	*/
 					/*   frame			*/
 
 #define	ETH_MAX_PKT_LEN	( ETH_HDR_LEN + ETH_VLAN_LEN + ETH_MTU )
 
-#define	ETH_BUF_SIZE		2048	/* A multiple of 16 greater 	*/
-					/*   than the max packet 	*/
-					/*   size (for cache alignment)	*/
+/* A DMA buffer is the smallest receive buffer size the NIC supports	*/
+/*   that holds a maximum-size frame and its CRC (frames longer than	*/
+/*   a standard frame also require long packet receive)		*/
+
+#if	ETH_MAX_PKT_LEN + ETH_CRC_LEN <= 2048
+#define	ETH_BUF_SIZE		2048
+#elif	ETH_MAX_PKT_LEN + ETH_CRC_LEN <= 4096
+#define	ETH_BUF_SIZE		4096
+#elif	ETH_MAX_PKT_LEN + ETH_CRC_LEN <= 8192
+#define	ETH_BUF_SIZE		8192
+#else
+#define	ETH_BUF_SIZE		16384
+#endif
+
+#define	ETH_JUMBO		(ETH_MTU > 1500)/* Jumbo frames in use?	*/
 
 /* State of the Ethernet interface */
 
@@ -0,0 +1,21 @@
+/* iovec.h - definitions for vectored I/O */
+
+/************************************************************************/
+/*									*/
+/*   readv and writev transfer data between a device and a vector of	*/
+/* buffers in one call, as if the buffers were concatenated: a	*/
+/* driver gathers the buffers of writev into one transfer and		*/
+/* scatters the data of one transfer (e.g., one packet or one line)	*/
+/* across the buffers of readv.  A driver without its own functions	*/
+/* uses ioreadv and iowritev, which call its read and write function	*/
+/* once per buffer.  Block devices, whose read and write take a block	*/
+/* number rather than a count, use ioerr.				*/
+/*									*/
+/************************************************************************/
+
+#define	IOV_MAX		16		/* Max. buffers in one vector	*/
+
+struct	iovec	{			/* One buffer of a vector	*/
+	char	*iov_base;		/* Address of the buffer	*/
+	uint32	iov_len;		/* Number of bytes		*/
+};
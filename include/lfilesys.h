@@ -11,20 +11,35 @@
 /* replace the bytes, and then write the sector back to disk.  Xinu's	*/
 /* local file system divides the disk as follows: sector 0 is a 	*/
 /* directory, the next K sectors constitute an index area, and the	*/
-/* remaining sectors comprise a data area. The data area is easiest to	*/
-/* understand: each sector holds one data block (d-block) that stores	*/
-/* contents from one of the files (or is on a free list of unused data	*/
-/* blocks).  We think of the index area as holding an array of index	*/
-/* blocks (i-blocks) numbered 0 through I-1.  A given sector in the	*/
-/* index area holds 7 of the index blocks, which are each 72 bytes	*/
-/* long.  Given an i-block number, the file system must calculate the	*/
-/* disk sector in which the i-block is located and the byte offset	*/
-/* within the sector at which the i-block resides.  Internally, a file	*/
-/* is known by the i-block index of the first i-block for the file.	*/
-/* The directory contains a list of file names and the	i-block number	*/
-/* of the first i-block for the file.  The directory also holds the	*/
-/* i-block number for a list of free i-blocks and a data block number	*/
-/* of the first data block on a list of free data blocks.		*/
+/* remaining sectors comprise a bitmap area followed by a data area.	*/
+/* The data area is divided into data blocks (d-blocks) of 512 bytes	*/
+/* or, when the file system is created with a larger block size, of	*/
+/* up to 4096 bytes (8 consecutive sectors).  Each d-block stores	*/
+/* contents from one of the files or is unused.  The bitmap area holds	*/
+/* one bit per d-block that is set when the d-block is in use; the	*/
+/* file system keeps a copy of the bitmap in memory and writes changed	*/
+/* bitmap sectors back in batches.  We think of the index area as	*/
+/* holding an array of index blocks (i-blocks) numbered 0 through I-1.	*/
+/* A given sector in the index area holds 7 of the index blocks, which	*/
+/* are each 72 bytes long.  Given an i-block number, the file system	*/
+/* must calculate the disk sector in which the i-block is located and	*/
+/* the byte offset within the sector at which the i-block resides.	*/
+/* An i-block describes part of a file as a list of extents, each of	*/
+/* which is a run of d-blocks that are contiguous on disk, so a file	*/
+/* whose blocks were allocated in sequence needs one i-block no matter	*/
+/* how large it is.  Internally, a file is known by the i-block index	*/
+/* of the first i-block for the file.  Directories are files that hold	*/
+/* a hash table of 32-byte slots: slot 0 is a header, and each other	*/
+/* slot is free, holds the name, size, type, and first i-block of a	*/
+/* file or subdirectory, or marks an entry that has been deleted.  A	*/
+/* name is found by hashing it and probing successive slots, and a	*/
+/* directory is rebuilt with twice as many slots when it becomes three	*/
+/* quarters full, so lookup cost does not depend on the number of	*/
+/* files.  A cache in memory maps a directory and name to the slot	*/
+/* that holds the entry.  Sector 0 (called the directory sector for	*/
+/* historical reasons) holds the first i-block of the root directory,	*/
+/* the i-block number for a list of free i-blocks, the d-block size,	*/
+/* and the location and size of the bitmap and data areas.		*/
 /*									*/
 /************************************************************************/
 
@@ -39,33 +54,44 @@
 #define	LF_MODE_N	F_MODE_N	/* Mode bit for "new"		*/
 
 #define	LF_BLKSIZ	512		/* Assumes 512-byte disk blocks	*/
-#define	LF_NAME_LEN	16		/* Length of name plus null	*/
-#define	LF_NUM_DIR_ENT	20		/* Num. of files in a directory	*/
+#define	LF_MAXBSIZ	4096		/* Largest d-block size		*/
+#define	LF_NAME_LEN	20		/* Length of one component of a	*/
+					/*   path name plus null	*/
+#define	LF_VERSION	3		/* On-disk layout version	*/
 
 #define	LF_FREE		0		/* Slave device is available	*/
 #define	LF_USED		1		/* Slave device is in use	*/
 
 #define	LF_INULL	(ibid32) -1	/* Index block null pointer	*/
 #define	LF_DNULL	(dbid32) -1	/* Data block null pointer	*/
-#define	LF_IBLEN	16		/* Data block ptrs per i-block	*/
-#define	LF_IDATA	8192		/* Bytes of data indexed by a	*/
-					/*   single index block		*/
-#define	LF_IMASK	0x00001fff	/* Mask for the data indexed by	*/
-					/*   one index block (i.e.,	*/
-					/*   bytes 0 through 8191).	*/
-#define	LF_DMASK	0x000001ff	/* Mask for the data in a data	*/
-					/*   block (0 through 511)	*/
+#define	LF_NEXTENT	8		/* Extents per i-block		*/
+#define	LF_NIBMAP	32		/* I-blocks of an open file	*/
+					/*   recorded for fast lookup	*/
+#define	LF_DMASK	0x000001ff	/* Mask for the data in a disk	*/
+					/*   sector (0 through 511)	*/
 
 #define	LF_AREA_IB	1		/* First sector of i-blocks	*/
 #define	LF_AREA_DIR	0		/* First sector of directory	*/
 
+#define	LF_BMBITS	(LF_BLKSIZ * 8)	/* D-blocks per bitmap sector	*/
+#define	LF_BMBATCH	32		/* Bitmap changes that trigger	*/
+					/*   a write of the bitmap	*/
+
+/* Structure of an extent: a run of d-blocks contiguous on disk */
+
+struct	lfext		{		/* Format of an extent		*/
+	dbid32		ex_start;	/* First sector of the run	*/
+	uint32		ex_len;		/* Number of d-blocks in the run*/
+					/*   (0 for an unused extent)	*/
+};
+
 /* Structure of an index block on disk */
 
 struct	lfiblk		{		/* Format of index block	*/
 	ibid32		ib_next;	/* Address of next index block	*/
-	uint32		ib_offset;	/* First data byte of the file	*/
-					/*  Indexed by this i-block	*/
-	dbid32		ib_dba[LF_IBLEN];/* Ptrs to data blocks indexed	*/
+	uint32		ib_offset;	/* First d-block of the file	*/
+					/*  indexed by this i-block	*/
+	struct	lfext	ib_ext[LF_NEXTENT];/* Extents in file order	*/
 };
 
 /* File System ID */
@@ -83,25 +109,83 @@ struct	lfiblk		{		/* Format of index block	*/
 
 #define	ib2disp(ib)	(((ib)%7)*sizeof(struct lfiblk))
 
+/* I-block cache: recently used i-blocks are kept in memory, and	*/
+/*   changed ones are written back a sector at a time		*/
+
+#define	LF_NIBCACHE	32		/* Entries in the cache		*/
+#define	LF_IBCWAYS	4		/* Entries an i-block can occupy*/
+
+struct	lfibcent {			/* Entry in the i-block cache	*/
+	ibid32	ic_inum;		/* I-block held or LF_INULL	*/
+	bool8	ic_dirty;		/* Changed since it was read?	*/
+	uint32	ic_time;		/* Time of last use		*/
+	struct	lfiblk	ic_iblk;	/* Copy of the i-block		*/
+};
+
+/* The cache is used once a file system is mounted on the disk */
+
+#define	lfibcached(dev)	(Lf_data.lf_dirpresent && \
+			 ((dev) == Lf_data.lf_dskdev))
+
+/* Number of bitmap sectors needed for a given number of d-blocks */
+
+#define	lfbmsects(nd)	(((nd)+(LF_BMBITS-1))/LF_BMBITS)
+
+/* Directory slots */
+
+#define	LF_DSLOT	32		/* Bytes in a directory slot	*/
+#define	LF_DMINSLOTS	16		/* Slots in a new directory	*/
+
+#define	LF_TFREE	0		/* Slot has never been used	*/
+#define	LF_TFILE	1		/* Slot holds a file		*/
+#define	LF_TDIR		2		/* Slot holds a directory	*/
+#define	LF_TDEL		3		/* Slot held an entry that was	*/
+					/*   deleted (keeps the probe	*/
+					/*   sequence of other names)	*/
 
 /* Structure used in each directory entry for the local file system */
 
 struct	ldentry	{			/* Description of entry for one	*/
 					/*   file in the directory	*/
 	uint32	ld_size;		/* Curr. size of file in bytes	*/
+					/*   (0 for a directory)	*/
 	ibid32	ld_ilist;		/* ID of first i-block for file	*/
 					/*   or IB_NULL for empty file	*/
+	byte	ld_type;		/* LF_TFREE, LF_TFILE, etc.	*/
+	byte	ld_unused[3];		/* Pad entry to one slot	*/
 	char	ld_name[LF_NAME_LEN];	/* Null-terminated file name	*/
 };
 
-/* Structure of a data block when on the free list on disk */
+/* Header kept in slot 0 of each directory */
 
-struct	lfdbfree {
-	dbid32	lf_nextdb;		/* Next data block on the list	*/
-	char	lf_unused[LF_BLKSIZ - sizeof(dbid32)];
+struct	ldhdr	{			/* Directory header		*/
+	uint32	dh_nslots;		/* Slots in the directory,	*/
+					/*   including the header	*/
+	uint32	dh_nlive;		/* Slots that hold an entry	*/
+	uint32	dh_nused;		/* Slots that hold an entry or	*/
+					/*   mark a deleted one		*/
+	ibid32	dh_parent;		/* First i-block of the parent	*/
+	char	dh_unused[LF_DSLOT - 16];/* Pad header to one slot	*/
 };
 
-/* Format of the file system directory, either on disk or in memory */
+/* Dentry cache: maps a directory and a name to the slot holding the	*/
+/*   entry (and, for a subdirectory, to its first i-block)		*/
+
+#define	LF_NDCACHE	64		/* Entries in the cache		*/
+#define	LF_DCWAYS	4		/* Entries a name can occupy	*/
+
+struct	lfdcent	{			/* Entry in the dentry cache	*/
+	ibid32	dc_dir;			/* Directory holding the name	*/
+					/*   or LF_INULL if unused	*/
+	int32	dc_slot;		/* Slot that holds the entry	*/
+	ibid32	dc_ilist;		/* First i-block of a directory	*/
+	byte	dc_type;		/* Type of the entry		*/
+	uint32	dc_time;		/* Time of last use		*/
+	char	dc_name[LF_NAME_LEN];	/* Name in the entry		*/
+};
+
+/* Format of the file system directory sector, either on disk or in	*/
+/*   memory								*/
 
 #pragma pack(2)
 struct	lfdir	{			/* Entire directory on disk	*/
@@ -110,10 +194,13 @@ struct	lfdir	{			/* Entire directory on disk	*/
 	int16	lfd_subvers;		/* File system subversion	*/
 	uint32	lfd_allzeros;		/* All 0 bits			*/
 	uint32	lfd_allones;		/* All 1 bits			*/
-	dbid32	lfd_dfree;		/* List of free d-blocks on disk*/
+	uint32	lfd_bmsect;		/* First sector of the bitmap	*/
+	dbid32	lfd_dstart;		/* First sector of data area	*/
+	uint32	lfd_ndblks;		/* Number of d-blocks on disk	*/
+	uint32	lfd_blksiz;		/* Bytes in a d-block		*/
 	ibid32	lfd_ifree;		/* List of free i-blocks on disk*/
-	int32	lfd_nfiles;		/* Current number of files	*/
-	struct	ldentry lfd_files[LF_NUM_DIR_ENT]; /* Set of files	*/
+	ibid32	lfd_root;		/* First i-block of the root	*/
+	char	lfd_unused[468];	/* Pad directory to one sector	*/
 	uint32	lfd_revid;		/* fsysid in reverse byte order	*/
 };
 #pragma pack()
@@ -122,12 +209,25 @@ struct	lfdir	{			/* Entire directory on disk	*/
 
 struct	lfdata	{			/* Local file system data	*/
 	did32	lf_dskdev;		/* Device ID of disk to use	*/
-	sid32	lf_mutex;		/* Mutex for the directory and	*/
-					/*   index/data free lists	*/
+	sid32	lf_mutex;		/* Mutex for the directory,	*/
+					/*   i-block free list, and	*/
+					/*   d-block bitmap		*/
 	struct	lfdir	lf_dir;		/* In-memory copy of directory	*/
 	bool8	lf_dirpresent;		/* True when directory is in	*/
 					/*   memory (1st file is open)	*/
 	bool8	lf_dirdirty;		/* Has the directory changed?	*/
+	uint32	lf_spb;			/* Sectors in a d-block		*/
+	byte	*lf_dbmap;		/* In-memory d-block bitmap	*/
+	uint32	lf_dbfree;		/* Number of free d-blocks	*/
+	int32	lf_bmnchg;		/* Bitmap changes not yet	*/
+					/*   written to disk		*/
+	uint32	lf_bmlo;		/* First and last bitmap sector	*/
+	uint32	lf_bmhi;		/*   changed since last write	*/
+	struct	lfdcent	lf_dcache[LF_NDCACHE];/* Dentry cache		*/
+	uint32	lf_dcclock;		/* Counter used to age entries	*/
+	struct	lfibcent lf_ibcache[LF_NIBCACHE];/* I-block cache	*/
+	uint32	lf_icclock;		/* Counter used to age entries	*/
+	int32	lf_icndirty;		/* Changed i-blocks in cache	*/
 };
 
 /* Control block for local file pseudo-device */
@@ -137,20 +237,27 @@ struct	lflcblk	{			/* Local file control block	*/
 	byte	lfstate;		/* Is entry free or used	*/
 	did32	lfdev;			/* Device ID of this device	*/
 	sid32	lfmutex;		/* Mutex for this file		*/
-	struct	ldentry	*lfdirptr;	/* Ptr to file's entry in the	*/
-					/*   in-memory directory	*/
+	struct	ldentry	*lfdirptr;	/* Ptr to lfdent		*/
+	struct	ldentry	lfdent;		/* Copy of the file's entry	*/
+	ibid32	lfpdir;			/* Directory holding the entry	*/
+	int32	lfslot;			/* Slot of the entry, or -1 for	*/
+					/*   a directory opened to read	*/
+	bool8	lfdedirty;		/* Has lfdent changed?		*/
 	int32	lfmode;			/* Mode (read/write/both)	*/
 	uint32	lfpos;			/* Byte position of next byte	*/
 					/*   to read or write		*/
-	char	lfname[LF_NAME_LEN];	/* Name of the file		*/
 	ibid32	lfinum;			/* ID of current index block in	*/
 					/*   lfiblock or LF_INULL	*/
 	struct	lfiblk	lfiblock;	/* In-mem copy of current index	*/
 					/*   block			*/
-	dbid32	lfdnum;			/* Number of current data block	*/
-					/*   in lfdblock or LF_DNULL	*/
-	char	lfdblock[LF_BLKSIZ];	/* In-mem copy of current data	*/
-					/*   block			*/
+	ibid32	lfibmap[LF_NIBMAP];	/* The file's first i-blocks	*/
+	uint32	lfibfbn[LF_NIBMAP];	/* First d-block of the file	*/
+					/*   indexed by each of them	*/
+	int32	lfnibmap;		/* Entries used in lfibmap	*/
+	dbid32	lfdnum;			/* Sector of current data in	*/
+					/*   lfdblock or LF_DNULL	*/
+	char	lfdblock[LF_BLKSIZ];	/* In-mem copy of current	*/
+					/*   sector of data		*/
 	char	*lfbyte;		/* Ptr to byte in lfdblock or	*/
 					/*   address one beyond lfdblock*/
 					/*   if current file pos lies	*/
@@ -166,4 +273,6 @@ extern	struct	lflcblk	lfltab[];
 
 #define	LF_CTL_DEL	F_CTL_DEL	/* Delete a file		*/
 #define	LF_CTL_TRUNC	F_CTL_TRUNC	/* Truncate a file		*/
+#define	LF_CTL_MKDIR	F_CTL_MKDIR	/* Make a directory		*/
+#define	LF_CTL_RMDIR	F_CTL_RMDIR	/* Remove a directory		*/
 #define LF_CTL_SIZE	F_CTL_SIZE	/* Obtain the size of a file	*/
@@ -6,6 +6,9 @@
 #define	NM_REPLLEN	96		/* Maximum size of a replacement*/
 #define	NM_MAXLEN	256		/* Maximum size of a file name	*/
 #define	NNAMES		128		/* Number of prefix definitions	*/
+#define	NM_NNODES	1024		/* Nodes in the prefix trie	*/
+#define	NM_NCACHE	8		/* Names in the resolved-name	*/
+					/*   cache			*/
 
 /* Definition of the name prefix table that defines all name mappings */
 
@@ -17,3 +20,43 @@ struct	nmentry	{			/* Definition of prefix table	*/
 
 extern	struct	nmentry	nametab[];	/* Table of name mappings	*/
 extern	int32	nnames;			/* Number of entries allocated	*/
+
+/* The prefixes in nametab are compiled into a trie, kept as a first-	*/
+/*   child / next-sibling tree rooted at namtrie[0] (the empty prefix),	*/
+/*   so namrepl finds the longest matching prefix in one pass over	*/
+/*   the name.  When two entries have the same prefix, the one mounted	*/
+/*   first is used.							*/
+
+struct	nmnode	{			/* Node of the prefix trie	*/
+	char	nn_ch;			/* Last character of the prefix	*/
+					/*   the node represents	*/
+	int16	nn_entry;		/* Index in nametab of the	*/
+					/*   prefix ending here, or -1	*/
+	int16	nn_child;		/* First child, or -1		*/
+	int16	nn_sibling;		/* Next sibling, or -1		*/
+};
+
+extern	struct	nmnode	namtrie[];	/* The prefix trie		*/
+extern	int32	nnodes;			/* Number of nodes allocated	*/
+
+/* Cache of the final results of nammap, emptied whenever the trie	*/
+/*   changes								*/
+
+struct	nmcent	{			/* Entry in the cache		*/
+	uint32	nc_hash;		/* Hash of the original name	*/
+	did32	nc_namdev;		/* Namespace device mapped from	*/
+	did32	nc_dev;			/* Device the name maps to	*/
+	char	nc_name[NM_MAXLEN];	/* Original name		*/
+	char	nc_newname[NM_MAXLEN];	/* Mapped name			*/
+};
+
+struct	nmcache	{			/* Resolved-name cache		*/
+	int32	nc_count;		/* Entries in use		*/
+	int32	nc_next;		/* Entry to replace next	*/
+	uint32	nc_gen;			/* Changes to the trie		*/
+	uint32	nc_hits;		/* Names found in the cache	*/
+	uint32	nc_misses;		/* Names mapped through the trie*/
+	struct	nmcent	nc_ent[NM_NCACHE];/* The entries		*/
+};
+
+extern	struct	nmcache	Nam_cache;
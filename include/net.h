@@ -10,6 +10,11 @@
 #define	ETH_IP      0x0800		/* Ethernet type for IP		*/
 #define	ETH_IPv6    0x86DD		/* Ethernet type for IPv6	*/
 
+/* Largest UDP or ICMP payload that fits in one frame: the MTU less	*/
+/*   the 20-octet IP header and the 8-octet UDP or ICMP header		*/
+
+#define	NET_MAXDATA	(ETH_MTU - 28)
+
 /* Format of an Ethernet packet carrying IPv4 and UDP */
 
 #pragma pack(2)
@@ -33,7 +38,7 @@ struct	netpacket	{
 	  uint16	net_udpdport;	/* UDP destination protocol port*/
 	  uint16	net_udplen;	/* UDP total length		*/
 	  uint16	net_udpcksum;	/* UDP checksum			*/
-	  byte		net_udpdata[1500-28];/* UDP payload (1500-above)*/
+	  byte		net_udpdata[NET_MAXDATA];/* UDP payload	*/
 	 };
 	 struct {
 	  byte		net_ictype;	/* ICMP message type		*/
@@ -41,7 +46,7 @@ struct	netpacket	{
 	  uint16	net_iccksum;	/* ICMP message checksum	*/
 	  uint16	net_icident; 	/* ICMP identifier		*/
 	  uint16	net_icseq;	/* ICMP sequence number		*/
-	  byte		net_icdata[1500-28];/* ICMP payload (1500-above)*/
+	  byte		net_icdata[NET_MAXDATA];/* ICMP payload	*/
 	 };
 	};
 };
@@ -51,6 +56,38 @@ struct	netpacket	{
 
 extern	bpid32	netbufpool;		/* ID of net packet buffer pool	*/
 
+/* Input queues: netin only classifies an incoming packet and deposits	*/
+/*   it on the queue for its protocol; a worker process per queue runs	*/
+/*   the protocol code, so control-plane traffic (ARP, ICMP) is not	*/
+/*   delayed behind data-plane traffic (UDP) and vice versa		*/
+
+#define	NETQ_ARP	0		/* Queue for ARP packets	*/
+#define	NETQ_ICMP	1		/* Queue for ICMP datagrams	*/
+#define	NETQ_UDP	2		/* Queue for other IP datagrams	*/
+#define	NETQ_NUM	3		/* Number of input queues	*/
+
+#define	NETQ_SIZ	16		/* Packets per input queue	*/
+
+#define	NETQ_CTLPRIO	(NETPRIO-10)	/* Priority of ARP/ICMP workers	*/
+#define	NETQ_DATPRIO	(NETPRIO-20)	/* Priority of the UDP worker	*/
+
+struct	netqentry {			/* Entry in the input queue tbl	*/
+	char	*nqname;		/* Name of the worker process	*/
+	pri16	nqprio;			/* Priority of the worker	*/
+	void	(*nqfunc)(struct netpacket *);/* Protocol input function*/
+	pid32	nqpid;			/* ID of the worker process	*/
+	sid32	nqsem;			/* Semaphore that counts pkts	*/
+	int32	nqhead;			/* Index of next packet to take	*/
+	int32	nqtail;			/* Index of next free slot	*/
+	int32	nqcount;		/* Packets now enqueued		*/
+	int32	nqmax;			/* Most packets ever enqueued	*/
+	uint32	nqpkts;			/* Total packets enqueued	*/
+	uint32	nqdrops;		/* Packets dropped (queue full)	*/
+	struct	netpacket *nqbuf[NETQ_SIZ];/* Circular packet queue	*/
+};
+
+extern	struct	netqentry netqtab[];	/* Table of input queues	*/
+
 struct	network	{			/* Network information		*/
 	uint32	ipucast;		/* Computer's IP unicast address*/
 	uint32	ipbcast;		/* IP broadcast address		*/
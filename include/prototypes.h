@@ -17,6 +17,69 @@ extern	void	arp_hton(struct arppacket *);
 /* in file ascdate.c */
 extern	status	ascdate(uint32, char *);
 
+/* in file bcflush.c */
+extern	status	bcflush(struct bcbuf *);
+
+/* in file bcflushd.c */
+extern	process	bcflushd(void);
+
+/* in file bcget.c */
+extern	struct	bcbuf	*bcget(did32, uint32, bool8);
+
+/* in file bcinit.c */
+extern	status	bcinit(void);
+
+/* in file bcinval.c */
+extern	void	bcinval(did32);
+
+/* in file bcread.c */
+extern	status	bcread(did32, char *, uint32);
+
+/* in file bcrelse.c */
+extern	void	bcrelse(struct bcbuf *, bool8);
+
+/* in file bcsync.c */
+extern	status	bcsync(did32);
+
+/* in file bcwback.c */
+extern	void	bcwback(did32, bool8);
+
+/* in file bcwrite.c */
+extern	status	bcwrite(did32, char *, uint32);
+
+/* in file biodone.c */
+extern	void	biodone(struct bioreq *, uint32, status);
+
+/* in file bioemul.c */
+extern	devcall	bioemul(struct dentry *, struct bioreq *);
+
+/* in file bioinit.c */
+extern	status	bioinit(void);
+
+/* in file bioplug.c */
+extern	syscall	bioplug(did32);
+
+/* in file bioprep.c */
+extern	void	bioprep(struct bioreq *, int32, uint32, uint32, char *);
+
+/* in file bioqrun.c */
+extern	void	bioqrun(did32);
+
+/* in file bioread.c */
+extern	syscall	bioread(did32, char *, uint32, uint32);
+
+/* in file biosubmit.c */
+extern	syscall	biosubmit(did32, struct bioreq *);
+
+/* in file biounplug.c */
+extern	syscall	biounplug(did32);
+
+/* in file biowait.c */
+extern	syscall	biowait(struct bioreq *);
+
+/* in file biowrite.c */
+extern	syscall	biowrite(did32, char *, uint32, uint32);
+
 /* in file bufinit.c */
 extern	status	bufinit(void);
 
@@ -91,9 +154,15 @@ extern	devcall	ethinit(struct dentry *);
 /* in file ethread.c */
 extern	devcall	ethread(struct dentry *, char *, int32);
 
+/* in file ethreadv.c */
+extern	devcall	ethreadv(struct dentry *, struct iovec *, int32);
+
 /* in file ethwrite.c */
 extern	devcall	ethwrite(struct dentry *, void *, int32);
 
+/* in file ethwritev.c */
+extern	devcall	ethwritev(struct dentry *, struct iovec *, int32);
+
 /* in file evec.c */
 extern	int32	initevec(void);
 extern	int32	set_evec(uint32, uint32);
@@ -108,12 +177,21 @@ extern void pagefault_handler(void);
 /* in file freebuf.c */
 extern	syscall	freebuf(char *);
 
+/* in file freebufs.c */
+extern	syscall	freebufs(char *[], int32);
+
 /* in file freemem.c */
 extern	syscall	freemem(char *, uint32);
 
 /* in file getbuf.c */
 extern	char	*getbuf(bpid32);
 
+/* in file getbuf_nb.c */
+extern	char	*getbuf_nb(bpid32);
+
+/* in file getbufs.c */
+extern	syscall	getbufs(bpid32, int32, char *[]);
+
 /* in file getc.c */
 extern	syscall	getc(did32);
 
@@ -192,6 +270,12 @@ extern	devcall	ioerr(void);
 /* in file ionull.c */
 extern	devcall	ionull(void);
 
+/* in file ioreadv.c */
+extern	devcall	ioreadv(struct dentry *, struct iovec *, int32);
+
+/* in file iowritev.c */
+extern	devcall	iowritev(struct dentry *, struct iovec *, int32);
+
 /* in file ip.c */
 extern	void	ip_in(struct netpacket *);
 extern	status	ip_send(struct netpacket *);
@@ -207,6 +291,8 @@ extern	status	ip_enqueue(struct netpacket *);
 /* in file net.c */
 extern	void	net_init(void);
 extern	process	netin(void);
+extern	void	netq_enqueue(int32, struct netpacket *);
+extern	process	netqin(int32);
 extern	process	netout(void);
 extern	process	rawin(void);
 extern	void	eth_hton(struct netpacket *);
@@ -219,6 +305,12 @@ extern	syscall	kill(pid32);
 /* in file lexan.c */
 extern	int32	lexan(char *, int32, char *, int32 *, int32 [], int32 []);
 
+/* in file lfibcfcns.c */
+extern	struct	lfibcent *lfibcfind(ibid32);
+extern	struct	lfibcent *lfibcnew(ibid32);
+extern	status	lfibcwback(uint32);
+extern	status	lfibsync(void);
+
 /* in file lfibclear.c */
 extern	void	lfibclear(struct lfiblk *, int32);
 
@@ -232,7 +324,42 @@ extern	status	lfibput(did32, ibid32, struct lfiblk *);
 extern	status	lfdbfree(did32, dbid32);
 
 /* in file lfdballoc.c */
-extern	dbid32	lfdballoc(struct lfdbfree *);
+extern	dbid32	lfdballoc(dbid32);
+
+/* in file lfbmap.c */
+extern	dbid32	lfbmap(ibid32, uint32, bool8);
+
+/* in file lfbmflush.c */
+extern	status	lfbmflush(void);
+
+/* in file lfbmload.c */
+extern	status	lfbmload(void);
+
+/* in file lfdcfcns.c */
+extern	int32	lfdcfind(ibid32, char *, ibid32 *, byte *);
+extern	void	lfdcadd(ibid32, int32, struct ldentry *);
+extern	void	lfdcinval(ibid32, char *);
+
+/* in file lfdget.c */
+extern	status	lfdget(ibid32, int32, struct ldentry *);
+
+/* in file lfdgrow.c */
+extern	status	lfdgrow(ibid32);
+
+/* in file lfdhash.c */
+extern	uint32	lfdhash(char *);
+
+/* in file lfdinsert.c */
+extern	int32	lfdinsert(ibid32, struct ldentry *);
+
+/* in file lfdlookup.c */
+extern	int32	lfdlookup(ibid32, char *, struct ldentry *);
+
+/* in file lfdput.c */
+extern	status	lfdput(ibid32, int32, struct ldentry *);
+
+/* in file lfdremove.c */
+extern	status	lfdremove(ibid32, int32);
 
 /* in file lfflush.c */
 extern	status	lfflush(struct lflcblk *);
@@ -243,6 +370,9 @@ extern	int32	lfgetmode(char *);
 /* in file lfiballoc.c */
 extern	ibid32	lfiballoc(void);
 
+/* in file lfilfree.c */
+extern	status	lfilfree(ibid32);
+
 /* in file lflclose.c */
 extern	devcall	lflclose(struct dentry *);
 
@@ -261,21 +391,36 @@ extern	devcall	lflputc(struct dentry *, char);
 /* in file lflread.c */
 extern	devcall	lflread(struct dentry *, char *, int32);
 
+/* in file lflreadv.c */
+extern	devcall	lflreadv(struct dentry *, struct iovec *, int32);
+
 /* in file lflseek.c */
 extern	devcall	lflseek(struct dentry *, uint32);
 
 /* in file lflwrite.c */
 extern	devcall	lflwrite(struct dentry *, char *, int32);
 
+/* in file lflwritev.c */
+extern	devcall	lflwritev(struct dentry *, struct iovec *, int32);
+
+/* in file lfpath.c */
+extern	status	lfpath(char *, ibid32 *, char *);
+
 /* in file lfscheck.c */
 extern	status	lfscheck(struct lfdir *);
 
 /* in file lfscreate.c */
-extern  status  lfscreate(did32, ibid32, uint32);
+extern  status  lfscreate(did32, ibid32, uint32, uint32);
+
+/* in file lfscontrol.c */
+extern	devcall	lfscontrol(struct dentry *, int32, int32, int32);
 
 /* in file lfsinit.c */
 extern	devcall	lfsinit(struct dentry *);
 
+/* in file lfsmount.c */
+extern	status	lfsmount(void);
+
 /* in file lfsopen.c */
 extern	devcall	lfsopen(struct dentry *, char *, char *);
 
@@ -334,6 +479,10 @@ extern	status	namcpy(char *, char *, int32);
 /* in file namopen.c */
 extern	devcall	namopen(struct dentry *, char *, char *);
 
+/* in file namtrie.c */
+extern	status	namtinsert(int32);
+extern	status	namtbuild(void);
+
 /* in file newqueue.c */
 extern	qid16	newqueue(void);
 
@@ -387,9 +536,15 @@ extern	int32	quark_irq_routing(void);
 extern	pid32	enqueue(pid32, qid16);
 extern	pid32	dequeue(qid16);
 
+/* in file rambio.c */
+extern	devcall	rambio(struct dentry *, struct bioreq *);
+
 /* in file ramclose.c */
 extern	devcall	ramclose(struct dentry *);
 
+/* in file ramcontrol.c */
+extern	devcall	ramcontrol(struct dentry *, int32, int32, int32);
+
 /* in file raminit.c */
 extern	devcall	raminit(struct dentry *);
 
@@ -402,6 +557,9 @@ extern	devcall	ramread(struct dentry *, char *, int32);
 /* in file ramwrite.c */
 extern	devcall	ramwrite(struct dentry *, char *, int32);
 
+/* in file rdsbio.c */
+extern	devcall	rdsbio(struct dentry *, struct bioreq *);
+
 /* in file rdscomm.c */
 
 extern	status	rdscomm(struct rd_msg_hdr *, int32, struct rd_msg_hdr *, int32, struct rdscblk *);
@@ -424,16 +582,25 @@ extern	void	rdsprocess(struct rdscblk *);
 
 /* in file rdsqfcns.c */
 
+extern	struct	rdqnode	* rdqremove(struct rdscblk *, struct rdqnode *);
 extern	struct	rdqnode	* rdqunlink(struct rdscblk *rdptr, struct rdqnode *rptr);
 extern	void	rdqinsert(struct rdscblk *, struct rdqnode *);
+extern	struct	rdcnode	* rdclookup(struct rdscblk *, uint32);
 extern	void	rdcunlink(struct rdscblk *, struct rdcnode *);
-extern	void	rdcinsert(struct rdscblk *, uint32, char *);
+extern	void	rdcmru(struct rdscblk *, struct rdcnode *);
+extern	struct	rdcnode	* rdcalloc(struct rdscblk *, uint32);
+extern	struct	rdcnode	* rdcinsert(struct rdscblk *, uint32, char *);
 extern	void	edqdump(did32);
 extern	void	edcdump(did32);
 
 /* in file rdsread.c */
 
 extern	devcall	rdsread(struct dentry *, char *, int32);
+extern	bool8	rdsrlocal(struct rdscblk *, char *, uint32);
+
+/* in file rdsrecv.c */
+
+extern	process	rdsrecv(struct rdscblk *);
 
 /* in file rdssetprio.c */
 
@@ -442,6 +609,12 @@ extern	pri16	rdssetprio(pri16);
 /* in file rdswrite.c */
 
 extern	devcall	rdswrite(struct dentry *, char *, int32);
+extern	bool8	rdswlocal(struct rdscblk *, char *, uint32);
+
+/* in file rdsxmit.c */
+
+extern	status	rdsxmit(struct rdscblk *, struct rdpent *);
+extern	void	rdsxmitpend(struct rdscblk *);
 
 /* in file sdmcclose.c */
 extern	devcall	sdmcclose(struct dentry *);
@@ -464,6 +637,9 @@ extern	interrupt	sdmcdispatch(void);
 /* in file read.c */
 extern	syscall	read(did32, char *, uint32);
 
+/* in file readv.c */
+extern	syscall	readv(did32, struct iovec *, int32);
+
 /* in file ready.c */
 extern	status	ready(pid32);
 
@@ -525,6 +701,34 @@ extern	devcall	rfsopen(struct dentry  *devptr, char *, char *);
 /* in file rfscomm.c */
 extern	int32	rfscomm(struct rf_msg_hdr *, int32,
 			struct rf_msg_hdr *, int32);
+
+/* in file rfsalloc.c */
+extern	struct	rfpent	* rfsalloc(bool8);
+extern	void	rfsfree(struct rfpent *);
+
+/* in file rfssend.c */
+extern	status	rfssend(struct rfpent *, int32);
+
+/* in file rfswait.c */
+extern	int32	rfswait(struct rfpent *);
+
+/* in file rfsrecv.c */
+extern	process	rfsrecv(void);
+
+/* in file rfsmeta.c */
+extern	status	rfsmget(char *, struct rfmeta *);
+extern	void	rfsmset(char *, int32, int32, int32);
+extern	void	rfsmgrow(char *, uint32);
+extern	void	rfsminval(char *);
+
+/* in file rflpfcns.c */
+extern	struct	rfpage	* rflplookup(struct rflcblk *, uint32);
+extern	struct	rfpage	* rflpalloc(struct rflcblk *, uint32);
+extern	status	rflpfetch(struct rflcblk *, struct rfpage *, bool8);
+extern	status	rflpflush(struct rflcblk *, struct rfpage *);
+extern	void	rflpwait(struct rfpage *);
+extern	status	rflpsync(struct rflcblk *);
+extern	void	rflpinval(struct rflcblk *);
 /* in file seek.c */
 extern	syscall	seek(did32, uint32);
 
@@ -540,6 +744,9 @@ extern	syscall	semdelete(sid32);
 /* in file semreset.c */
 extern	syscall	semreset(sid32, int32);
 
+/* in file semtake.c */
+extern	syscall	semtake(sid32, int32);
+
 /* in file send.c */
 extern	syscall	send(pid32, umsg32);
 
@@ -601,9 +808,15 @@ extern	devcall	ttyputc(struct dentry *, char);
 /* in file ttyread.c */
 extern	devcall	ttyread(struct dentry *, char *, int32);
 
+/* in file ttyreadv.c */
+extern	devcall	ttyreadv(struct dentry *, struct iovec *, int32);
+
 /* in file ttywrite.c */
 extern	devcall	ttywrite(struct dentry *, char *, int32);
 
+/* in file ttywritev.c */
+extern	devcall	ttywritev(struct dentry *, struct iovec *, int32);
+
 /* in file udp.c */
 extern	void	udp_init(void);
 extern	void	udp_in(struct netpacket *);
@@ -611,12 +824,17 @@ extern	uid32	udp_register(uint32, uint16, uint16);
 extern	int32	udp_recv(uid32, char *, int32, uint32);
 extern	int32	udp_recvaddr(uid32, uint32 *, uint16 *, char *,
 			     int32, uint32);
+extern	struct	netpacket *udp_getpkt(uid32, uint32, uint16);
+extern	status	udp_sendpkt(struct netpacket *, int32);
 extern	status	udp_send(uid32, char *, int32);
 extern	status	udp_sendto(uid32, uint32, uint16, char *, int32);
 extern	status	udp_release(uid32);
 extern	void	udp_ntoh(struct netpacket *);
 extern	void	udp_hton(struct netpacket *);
 
+/* in file unmount.c */
+extern	syscall	unmount(char *);
+
 /* in file unsleep.c */
 extern	syscall	unsleep(pid32);
 
@@ -632,6 +850,9 @@ extern	void	wakeup(void);
 /* in file write.c */
 extern	syscall	write(did32, char *, uint32);
 
+/* in file writev.c */
+extern	syscall	writev(did32, struct iovec *, int32);
+
 /* in file xdone.c */
 extern	void	xdone(void);
 
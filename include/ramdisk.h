@@ -1,12 +1,37 @@
 /* ramdisk.h - definitions for a ram disk (for testing) */
 
+/************************************************************************/
+/*									*/
+/*   The disk occupies memory allocated with getmem when the device is	*/
+/* initialized: RM_BLKS blocks, or fewer if that would take more than	*/
+/* 1/RM_MEMDIV of the largest free block of memory.  The RM_CTL_RESIZE	*/
+/* control function moves the disk to a new allocation of another	*/
+/* size.  RM_CTL_BLKPTR returns the address of a range of blocks so a	*/
+/* caller can use them in place rather than copying them; the address	*/
+/* remains valid until the disk is resized.  A disk must not be	*/
+/* resized while a file system is using it.				*/
+/*									*/
+/************************************************************************/
+
 /* Ram disk block size */
 
 #define	RM_BLKSIZ	512		/* block size			*/
-#define	RM_BLKS		200		/* number of blocks		*/
+#ifndef	RM_BLKS
+#define	RM_BLKS		4096		/* number of blocks		*/
+#endif
+#define	RM_MINBLKS	200		/* fewest blocks in a disk	*/
+#define	RM_MEMDIV	4		/* disk uses at most 1/RM_MEMDIV	*/
+					/*   of the largest free block	*/
+
+/* Control functions for a ram disk */
+
+#define	RM_CTL_SIZE	1		/* Return the number of blocks	*/
+#define	RM_CTL_RESIZE	2		/* Change the number of blocks	*/
+#define	RM_CTL_BLKPTR	3		/* Return address of blocks	*/
 
 struct	ramdisk	{
-	char	disk[RM_BLKSIZ * RM_BLKS];
+	char	*disk;			/* RM_BLKSIZ * nblks bytes	*/
+	uint32	nblks;			/* number of blocks		*/
 	};
 
 extern	struct	ramdisk	Ram;
@@ -8,6 +8,17 @@
 
 #define	RD_BLKSIZ	512
 
+/* Maximum blocks in a multi-block message: as many as fit in one	*/
+/*   Ethernet frame after the IP, UDP and message headers (the IP	*/
+/*   layer does not fragment), but no more than 16			*/
+
+#define	RD_MHDRLEN	80		/* Multi-block message header	*/
+#if ((ETH_MTU - 28 - RD_MHDRLEN) / RD_BLKSIZ) > 16
+#define	RD_MAXBLKS	16
+#else
+#define	RD_MAXBLKS	((ETH_MTU - 28 - RD_MHDRLEN) / RD_BLKSIZ)
+#endif
+
 /* Global data for the remote disk server */
 
 #ifndef	RD_SERVER
@@ -24,8 +35,27 @@
 					/*   that each device is unique	*/
 #endif
 
-#define	RD_QNODES	NPROC		/* Number of request nodes	*/
-#define	RD_CNODES	32		/* Number of cache buffers	*/
+#define	RD_BIOMAX	32		/* Max. blocks of asynchronous	*/
+					/*   requests queued		*/
+#define	RD_QNODES	(NPROC+RD_RAMAX+RD_BIOMAX)/* Number of request	*/
+					/*   nodes (one per process	*/
+					/*   plus readahead and async.)	*/
+#define	RD_CNODES	256		/* Default number of cache	*/
+					/*   buffers (the mode argument	*/
+					/*   to open can override it)	*/
+#define	RD_CMAX		8192		/* Max. cache buffers		*/
+#define	RD_WBDELAY	500		/* Age (ms) at which a dirty	*/
+					/*   block is written back	*/
+#define	RD_DIRTYHI(n)	(((n)*3)/4)	/* Dirty blocks in a cache of n	*/
+					/*   that force a write back	*/
+#define	RD_RAMIN	2		/* Initial readahead window	*/
+#define	RD_RAMAX	16		/* Max. readahead window and	*/
+					/*   max. readahead requests	*/
+					/*   queued or outstanding	*/
+#define	RD_NSTREAM	4		/* Sequential streams tracked	*/
+#define	RD_WINDOW	8		/* Max. requests outstanding at	*/
+					/*   the server (at most	*/
+					/*   UDP_QSIZ)			*/
 
 
 /* Constants for remote disk device control block */
@@ -47,6 +77,7 @@
 #define	RD_OP_READ	1		/* Read operation on req. list	*/
 #define	RD_OP_WRITE	2		/* Write operation on req. list	*/
 #define	RD_OP_SYNC	3		/* Sync operation on req. list	*/
+#define	RD_OP_DEL	4		/* Delete operation on req. list*/
 
 /* Definition of a request queue node */
 
@@ -56,31 +87,99 @@ struct	rdqnode {			/* Node in the request queue	*/
 	int32	rd_op;			/* Operation - read/write/sync	*/
 	uint32	rd_blknum;		/* Disk block number requested	*/
 	char	*rd_callbuf;		/* Address of caller's buffer	*/
+	status	*rd_statp;		/* Where to store the outcome	*/
+					/*   (NULL if not wanted)	*/
 	pid32	rd_pid;			/* Process that initiated the	*/
-};					/*   request			*/
+					/*   request (-1 if none waits)	*/
+	struct	bioreq	*rd_bio;	/* Asynchronous request that	*/
+					/*   holds the block, or NULL	*/
+};
+
+/* Definition of an entry in the table of requests that have been	*/
+/*   sent to the server and await a reply (up to RD_WINDOW of them	*/
+/*   are outstanding at once and replies may arrive in any order).	*/
+/*   An entry covers a run of contiguous blocks, formed by merging	*/
+/*   adjacent queued requests.						*/
+
+#define	RD_OP_NONE	0		/* Entry is not in use		*/
+
+struct	rdpent	{			/* Outstanding request		*/
+	int32	rd_op;			/* Operation - read/write/del	*/
+	uint32	rd_seq;			/* Sequence number of request	*/
+	uint32	rd_blknum;		/* First disk block		*/
+	int32	rd_nblks;		/* Number of blocks (0 for del)	*/
+	struct	rdqnode	*rd_reqs;	/* Read or delete requests that	*/
+					/*   wait for the reply (linked	*/
+					/*   by rd_next)		*/
+	bool8	rd_xmit;		/* Waiting to be (re)sent?	*/
+	uint32	rd_sent;		/* Time of last transmission	*/
+	int32	rd_tries;		/* Number of transmissions	*/
+	char	rd_data[RD_MAXBLKS*RD_BLKSIZ];/* Data being written	*/
+};
+
+#define	rdpholds(pptr, blk)	\
+	((uint32)((blk) - (pptr)->rd_blknum) < (uint32)(pptr)->rd_nblks)
 
 /* Definition of a node in the cache */
 
 struct	rdcnode {			/* Node in the cache		*/
-	struct	rdcnode	*rd_next;	/* Pointer to next node		*/
+	struct	rdcnode	*rd_next;	/* Pointer to next node (older)	*/
 	struct	rdcnode	*rd_prev;	/* Pointer to previous node	*/
+	struct	rdcnode	*rd_hnext;	/* Next node in the hash chain	*/
 	uint32	rd_blknum;		/* Number of this disk block	*/
+	bool8	rd_dirty;		/* Must the block be written?	*/
+	bool8	rd_ra;			/* Read ahead and not yet used?	*/
+	uint32	rd_dtime;		/* Time the block became dirty	*/
 	byte	rd_data[RD_BLKSIZ];	/* Data for the disk block	*/
 };
 
+#define	rdchash(rdptr, blk)	((blk) & (rdptr)->rd_chmask)
+
+/* Definition of a sequential read stream (readahead is tracked for	*/
+/*   each process that reads, because the device has one opener)	*/
+
+struct	rdstream {			/* Entry in the stream table	*/
+	pid32	rd_spid;		/* Process reading (-1 if free)	*/
+	uint32	rd_snext;		/* Block expected next		*/
+	uint32	rd_sranext;		/* Next block to read ahead	*/
+	int32	rd_swin;		/* Readahead window in blocks	*/
+					/*   (0 after random access)	*/
+	uint32	rd_sused;		/* When last used (for reuse)	*/
+};
+
 /* Device control block for a remote disk */
 
 struct	rdscblk	{			/* Remote disk control block	*/
 	int32	rd_state;		/* State of device		*/
 	char	rd_id[RD_IDLEN];	/* Disk ID currently being used	*/
 	int32	rd_seq;			/* Next sequence number to use	*/
-	struct	rdcnode	*rd_chead;	/* Head of cache		*/
-	struct	rdcnode	*rd_ctail;	/* Tail of cache		*/
+	struct	rdcnode	*rd_chead;	/* Head of cache (most recent)	*/
+	struct	rdcnode	*rd_ctail;	/* Tail of cache (least recent)	*/
 	struct	rdcnode	*rd_cfree;	/* Free list of cache nodes	*/
+	struct	rdcnode	**rd_chash;	/* Hash table of cache nodes	*/
+	uint32	rd_chmask;		/* Hash table size - 1		*/
+	int32	rd_csize;		/* Number of cache nodes	*/
+	int32	rd_ndirty;		/* Number of dirty cache nodes	*/
+	uint32	rd_chits;		/* Reads satisfied by the cache	*/
+	uint32	rd_cmisses;		/* Reads sent to the server	*/
+	uint32	rd_cwbacks;		/* Dirty blocks written back	*/
+	uint32	rd_ccoalesce;		/* Writes to an already dirty	*/
+					/*   block (saved a write back)	*/
+	bool8	rd_werr;		/* Did a write back fail since	*/
+					/*   the last sync?		*/
+	struct	rdstream rd_stream[RD_NSTREAM];/* Sequential streams	*/
+	uint32	rd_sclock;		/* Counter for rd_sused		*/
+	int32	rd_nra;			/* Readahead requests queued or	*/
+					/*   outstanding		*/
+	uint32	rd_raissued;		/* Readahead requests issued	*/
+	uint32	rd_rahits;		/* Reads satisfied by readahead	*/
+	sid32	rd_biosem;		/* Counts request nodes left	*/
+					/*   for asynchronous requests	*/
 	struct	rdqnode	*rd_qhead;	/* Head of request queue	*/
 	struct	rdqnode	*rd_qtail;	/* Tail of request queue	*/
 	struct	rdqnode	*rd_qfree;	/* Free list of request nodes	*/
 	pid32	rd_comproc;		/* Process ID of comm. process	*/
+	pid32	rd_recvproc;		/* Process ID of reply process	*/
 	bool8	rd_comruns;		/* Has comm. process started?	*/
 	sid32	rd_comsem;		/* Semaphore ID for com process	*/
 	uint32	rd_ser_ip;		/* Server IP address		*/
@@ -88,6 +187,9 @@ struct	rdscblk	{			/* Remote disk control block	*/
 	uint16	rd_loc_port;		/* Local (client) UPD port	*/
 	bool8	rd_registered;		/* Has UDP port been registered?*/
 	int32	rd_udpslot;		/* Registered UDP slot		*/
+	struct	rdpent	rd_pent[RD_WINDOW];/* Requests awaiting replies	*/
+	int32	rd_npend;		/* Entries of rd_pent in use	*/
+	uint32	rd_retrans;		/* Count of retransmissions	*/
 };
 
 extern	struct	rdscblk	rdstab[];	/* Remote disk control block	*/
@@ -96,6 +198,9 @@ extern	struct	rdscblk	rdstab[];	/* Remote disk control block	*/
 
 #define	RD_RETRIES	3		/* Times to retry sending a msg	*/
 #define	RD_TIMEOUT	1000		/* Timeout for reply (1 second)	*/
+#define	RD_TICK		100		/* Interval at which the reply	*/
+					/*   process checks for overdue	*/
+					/*   requests (ms)		*/
 
 /* Control functions for a remote disk device */
 
@@ -124,8 +229,14 @@ extern	struct	rdscblk	rdstab[];	/* Remote disk control block	*/
 #define	RD_MSG_DREQ	0x0050		/* Delete request and response 	*/
 #define	RD_MSG_DRES	(RD_MSG_DREQ | RD_MSG_RESPONSE)
 
+#define	RD_MSG_MRREQ	0x0060		/* Multi-block read request and	*/
+#define	RD_MSG_MRRES	(RD_MSG_MRREQ | RD_MSG_RESPONSE)/* response	*/
+
+#define	RD_MSG_MWREQ	0x0070		/* Multi-block write request and*/
+#define	RD_MSG_MWRES	(RD_MSG_MWREQ | RD_MSG_RESPONSE)/* response	*/
+
 #define	RD_MIN_REQ	RD_MSG_RREQ	/* Minimum request type		*/
-#define	RD_MAX_REQ	RD_MSG_DREQ	/* Maximum request type		*/
+#define	RD_MAX_REQ	RD_MSG_MWREQ	/* Maximum request type		*/
 
 /* Message header fields present in each message */
 
@@ -225,3 +336,40 @@ struct	rd_msg_dres	{		/* Remote file delete response	*/
 	RD_MSG_HDR			/* Header fields		*/
 };
 #pragma pack()
+
+/************************************************************************/
+/*			Multi-block read and write			*/
+/************************************************************************/
+#pragma pack(2)
+struct	rd_msg_mrreq	{		/* Multi-block read request	*/
+	RD_MSG_HDR			/* Header fields		*/
+	uint32	rd_blk;			/* First block to read		*/
+	uint32	rd_nblks;		/* Number of contiguous blocks	*/
+};
+#pragma pack()
+
+#pragma pack(2)
+struct	rd_msg_mrres	{		/* Multi-block read reply	*/
+	RD_MSG_HDR			/* Header fields		*/
+	uint32	rd_blk;			/* First block that was read	*/
+	uint32	rd_nblks;		/* Number of blocks		*/
+	char	rd_data[RD_MAXBLKS*RD_BLKSIZ];/* Blocks, in order	*/
+};
+#pragma pack()
+
+#pragma pack(2)
+struct	rd_msg_mwreq	{		/* Multi-block write request	*/
+	RD_MSG_HDR			/* Header fields		*/
+	uint32	rd_blk;			/* First block to write		*/
+	uint32	rd_nblks;		/* Number of contiguous blocks	*/
+	char	rd_data[RD_MAXBLKS*RD_BLKSIZ];/* Blocks, in order	*/
+};
+#pragma pack()
+
+#pragma pack(2)
+struct	rd_msg_mwres	{		/* Multi-block write response	*/
+	RD_MSG_HDR			/* Header fields		*/
+	uint32	rd_blk;			/* First block that was written	*/
+	uint32	rd_nblks;		/* Number of blocks		*/
+};
+#pragma pack()
@@ -29,22 +29,49 @@
 #define	RF_LOC_PORT	53224
 #endif
 
-struct	rfdata	{
-	int32	rf_seq;			/* Next sequence number to use	*/
-	uint32	rf_ser_ip;		/* Server IP address		*/
-	uint16	rf_ser_port;		/* Server UDP port		*/
-	uint16	rf_loc_port;		/* Local (client) UPD port	*/
-	int32	rf_udp_slot;		/* UDP slot to use		*/
-	sid32	rf_mutex;		/* Mutual exclusion for access	*/
-	bool8	rf_registered;		/* Has UDP port been registered?*/
-};
+/* Parameters for outstanding requests and the client page cache	*/
 
-extern	struct	rfdata	Rf_data;
+#define	RF_WINDOW	8		/* Max requests outstanding at	*/
+					/*   the server at once		*/
+#define	RF_TICK		100		/* Receiver poll interval (ms)	*/
+#define	RF_STACK	8192		/* Stack size for rfsrecv	*/
+#define	RF_PRIO		200		/* Priority of rfsrecv		*/
+#define	RF_NPAGES	16		/* Cached pages per open file	*/
+#define	RF_RAMIN	2		/* Initial readahead (pages)	*/
+#define	RF_RAMAX	8		/* Maximum readahead (pages)	*/
+
+/* States of an outstanding request entry */
+
+#define	RF_PFREE	0		/* Entry is unused		*/
+#define	RF_PINIT	1		/* Entry reserved, not yet sent	*/
+#define	RF_PSENT	2		/* Sent, awaiting a reply	*/
+#define	RF_PDONE	3		/* Completed (synchronous only)	*/
 
 /* Definition of the control block for a remote file pseudo-device	*/
 
-#define	RF_FREE	0			/* Entry is currently unused	*/
-#define	RF_USED	1			/* Entry is currently in use	*/
+#define	RF_FREE		0		/* Entry is currently unused	*/
+#define	RF_USED		1		/* Entry is currently in use	*/
+#define	RF_OPENING	2		/* Entry reserved by rfsopen	*/
+
+/* A page of a remote file in the client cache.  A page that has been	*/
+/*   fetched holds rf_plen valid bytes (fewer than RF_DATALEN only at	*/
+/*   the end of the file).  A page that has not been fetched holds	*/
+/*   only its dirty bytes.  Dirty bytes lie in [rf_pdlo, rf_pdhi).	*/
+
+struct	rfpage	{
+	bool8	rf_pused;		/* Does the page hold data?	*/
+	bool8	rf_pvalid;		/* Was the page fetched?	*/
+	uint32	rf_ppos;		/* File position of the page	*/
+					/*   (a multiple of RF_DATALEN)	*/
+	int32	rf_plen;		/* Valid bytes in a fetched page*/
+	int32	rf_pdlo;		/* Start of dirty bytes		*/
+	int32	rf_pdhi;		/* End of dirty bytes (equal to	*/
+					/*   rf_pdlo when page clean)	*/
+	struct	rfpent	*rf_pent;	/* Read or write of the page	*/
+					/*   in progress, or NULL	*/
+	uint32	rf_ptime;		/* Time of last use (for LRU)	*/
+	char	rf_pdata[RF_DATALEN];	/* Contents of the page		*/
+};
 
 struct	rflcblk	{
 	int32	rfstate;		/* Entry is free or used	*/
@@ -53,6 +80,17 @@ struct	rflcblk	{
 	uint32	rfpos;			/* Current file position	*/
 	uint32	rfmode;			/* Mode: read access, write	*/
 					/*	access or both		*/
+	sid32	rfmutex;		/* Mutual exclusion for the file*/
+	struct	rfpage	*rfpages;	/* Page cache (RF_NPAGES pages)	*/
+	uint32	rfpclock;		/* Clock for page LRU stamps	*/
+	uint32	rfnext;			/* Position after last read	*/
+	int32	rfra;			/* Readahead window (pages)	*/
+	bool8	rfdirty;		/* Written data not yet known	*/
+					/*   to be at the server?	*/
+	bool8	rferr;			/* Did a write behind fail?	*/
+	bool8	rfsrvopen;		/* Was the open sent to the	*/
+					/*   server (else answered from	*/
+					/*   the metadata cache)?	*/
 };
 
 extern	struct	rflcblk	rfltab[];	/* Remote file control blocks	*/
@@ -311,3 +349,75 @@ struct	rf_msg_xres	{		/* Remote file rmdir response	*/
 	RF_MSG_HDR			/* Header fields		*/
 };
 #pragma pack()
+
+/************************************************************************/
+/*									*/
+/*	Outstanding requests and global data for the remote server	*/
+/*									*/
+/************************************************************************/
+
+/* An outstanding request.  The message is kept in the entry so it can	*/
+/*   be retransmitted.  A synchronous request has a caller waiting in	*/
+/*   rfswait for the reply; an asynchronous request reads or writes a	*/
+/*   cached page, and rfsrecv frees the entry when it completes.	*/
+
+struct	rfpent	{
+	int32	rf_state;		/* RF_PFREE, RF_PSENT, etc.	*/
+	uint32	rf_seq;			/* Sequence number of request	*/
+	bool8	rf_async;		/* Is no caller waiting for it?	*/
+	int32	rf_mlen;		/* Length of the request	*/
+	struct	rf_msg_hdr *rf_reply;	/* Reply buffer (synchronous)	*/
+	int32	rf_rlen;		/* Size of the reply buffer	*/
+	int32	rf_retval;		/* Reply length, or TIMEOUT	*/
+	struct	rflcblk	*rf_file;	/* File of a page request	*/
+	struct	rfpage	*rf_page;	/* Page of a page request	*/
+	sid32	rf_sem;			/* Signaled when it completes	*/
+	int32	rf_nwait;		/* Processes waiting for a page	*/
+					/*   request to complete	*/
+	uint32	rf_sent;		/* Time of last transmission	*/
+	int32	rf_tries;		/* Number of transmissions	*/
+	struct	rf_msg_wreq rf_req;	/* The request (a write request	*/
+					/*   is the largest)		*/
+};
+
+/* Client cache of file metadata.  An entry records that a name exists	*/
+/*   (with its size, if known, and the access rights an open of it has	*/
+/*   been granted) or that it does not exist.  An entry is trusted for	*/
+/*   RF_MTIMEOUT ms after the server last confirmed it.		*/
+
+#define	RF_NMETA	32		/* Entries in metadata cache	*/
+#define	RF_MTIMEOUT	5000		/* Lifetime of an entry (ms)	*/
+
+#define	RF_MFREE	0		/* Entry is unused		*/
+#define	RF_MEXISTS	1		/* The name exists		*/
+#define	RF_MMISSING	2		/* The name does not exist	*/
+
+struct	rfmeta	{
+	int32	rf_mstate;		/* RF_MFREE, RF_MEXISTS, etc.	*/
+	char	rf_mname[RF_NAMLEN];	/* Name of the file		*/
+	int32	rf_mmode;		/* Access rights granted (a	*/
+					/*   subset of RF_MODE_RW)	*/
+	int32	rf_msize;		/* Size in bytes, or -1 if not	*/
+					/*   known			*/
+	uint32	rf_mtime;		/* Time the server confirmed it	*/
+};
+
+struct	rfdata	{
+	int32	rf_seq;			/* Next sequence number to use	*/
+	uint32	rf_ser_ip;		/* Server IP address		*/
+	uint16	rf_ser_port;		/* Server UDP port		*/
+	uint16	rf_loc_port;		/* Local (client) UPD port	*/
+	int32	rf_udp_slot;		/* UDP slot to use		*/
+	sid32	rf_mutex;		/* Mutual exclusion for the	*/
+					/*   device table and for	*/
+					/*   registering the UDP port	*/
+	bool8	rf_registered;		/* Has UDP port been registered?*/
+	struct	rfpent	rf_pent[RF_WINDOW];/* Outstanding requests	*/
+	sid32	rf_wsem;		/* Counts free entries in	*/
+					/*   rf_pent			*/
+	pid32	rf_recvproc;		/* Process that receives replies*/
+	int32	rf_retrans;		/* Count of retransmissions	*/
+	struct	rfmeta	rf_meta[RF_NMETA];/* Metadata cache		*/
+};
+
+extern	struct	rfdata	Rf_data;
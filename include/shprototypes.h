@@ -7,6 +7,12 @@ extern	shellcmd  xsh_arp	(int32, char *[]);
 /* in file xsh_bingid.c */
 extern	shellcmd  xsh_bingid	(int32, char *[]);
 
+/* in file xsh_biostat.c */
+extern	shellcmd  xsh_biostat	(int32, char *[]);
+
+/* in file xsh_bufstat.c */
+extern	shellcmd  xsh_bufstat	(int32, char *[]);
+
 /* in file xsh_cat.c */
 extern	shellcmd  xsh_cat	(int32, char *[]);
 
@@ -28,6 +34,9 @@ extern	shellcmd  xsh_ethstat	(int32, char *[]);
 /* in file xsh_exit.c */
 extern	shellcmd  xsh_exit	(int32, char *[]);
 
+/* in file xsh_fsbench.c */
+extern	shellcmd  xsh_fsbench	(int32, char *[]);
+
 /* in file xsh_help.c */
 extern	shellcmd  xsh_help	(int32, char *[]);
 
@@ -61,9 +70,15 @@ extern	shellcmd  xsh_ping	(int32, char *[]);
 /* in file xsh_ps.c */
 extern	shellcmd  xsh_ps	(int32, char *[]);
 
+/* in file xsh_rdstat.c */
+extern	shellcmd  xsh_rdstat	(int32, char *[]);
+
 /* in file xsh_sleep.c */
 extern	shellcmd  xsh_sleep	(int32, char *[]);
 
+/* in file xsh_ttybench.c */
+extern	shellcmd  xsh_ttybench	(int32, char *[]);
+
 /* in file xsh_udpdump.c */
 extern	shellcmd  xsh_udpdump	(int32, char *[]);
 
@@ -6,6 +6,7 @@
 #define TFTP_DATA  3   /* Data Packet     */
 #define TFTP_ACK   4   /* Acknowledgement */
 #define TFTP_ERROR 5   /* Error           */
+#define TFTP_OACK  6   /* Option Ack.     */
 
 /* TFTP Error Codes */
 #define TFTP_ERROR_NOT_DEFINED         0  /* Not defined, see error message (if any). */
@@ -16,12 +17,22 @@
 #define TFTP_ERROR_UNKNOWN_TRANSFER_ID 5  /* Unknown transfer ID.                     */
 #define TFTP_ERROR_FILE_EXISTS         6  /* File already exists.                     */
 #define TFTP_ERROR_NO_SUCH_USER        7  /* No such user.                            */
+#define TFTP_ERROR_OPTION              8  /* Option negotiation failed (RFC 2347).    */
 
 #define TFTP_PORT       69      /* UDP Port for TFTP            */
 #define	TFTP_MAXNAM	    64      /* Max length of a file name    */
-#define	TFTP_MAXDATA    512     /* Max size of a data packet    */
+#define	TFTP_MAXDATA    512     /* Default size of a data packet*/
 #define	TFTP_MAXRETRIES	3       /* Number of retranmissions     */
 #define	TFTP_WAIT       5000    /* Time to wait for reply (ms)  */
+#define	TFTP_MAXOPTS	40	/* Space for options in a RRQ	*/
+
+/* Block size (RFC 2348) and window size (RFC 7440) requested from	*/
+/*   the server.  Without IP reassembly a block must fit in one	*/
+/*   Ethernet frame, and the window must not overrun the UDP queue	*/
+
+#define	TFTP_HDR_LEN	4	/* Opcode plus block number	*/
+#define	TFTP_MAXBLKSIZE	(ETH_MTU - IP_HDR_LEN - UDP_HDR_LEN - TFTP_HDR_LEN)
+#define	TFTP_WINDOWSIZE	UDP_QSIZ
 
 /* Xinu Specific Flags */
 #define TFTP_NON_VERBOSE 0  /* Do not use verbose output */
@@ -37,14 +48,15 @@ struct	tftp_msg {
 	 /* Items in a RRQ or WRQ message */
 
 	 struct	{
-	  char	tf_filemode[TFTP_MAXNAM+10]; /* file name and mode	*/
+	  char	tf_filemode[TFTP_MAXNAM+10+TFTP_MAXOPTS];
+					/* file name, mode, options	*/
 	 };
 
 	 /* Items in a Data packet */
 
 	 struct {
 	  uint16	tf_dblk;	/* Block number of this data	*/
-	  char		tf_data[TFTP_MAXDATA]; /* Actual data		*/
+	  char		tf_data[TFTP_MAXBLKSIZE]; /* Actual data	*/
 	 };
 
 	 /* Items in an ACK packet */
@@ -53,6 +65,12 @@ struct	tftp_msg {
 	  uint16	tf_ablk;	/* Block number being acked	*/
 	 };
 
+	 /* Items in an OACK packet */
+
+	 struct {
+	  char	tf_opts[TFTP_MAXBLKSIZE+2]; /* Option/value pairs	*/
+	 };
+
 	/* Items in an Error packet */
 
 	 struct {
@@ -2,7 +2,6 @@
 
 #define	TY_OBMINSP	20		/* Min space in buffer before	*/
 					/*   processes awakened to write*/
-#define	TY_EBUFLEN	20		/* Size of echo queue		*/
 
 /* Size constants */
 
@@ -15,6 +14,9 @@
 #ifndef	TY_OBUFLEN
 #define	TY_OBUFLEN	64		/* Num.	chars in output	queue	*/
 #endif
+#ifndef	TY_EBUFLEN
+#define	TY_EBUFLEN	20		/* Size of echo queue		*/
+#endif
 
 /* Mode constants for input and output modes */
 
@@ -55,6 +57,11 @@ struct	ttycblk	{			/* Tty line control block	*/
 	char	tyostart;		/* Character that starts output	*/
 	bool8	tyocrlf;		/* Output CR/LF for LF ?	*/
 	char	tyifullc;		/* Char to send when input full	*/
+	int32	tyfifosz;		/* Chars each UART FIFO holds	*/
+	int32	tyofree;		/* Slots known to be free in the*/
+					/*   UART's transmit FIFO	*/
+	uint32	tyrxints;		/* Receive interrupts handled	*/
+	uint32	tytxints;		/* Transmit interrupts handled	*/
 };
 extern	struct	ttycblk	ttytab[];
 
@@ -4,6 +4,7 @@
 #define	UART_OUT_IDLE	0x0016	/* determine if transmit idle		*/
 #define	UART_FIFO_SIZE	16	/* chars in UART onboard output FIFO	*/
 				/* (16 for later UART chips)		*/
+#define	UART_FIFO_SIZE64 64	/* chars in the FIFOs of a 16750	*/
 #define INTEL_UART_PCI_DID	0x0936	/* UART PCI Device ID		*/
 #define INTEL_UART_PCI_VID	0x8086	/* UART PCI Vendor ID		*/
 /*
@@ -63,12 +64,16 @@ struct	uart_csreg
 #define UART_IIR_RDA	0x04	/* Receiver data available		*/
 #define UART_IIR_RLSI	0x06	/* Receiver line status interrupt	*/
 #define UART_IIR_RTO	0x0C	/* Receiver timed out			*/
+#define UART_IIR_F64	0x20	/* 64-character FIFOs enabled (16750)	*/
+#define UART_IIR_FIFO	0xC0	/* Both bits set => FIFOs enabled	*/
 
 /* FIFO control bits */
 
 #define UART_FCR_EFIFO	0x01	/* Enable in and out hardware FIFOs	*/
 #define UART_FCR_RRESET 0x02	/* Reset receiver FIFO			*/
 #define UART_FCR_TRESET 0x04	/* Reset transmit FIFO			*/
+#define UART_FCR_E64	0x20	/* Enable 64-character FIFOs (16750,	*/
+				/*   written with DLAB=1)		*/
 #define UART_FCR_TRIG0	0x00	/* RCVR FIFO trigger level one char	*/
 #define UART_FCR_TRIG1	0x40	/* RCVR FIFO trigger level 1/4		*/
 #define UART_FCR_TRIG2	0x80	/* RCVR FIFO trigger level 2/4		*/
@@ -15,8 +15,11 @@
 #include <uart.h>
 #include <tty.h>
 #include <device.h>
+#include <bio.h>
+#include <iovec.h>
 #include <interrupt.h>
 #include <file.h>
+#include <bcache.h>
 #include <rfilesys.h>
 #include <rdisksys.h>
 #include <lfilesys.h>
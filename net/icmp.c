@@ -251,6 +251,7 @@ status	icmp_send (
 
 	pkt = icmp_mkpkt(remip, type, ident, seq, buf, len);
 	if ((int32)pkt == SYSERR) {
+		restore(mask);
 		return SYSERR;
 	}
 
@@ -278,12 +279,13 @@ struct	netpacket *icmp_mkpkt (
 	struct	netpacket *pkt;		/* pointer to packet buffer	*/
 	static	uint32	ipident=32767;	/* IP ident field		*/
 
-	/* Allocate packet */
+	/* Allocate packet, but do not wait if the network buffers are	*/
+	/*	exhausted (an echo reply is simply dropped)		*/
 
-	pkt = (struct netpacket *)getbuf(netbufpool);
+	pkt = (struct netpacket *)getbuf_nb(netbufpool);
 
 	if ((int32)pkt == SYSERR) {
-		panic("icmp_mkpkt: cannot get a network buffer\n");
+		return (struct netpacket *)SYSERR;
 	}
 
 	/* Create icmp packet in pkt */
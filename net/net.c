@@ -1,4 +1,5 @@
-/* net.c - net_init, netin, eth_hton */
+/* net.c - net_init, netin, netq_enqueue, netqin, eth_hton, eth_ntoh,	*/
+/*		getport							*/
 
 #include <xinu.h>
 #include <stdio.h>
@@ -7,6 +8,14 @@ struct	network	NetData;
 bpid32	netbufpool;
 uint64	netportseed;
 
+local	void	netq_arp(struct netpacket *);
+
+struct	netqentry netqtab[NETQ_NUM] = {	/* Table of input queues	*/
+	{ "arpin",  NETQ_CTLPRIO, netq_arp },
+	{ "icmpin", NETQ_CTLPRIO, ip_in },
+	{ "udpin",  NETQ_DATPRIO, ip_in }
+};
+
 /*------------------------------------------------------------------------
  * net_init  -  Initialize network data structures and processes
  *------------------------------------------------------------------------
@@ -15,6 +24,8 @@ uint64	netportseed;
 void	net_init (void)
 {
 	int32	nbufs;			/* Total no of buffers		*/
+	int32	i;			/* Index into netqtab		*/
+	struct	netqentry *nqptr;	/* Pointer to an input queue	*/
 
 	/* Initialize the network data structure */
 
@@ -32,7 +43,8 @@ void	net_init (void)
 
 	/* Create the network buffer pool */
 
-	nbufs = UDP_SLOTS * UDP_QSIZ + ICMP_SLOTS * ICMP_QSIZ + 1;
+	nbufs = UDP_SLOTS * UDP_QSIZ + ICMP_SLOTS * ICMP_QSIZ
+			+ NETQ_NUM * NETQ_SIZ + 1;
 
 	netbufpool = mkbufpool(PACKLEN, nbufs);
 
@@ -62,6 +74,26 @@ void	net_init (void)
 
 	resume(create(ipout, NETSTK, NETPRIO, "ipout", 0, NULL));
 
+	/* Initialize the input queues and create a worker for each */
+
+	for (i=0; i<NETQ_NUM; i++) {
+		nqptr = &netqtab[i];
+		nqptr->nqhead = 0;
+		nqptr->nqtail = 0;
+		nqptr->nqcount = 0;
+		nqptr->nqmax = 0;
+		nqptr->nqpkts = 0;
+		nqptr->nqdrops = 0;
+		nqptr->nqsem = semcreate(0);
+		if((int32)nqptr->nqsem == SYSERR) {
+			panic("Cannot create network input queue semaphore");
+			return;
+		}
+		nqptr->nqpid = create(netqin, NETSTK, nqptr->nqprio,
+						nqptr->nqname, 1, i);
+		resume(nqptr->nqpid);
+	}
+
 	/* Create a network input process */
 
 	resume(create(netin, NETSTK, NETPRIO, "netin", 0, NULL));
@@ -69,7 +101,8 @@ void	net_init (void)
 
 
 /*------------------------------------------------------------------------
- * netin  -  Repeatedly read and process the next incoming packet
+ * netin  -  Repeatedly read the next incoming packet and pass it to the
+ *		input queue for its protocol
  *------------------------------------------------------------------------
  */
 
@@ -97,16 +130,21 @@ process	netin ()
 
 		eth_ntoh(pkt);
 
-		/* Demultiplex on Ethernet type */
+		/* Demultiplex on Ethernet type (and IP protocol type,	*/
+		/*	which needs no byte order conversion)		*/
 
 		switch (pkt->net_ethtype) {
 
 		    case ETH_ARP:			/* Handle ARP	*/
-			arp_in((struct arppacket *)pkt);
+			netq_enqueue(NETQ_ARP, pkt);
 			continue;
 
 		    case ETH_IP:			/* Handle IP	*/
-			ip_in(pkt);
+			if (pkt->net_ipproto == IP_ICMP) {
+				netq_enqueue(NETQ_ICMP, pkt);
+			} else {
+				netq_enqueue(NETQ_UDP, pkt);
+			}
 			continue;
 	
 		    case ETH_IPv6:			/* Handle IPv6	*/
@@ -120,6 +158,84 @@ process	netin ()
 	}
 }
 
+/*------------------------------------------------------------------------
+ * netq_enqueue  -  Deposit an incoming packet on an input queue, or drop
+ *		      it if the queue is full
+ *------------------------------------------------------------------------
+ */
+void	netq_enqueue(
+	  int32	qid,			/* Index of queue in netqtab	*/
+	  struct netpacket *pktptr	/* Pointer to the packet	*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	struct	netqentry *nqptr;	/* Pointer to the input queue	*/
+
+	mask = disable();
+	nqptr = &netqtab[qid];
+	if (nqptr->nqcount >= NETQ_SIZ) {
+		nqptr->nqdrops++;
+		freebuf((char *)pktptr);
+		restore(mask);
+		return;
+	}
+	nqptr->nqbuf[nqptr->nqtail++] = pktptr;
+	if (nqptr->nqtail >= NETQ_SIZ) {
+		nqptr->nqtail = 0;
+	}
+	nqptr->nqpkts++;
+	if (++nqptr->nqcount > nqptr->nqmax) {
+		nqptr->nqmax = nqptr->nqcount;
+	}
+	signal(nqptr->nqsem);
+	restore(mask);
+}
+
+/*------------------------------------------------------------------------
+ * netqin  -  Worker process that runs the protocol input function for
+ *		each packet deposited on one input queue
+ *------------------------------------------------------------------------
+ */
+process	netqin(
+	  int32	qid			/* Index of queue in netqtab	*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	struct	netqentry *nqptr;	/* Pointer to the input queue	*/
+	struct	netpacket *pkt;		/* Ptr to current packet	*/
+
+	nqptr = &netqtab[qid];
+
+	while(1) {
+
+		/* Obtain next packet from the input queue */
+
+		wait(nqptr->nqsem);
+		mask = disable();
+		pkt = nqptr->nqbuf[nqptr->nqhead++];
+		if (nqptr->nqhead >= NETQ_SIZ) {
+			nqptr->nqhead = 0;
+		}
+		nqptr->nqcount--;
+		restore(mask);
+
+		/* Handle the packet */
+
+		nqptr->nqfunc(pkt);
+	}
+}
+
+/*------------------------------------------------------------------------
+ * netq_arp  -  Input function for the ARP queue
+ *------------------------------------------------------------------------
+ */
+local	void	netq_arp(
+	  struct netpacket *pktptr	/* Pointer to the packet	*/
+	)
+{
+	arp_in((struct arppacket *)pktptr);
+}
+
 /*------------------------------------------------------------------------
  * eth_hton  -  Convert Ethernet type field to network byte order
  *------------------------------------------------------------------------
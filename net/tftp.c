@@ -3,17 +3,111 @@
 #include <xinu.h>
 #include <stdlib.h>
 #include <string.h>
+#include <ctype.h>
+
+#define	TFTP_GAP	0	/* tftp_recv1 saw a block beyond the	*/
+				/*   expected one (a block was lost)	*/
+
+/*------------------------------------------------------------------------
+ *
+ * tftp_recv1  -  Internal function to get the next matching response
+ *		  during a read sequence (ignoring duplicates and
+ *		  nonsense packets)
+ *
+ *------------------------------------------------------------------------
+ */
+
+local	int32	tftp_recv1 (
+	 int32	sock,			/* UDP socket to use		*/
+	 uint16	*remport,		/* Remote port to set		*/
+	 struct tftp_msg *inmsg,	/* Pointer to buffer for an	*/
+					/*   incoming message		*/
+	 uint16	expected,		/* Block number expected next	*/
+	 int32	window,			/* Blocks the server may send	*/
+					/*   ahead of an ACK (0 means	*/
+					/*   do not report gaps)	*/
+	 uint32	*start			/* Set to time of first reply	*/
+	)
+{
+	int32	n;			/* Number of bytes in response	*/
+	uint32	tmp;			/* Holds IP address on receive	*/
+	uint16	opcode;			/* Opcode of the response	*/
+	uint16	blk;			/* Block number in a response	*/
+
+	/* Repeatedly read incoming messages, discarding packets that	*/
+	/*	are not valid or do not match the expected block number	*/
+	/*	(i.e., duplicates of previous packets)			*/
+
+	while(1) {
+
+		/* Read next incoming message */
+
+		n = udp_recvaddr(sock, &tmp, remport, (char *)inmsg,
+				sizeof(struct tftp_msg), TFTP_WAIT);
+		if (n == SYSERR) {
+			return SYSERR;
+		} else if (n == TIMEOUT) {
+			kprintf("\n[tftp_recv1] UDP Receive Timeout\n");
+			return TIMEOUT;
+		}
+
+		if (n < 4) {	/* too small to be a valid packet */
+			continue;
+		}
+		if (*start == 0) {
+			*start = ctr1000;
+		}
+		opcode = ntohs(inmsg->tf_opcode);
+
+		/* If Error came back, give up unless the server merely	*/
+		/*	refused the options, which the caller handles	*/
+
+		if (opcode == TFTP_ERROR) {
+			if (ntohs(inmsg->tf_ercode) == TFTP_ERROR_OPTION) {
+				return n;
+			}
+			kprintf("\n[tftp_recv1] TFTP Error %d, %s\n",
+					ntohs(inmsg->tf_ercode),
+					inmsg->tf_ermsg );
+			return SYSERR;
+		}
+
+		/* An option acknowledgement can only precede block 1	*/
+
+		if ( (opcode == TFTP_OACK) && (expected == 1) ) {
+			return n;
+		}
+
+		if (opcode != TFTP_DATA) {
+			continue;
+		}
+
+		/* If data packet matches expected block, return */
+
+		blk = ntohs(inmsg->tf_dblk);
+		if (blk == expected) {
+			return n;
+		}
+
+		/* A block later in the window means an earlier one was	*/
+		/*	lost; anything else is a duplicate to be ignored	*/
+
+		if ((uint16)(blk - expected) < window) {
+			return TFTP_GAP;
+		}
+	}
+}
 
 /*------------------------------------------------------------------------
  *
  * tftp_send1  -  Internal function to send one outgoing request (RRQ or
  *		  ACK) message during a read sequence and get a matching
- *		  response (ignoring duplicates and nonsense packets)
+ *		  response
  *
  *------------------------------------------------------------------------
  */
 
-status	tftp_send1 (
+local	int32	tftp_send1 (
 	 int32	sock,			/* UDP socket to use		*/
 	 uint32	remip,			/* Remote IP address		*/
 	 uint16	*remport,		/* Remote port to use/set	*/
@@ -21,18 +115,20 @@ status	tftp_send1 (
 	 int32	mlen,			/* Size of ougoing message	*/
 	 struct tftp_msg *inmsg,	/* Pointer to buffer for an	*/
 					/*   incoming message		*/
-	 uint16	expected		/* Block number expected next	*/
+	 uint16	expected,		/* Block number expected next	*/
+	 int32	window,			/* Window for gap detection	*/
+	 uint32	*start			/* Set to time of first reply	*/
 	)
 {
 	int32	ret;			/* Return value	for udp_send	*/
-	int32	n;			/* Number of bytes in response	*/
-	uint32	tmp;			/* Holds IP address on receive	*/
 
 	/*                 TFTP RRQ/WRQ Packet                  */
 	/*   2 bytes     string    1 byte     string   1 byte   */
 	/*   ------------------------------------------------   */
 	/*  | Opcode |  Filename  |   0  |    Mode    |   0  |  */
 	/*   ------------------------------------------------   */
+	/*   followed by optional  | Option | 0 | Value | 0 |  */
+	/*   pairs (RFC 2347)                                   */
 	
 	/*     TFTP ACK Packet       */
 	/*   2 bytes     2 bytes     */
@@ -48,46 +144,96 @@ status	tftp_send1 (
 		return SYSERR;
 	}
 
-	/* Repeatedly read incoming messages, discarding packets that	*/
-	/*	are not valid or do not match the expected block number	*/
-	/*	(i.e., duplicates of previous packets)			*/
+	return tftp_recv1(sock, remport, inmsg, expected, window, start);
+}
 
-	while(1) {
+/*------------------------------------------------------------------------
+ *
+ * tftp_rrq  -  Internal function to form a Read Request, optionally
+ *		asking for the blksize and windowsize options, and
+ *		return its length
+ *
+ *------------------------------------------------------------------------
+ */
 
-		/* Read next incoming message */
+local	int32	tftp_rrq (
+	 struct tftp_msg *msg,		/* Pointer to outgoing message	*/
+	 const	char *filename,		/* Name of the file to download	*/
+	 int32	nlen,			/* Length of the file name	*/
+	 bool8	useopts			/* Nonzero => request options	*/
+	)
+{
+	char	*p;			/* Next free byte in message	*/
 
-		n = udp_recvaddr(sock, &tmp, remport, (char *)inmsg,
-				sizeof(struct tftp_msg), TFTP_WAIT);
-		if (n == SYSERR) {
-			return SYSERR;
-		} else if (n == TIMEOUT) {
-			kprintf("\n[tftp_send1] UDP Receive Timeout\n");
-			return TIMEOUT;
-		}
+	memset((char *)msg, NULLCH, sizeof(struct tftp_msg));
+	msg->tf_opcode = htons(TFTP_RRQ);
+	p = msg->tf_filemode;
+	strncpy(p, filename, nlen+1);
+	p += nlen + 1;
 
-		if (n < 4) {	/* too small to be a valid packet */
-			continue;
-		}
+	/* Set mode to 'octet' */
 
-		/* If Error came back, give up */
-		
-		if (ntohs(inmsg->tf_opcode) == TFTP_ERROR) {
-			kprintf("\n[tftp_send1] TFTP Error %d, %s\n",
-					ntohs(inmsg->tf_ercode),
-					inmsg->tf_ermsg );
-			return SYSERR;
-		}
+	strncpy(p, "octet", sizeof("octet"));
+	p += sizeof("octet");
+
+	if (useopts) {
+		strncpy(p, "blksize", sizeof("blksize"));
+		p += sizeof("blksize");
+		sprintf(p, "%d", TFTP_MAXBLKSIZE);
+		p += strlen(p) + 1;
+		strncpy(p, "windowsize", sizeof("windowsize"));
+		p += sizeof("windowsize");
+		sprintf(p, "%d", TFTP_WINDOWSIZE);
+		p += strlen(p) + 1;
+	}
+	return p - (char *)msg;
+}
 
-		/* If data packet matches expected block, return */
+/*------------------------------------------------------------------------
+ *
+ * tftp_optval  -  Internal function to find an option in an OACK and
+ *		   return its value (SYSERR if the option is absent)
+ *
+ *------------------------------------------------------------------------
+ */
 
-		if ( (ntohs(inmsg->tf_opcode) == TFTP_DATA) &&
-				(ntohs(inmsg->tf_dblk) == expected)) {
-			return n;
+local	int32	tftp_optval (
+	 struct tftp_msg *msg,		/* Pointer to the OACK		*/
+	 int32	mlen,			/* Length of the OACK		*/
+	 char	*name			/* Option name (lower case)	*/
+	)
+{
+	char	*p;			/* Walks the option list	*/
+	char	*end;			/* End of the option list	*/
+	char	*q;			/* Walks the option name	*/
+	char	c;			/* Option name char, lower case	*/
+
+	p = msg->tf_opts;
+	end = (char *)msg + mlen;
+	while (p < end) {
+
+		/* Option names are case-insensitive */
+
+		for (q = name; p < end && *p != NULLCH; p++, q++) {
+			c = isupper(*p) ? tolower(*p) : *p;
+			if (c != *q) {
+				break;
+			}
+		}
+		if (p < end && *p == NULLCH && *q == NULLCH) {
+			return atoi(p + 1);
 		}
 
-		/* As this point, incoming message is either invalid or	*/
-		/*	a duplicate, so ignore and try again		*/
+		/* Skip the rest of this name and its value */
+
+		while (p < end && *p++ != NULLCH) {
+			;
+		}
+		while (p < end && *p++ != NULLCH) {
+			;
+		}
 	}
+	return SYSERR;
 }
 
 
@@ -137,9 +283,20 @@ status  tftpget_mb(
 	int32	mlen;			/* Length of outgoing mesage	*/
 	struct	tftp_msg inmsg;		/* Buffer for response message	*/
 	int32	dlen;			/* Size of data in a response	*/
+	int32	ncopy;			/* Bytes to copy to a buffer	*/
+	char*	data;			/* Next data byte to copy	*/
 	char*   curr_buf;		/* Current buffer being used	*/
 	uint32  curr_buf_ind;		/* Index of current buffer	*/
 	uint32  curr_used;		/* Amount used in buffer	*/
+	bool8	useopts;		/* Request blksize/windowsize	*/
+	int32	blksize;		/* Negotiated block size	*/
+	int32	window;			/* Negotiated window size	*/
+	int32	inwin;			/* Blocks received since ACK	*/
+	bool8	sendack;		/* Send outmsg before receiving	*/
+	bool8	gapacked;		/* Already re-ACKed for a gap	*/
+	int32	retries;		/* Consecutive timeouts		*/
+	uint32	start;			/* Time of first reply (ms)	*/
+	uint32	elapsed;		/* Duration of transfer (ms)	*/
 
 	/* Check args */
 	
@@ -182,10 +339,6 @@ status  tftpget_mb(
 		return SYSERR;
 	}
 
-	/* Clear the message buffer */
-
-	memset((char*)&outmsg, NULLCH, sizeof(outmsg));
-
 	/* Initialize the total file size to zero */
 
 	filesiz = 0;
@@ -193,42 +346,111 @@ status  tftpget_mb(
 	curr_buf = (char*)rcv_bufs[curr_buf_ind];
 	curr_used = 0;
 
-	/* Form the first message and compute length (a Read Request)	*/
-
-	outmsg.tf_opcode = htons(TFTP_RRQ);
-	strncpy(outmsg.tf_filemode, filename, nlen+1);
-	/* Set mode to 'octet' */
-	strncpy(outmsg.tf_filemode+nlen+1, "octet", sizeof("octet")+1);
+	/* Form the first message (a Read Request that asks for a	*/
+	/*	larger block size and window); until the server		*/
+	/*	acknowledges the options, use plain lock-step TFTP	*/
 
-	/* Length is 2 opcode octets, name length, "octet" length,	*/
-	/*		and two NULLs					*/
+	useopts = TRUE;
+	mlen = tftp_rrq(&outmsg, filename, nlen, useopts);
+	blksize = TFTP_MAXDATA;
+	window = 1;
+	inwin = 0;
+	sendack = TRUE;
+	gapacked = FALSE;
+	retries = 0;
+	start = 0;
 
-	mlen = nlen + strnlen("octet", 6) + 4;
-
-	/* Repeatedly send the next request and get a response,		*/
-	/*	retransmitting a request up to TFTP_MAXRETRIES times	*/
+	/* Repeatedly send the next request (or wait for the next block	*/
+	/*	in the window) and get a response, retransmitting the	*/
+	/*	last request up to TFTP_MAXRETRIES times		*/
 
 	while(1) {
-	    for (i=0; i < TFTP_MAXRETRIES; i++) {
+	    if (sendack) {
 		n = tftp_send1(sock, serverip, &remport, &outmsg, mlen,
-							&inmsg, expected);
-		if (n > 0) {
-			break;
-		} else if (n == SYSERR) {
-			kprintf("\n[TFTP Get] ERROR: TFTP Send fails\n");
+				&inmsg, expected, gapacked ? 0 : window,
+				&start);
+	    } else {
+		n = tftp_recv1(sock, &remport, &inmsg, expected,
+				gapacked ? 0 : window, &start);
+	    }
+	    if (n == SYSERR) {
+		kprintf("\n[TFTP Get] ERROR: TFTP Send fails\n");
+		udp_release(sock);
+		return SYSERR;
+	    } else if (n == TIMEOUT) {
+		if (++retries >= TFTP_MAXRETRIES) {
+			kprintf("\n[TFTP Get] ERROR: Max retries %d exceeded\n",
+							TFTP_MAXRETRIES);
 			udp_release(sock);
 			return SYSERR;
-		} else if (n == TIMEOUT) {
-			continue;
+		}
+
+		/* Retransmit the last request so the server resends	*/
+		/*	everything after the last block acknowledged	*/
+
+		sendack = TRUE;
+		inwin = 0;
+		continue;
+	    } else if (n == TFTP_GAP) {
+
+		/* A block in the window was lost, so acknowledge the	*/
+		/*	last block received in order (RFC 7440)		*/
+
+		gapacked = TRUE;
+		sendack = TRUE;
+		inwin = 0;
+		continue;
+	    }
+	    retries = 0;
 
+	    /* If the server refused the options, start over with a	*/
+	    /*	plain Read Request sent to the well-known port		*/
+
+	    if (ntohs(inmsg.tf_opcode) == TFTP_ERROR) {
+		if (!useopts || (filesiz > 0)) {
+			kprintf("\n[TFTP Get] ERROR: Unexpected option error\n");
+			udp_release(sock);
+			return SYSERR;
 		}
+		if (verbose & TFTP_VERBOSE) {
+			kprintf("[TFTP Get] Server refused options\n");
+		}
+		useopts = FALSE;
+		mlen = tftp_rrq(&outmsg, filename, nlen, useopts);
+		remport = TFTP_PORT;
+		sendack = TRUE;
+		continue;
 	    }
-	    if (i >= TFTP_MAXRETRIES) {
-		kprintf("\n[TFTP Get] ERROR: Max retries %d exceeded\n",
-							TFTP_MAXRETRIES);
-		udp_release(sock);
-		return SYSERR;
+
+	    /* Adopt the values the server accepted and ACK block 0	*/
+
+	    if (ntohs(inmsg.tf_opcode) == TFTP_OACK) {
+		blksize = tftp_optval(&inmsg, n, "blksize");
+		if (blksize == SYSERR) {
+			blksize = TFTP_MAXDATA;
+		}
+		window = tftp_optval(&inmsg, n, "windowsize");
+		if (window == SYSERR) {
+			window = 1;
+		}
+		if ( (blksize < 8) || (blksize > TFTP_MAXBLKSIZE) ||
+		     (window < 1) || (window > TFTP_WINDOWSIZE) ) {
+			kprintf("\n[TFTP Get] ERROR: Invalid option value\n");
+			udp_release(sock);
+			return SYSERR;
+		}
+		if (verbose & TFTP_VERBOSE) {
+			kprintf("[TFTP Get] blksize %d windowsize %d\n",
+							blksize, window);
+		}
+		outmsg.tf_opcode = htons(TFTP_ACK);
+		outmsg.tf_ablk = htons(0);
+		mlen = sizeof(outmsg.tf_opcode) + sizeof(outmsg.tf_ablk);
+		sendack = TRUE;
+		inwin = 0;
+		continue;
 	    }
+	    gapacked = FALSE;
 		
 	    if(verbose & TFTP_VERBOSE) {
 		kprintf(".");
@@ -238,9 +460,10 @@ status  tftpget_mb(
 
 	    dlen = n - sizeof(inmsg.tf_opcode) - sizeof(inmsg.tf_dblk);
 
-	    /* Move the contents of this block into the file buffer	*/
+	    /* Move the contents of this block into the file buffers	*/
 
-	    for (i=0; i<dlen; i++) {
+	    data = inmsg.tf_data;
+	    for (i=0; i<dlen; i+=ncopy) {
 		if (curr_used >= rcv_buf_sizes[curr_buf_ind]) {
 			curr_buf_ind++;
 			if(curr_buf_ind >= rcv_buf_count) {
@@ -253,12 +476,19 @@ status  tftpget_mb(
 			curr_buf = (char*)rcv_bufs[curr_buf_ind];
 			curr_used = 0;
 		}
-		*curr_buf++ = inmsg.tf_data[i];
-		curr_used++;
-		filesiz++;
+		ncopy = rcv_buf_sizes[curr_buf_ind] - curr_used;
+		if (ncopy > dlen - i) {
+			ncopy = dlen - i;
+		}
+		memcpy(curr_buf, data, ncopy);
+		curr_buf += ncopy;
+		data += ncopy;
+		curr_used += ncopy;
+		filesiz += ncopy;
 	    }
 
-	    /* Form an ACK */
+	    /* Form an ACK (sent at the end of the window, or resent	*/
+	    /*	after a timeout or a lost block)			*/
 
 	    outmsg.tf_opcode = htons(TFTP_ACK);
 	    outmsg.tf_ablk = htons(expected);
@@ -266,13 +496,18 @@ status  tftpget_mb(
 
 	    /* If this was the last packet, send final ACK */
 
-	    if (dlen < 512) {
+	    if (dlen < blksize) {
 		ret = udp_sendto(sock, serverip, remport,
 					(char *) &outmsg, mlen);
 		udp_release(sock);
 			
 		if(verbose & TFTP_VERBOSE) {
-			kprintf("\n");
+			elapsed = ctr1000 - start;
+			if (elapsed == 0) {
+				elapsed = 1;
+			}
+			kprintf("\n[TFTP Get] %d bytes in %d ms (%d KB/s)\n",
+				filesiz, elapsed, filesiz / elapsed);
 		}
 			
 		if (ret == SYSERR) {
@@ -282,8 +517,15 @@ status  tftpget_mb(
 		return filesiz;
 	    }
 
-	    /* Move to next block and continue */
+	    /* Move to next block and acknowledge once the window is	*/
+	    /*	complete						*/
 
 	    expected++;
+	    if (++inwin >= window) {
+		inwin = 0;
+		sendack = TRUE;
+	    } else {
+		sendack = FALSE;
+	    }
 	}
 }
@@ -1,5 +1,6 @@
-/* udp.c - udp_init, udp_in, udp_register, udp_send, udp_sendto,	*/
-/*	        udp_recv, udp_recvaddr, udp_release, udp_ntoh, udp_hton	*/
+/* udp.c - udp_init, udp_in, udp_register, udp_getpkt, udp_sendpkt,	*/
+/*		udp_send, udp_sendto, udp_recv, udp_recvaddr,		*/
+/*		udp_release, udp_ntoh, udp_hton				*/
 
 #include <xinu.h>
 
@@ -310,26 +311,23 @@ int32	udp_recvaddr (
 }
 
 /*------------------------------------------------------------------------
- * udp_send  -  Send a UDP packet using info in a UDP table entry
+ * udp_getpkt  -  Allocate a network buffer for a UDP table slot with all
+ *		    Ethernet, IP and UDP header fields filled in, so the
+ *		    caller can build the payload in place in net_udpdata
+ *		    and pass the buffer to udp_sendpkt (or freebuf)
  *------------------------------------------------------------------------
  */
-status	udp_send (
-	 uid32	slot,			/* Table slot to use		*/
-	 char   *buff,			/* Buffer of UDP data		*/
-	 int32	len			/* Length of data in buffer	*/
+struct	netpacket *udp_getpkt (
+	 uid32	slot,			/* UDP table slot to use	*/
+	 uint32	remip,			/* Remote IP address to use, or	*/
+					/*   zero to use the remote IP	*/
+					/*   and port of the slot	*/
+	 uint16	remport			/* Remote protocol port to use	*/
 	)
 {
 	intmask	mask;			/* Saved interrupt mask		*/
-	struct	netpacket *pkt;		/* Pointer to packet buffer	*/
-	int32	pktlen;			/* Total packet length		*/
-	static	uint16 ident = 1;	/* Datagram IDENT field		*/
-	char	*udataptr;		/* Pointer to UDP data		*/
-	uint32	remip;			/* Remote IP address to use	*/
-	uint16	remport;		/* Remote protocol port to use	*/
-	uint16	locport;		/* Local protocol port to use	*/
-	uint32	locip;			/* Local IP address taken from	*/
-					/*   the interface		*/
-	struct	udpentry *udptr;	/* Pointer to table entry	*/
+	struct	netpacket *pkt;		/* Pointer to a packet buffer	*/
+	struct	udpentry *udptr;	/* Pointer to a UDP table entry	*/
 
 	/* Ensure only one process can access the UDP table at a time	*/
 
@@ -339,7 +337,7 @@ status	udp_send (
 
 	if ( (slot < 0) || (slot >= UDP_SLOTS) ) {
 		restore(mask);
-		return SYSERR;
+		return (struct netpacket *)SYSERR;
 	}
 
 	/* Get pointer to table entry */
@@ -350,144 +348,144 @@ status	udp_send (
 
 	if (udptr->udstate == UDP_FREE) {
 		restore(mask);
-		return SYSERR;
+		return (struct netpacket *)SYSERR;
 	}
 
-	/* Verify that the slot has a specified remote address */
+	/* Use the slot's remote address unless one is specified */
 
-	remip = udptr->udremip;
 	if (remip == 0) {
-		restore(mask);
-		return SYSERR;
+		remip = udptr->udremip;
+		remport = udptr->udremport;
+		if (remip == 0) {
+			restore(mask);
+			return (struct netpacket *)SYSERR;
+		}
 	}
 
-	locip = NetData.ipucast;
-	remport = udptr->udremport;
-	locport = udptr->udlocport;
-
 	/* Allocate a network buffer to hold the packet */
 
 	pkt = (struct netpacket *)getbuf(netbufpool);
 
 	if ((int32)pkt == SYSERR) {
 		restore(mask);
-		return SYSERR;
+		return (struct netpacket *)SYSERR;
 	}
 
-	/* Compute packet length as UDP data size + fixed header size	*/
-
-	pktlen = ((char *)&pkt->net_udpdata - (char *)pkt) + len;
-
-	/* Create a UDP packet in pkt */
+	/* Fill in the headers (lengths are set by udp_sendpkt) */
 
 	memcpy((char *)pkt->net_ethsrc,NetData.ethucast,ETH_ADDR_LEN);
 	pkt->net_ethtype = 0x0800;	/* Type is IP			*/
 	pkt->net_ipvh = 0x45;		/* IP version and hdr length	*/
 	pkt->net_iptos = 0x00;		/* Type of service		*/
-	pkt->net_iplen= pktlen - ETH_HDR_LEN;/* Total IP datagram length*/
-	pkt->net_ipid = ident++;	/* Datagram gets next IDENT	*/
 	pkt->net_ipfrag = 0x0000;	/* IP flags & fragment offset	*/
 	pkt->net_ipttl = 0xff;		/* IP time-to-live		*/
 	pkt->net_ipproto = IP_UDP;	/* Datagram carries UDP		*/
-	pkt->net_ipcksum = 0x0000;	/* initial checksum		*/
-	pkt->net_ipsrc = locip;		/* IP source address		*/
+	pkt->net_ipcksum = 0x0000;	/* Initial checksum		*/
+	pkt->net_ipsrc = NetData.ipucast;/* IP source address		*/
 	pkt->net_ipdst = remip;		/* IP destination address	*/
-
-	pkt->net_udpsport = locport;	/* Local UDP protocol port	*/
+	pkt->net_udpsport = udptr->udlocport;/* Local UDP protocol port	*/
 	pkt->net_udpdport = remport;	/* Remote UDP protocol port	*/
-	pkt->net_udplen = (uint16)(UDP_HDR_LEN+len); /* UDP length	*/
 	pkt->net_udpcksum = 0x0000;	/* Ignore UDP checksum		*/
-	udataptr = (char *) pkt->net_udpdata;
-	memcpy(udataptr, buff, len);
-
-	/* Call ipsend to send the datagram */
 
-	ip_send(pkt);
 	restore(mask);
-	return OK;
+	return pkt;
 }
 
-
 /*------------------------------------------------------------------------
- * udp_sendto  -  Send a UDP packet to a specified destination
+ * udp_sendpkt  -  Send a packet obtained from udp_getpkt after the
+ *		     caller has placed len bytes of data in net_udpdata
  *------------------------------------------------------------------------
  */
-status	udp_sendto (
-	 uid32	slot,			/* UDP table slot to use	*/
-	 uint32	remip,			/* Remote IP address to use	*/
-	 uint16	remport,		/* Remote protocol port to use	*/
-	 char   *buff,			/* Buffer of UDP data		*/
-	 int32	len			/* Length of data in buffer	*/
+status	udp_sendpkt (
+	 struct	netpacket *pkt,		/* Packet from udp_getpkt	*/
+	 int32	len			/* Length of data in packet	*/
 	)
 {
 	intmask	mask;			/* Saved interrupt mask		*/
-	struct	netpacket *pkt;		/* Pointer to a packet buffer	*/
 	int32	pktlen;			/* Total packet length		*/
 	static	uint16 ident = 1;	/* Datagram IDENT field		*/
-	struct	udpentry *udptr;	/* Pointer to a UDP table entry	*/
-	char	*udataptr;		/* Pointer to UDP data		*/
 
-	/* Ensure only one process can access the UDP table at a time	*/
+	if ( (len < 0) || (len > sizeof(pkt->net_udpdata)) ) {
+		freebuf((char *)pkt);
+		return SYSERR;
+	}
 
 	mask = disable();
 
-	/* Verify that the slot is valid */
-
-	if ( (slot < 0) || (slot >= UDP_SLOTS) ) {
-		restore(mask);
-		return SYSERR;
-	}
+	/* Compute packet length as UDP data size + fixed header size	*/
 
-	/* Get pointer to table entry */
+	pktlen = ((char *)&pkt->net_udpdata - (char *)pkt) + len;
 
-	udptr = &udptab[slot];
+	pkt->net_iplen= pktlen - ETH_HDR_LEN;/* Total IP datagram length*/
+	pkt->net_ipid = ident++;	/* Datagram gets next IDENT	*/
+	pkt->net_udplen = (uint16)(UDP_HDR_LEN+len); /* UDP length	*/
 
-	/* Verify that the slot has been registered and is valid */
+	/* Call ipsend to send the datagram */
 
-	if (udptr->udstate == UDP_FREE) {
-		restore(mask);
-		return SYSERR;
-	}
+	ip_send(pkt);
+	restore(mask);
+	return OK;
+}
 
-	/* Allocate a network buffer to hold the packet */
+/*------------------------------------------------------------------------
+ * udp_send  -  Send a UDP packet using info in a UDP table entry
+ *------------------------------------------------------------------------
+ */
+status	udp_send (
+	 uid32	slot,			/* Table slot to use		*/
+	 char   *buff,			/* Buffer of UDP data		*/
+	 int32	len			/* Length of data in buffer	*/
+	)
+{
+	struct	netpacket *pkt;		/* Pointer to packet buffer	*/
 
-	pkt = (struct netpacket *)getbuf(netbufpool);
+	/* Obtain a packet addressed to the slot's remote endpoint	*/
 
+	pkt = udp_getpkt(slot, 0, 0);
 	if ((int32)pkt == SYSERR) {
-		restore(mask);
 		return SYSERR;
 	}
 
-	/* Compute packet length as UDP data size + fixed header size	*/
+	/* Copy the data into the packet and send it */
 
-	pktlen = ((char *)&pkt->net_udpdata - (char *)pkt) + len;
+	if ( (len > 0) && (len <= sizeof(pkt->net_udpdata)) ) {
+		memcpy((char *)pkt->net_udpdata, buff, len);
+	}
+	return udp_sendpkt(pkt, len);
+}
 
-	/* Create UDP packet in pkt */
 
-	memcpy((char *)pkt->net_ethsrc,NetData.ethucast,ETH_ADDR_LEN);
-        pkt->net_ethtype = 0x0800;	/* Type is IP */
-	pkt->net_ipvh = 0x45;		/* IP version and hdr length	*/
-	pkt->net_iptos = 0x00;		/* Type of service		*/
-	pkt->net_iplen= pktlen - ETH_HDR_LEN;/* total IP datagram length*/
-	pkt->net_ipid = ident++;	/* Datagram gets next IDENT	*/
-	pkt->net_ipfrag = 0x0000;	/* IP flags & fragment offset	*/
-	pkt->net_ipttl = 0xff;		/* IP time-to-live		*/
-	pkt->net_ipproto = IP_UDP;	/* Datagram carries UDP		*/
-	pkt->net_ipcksum = 0x0000;	/* Initial checksum		*/
-	pkt->net_ipsrc = NetData.ipucast;/* IP source address		*/
-	pkt->net_ipdst = remip;		/* IP destination address	*/
-	pkt->net_udpsport = udptr->udlocport;/* local UDP protocol port	*/
-	pkt->net_udpdport = remport;	/* Remote UDP protocol port	*/
-	pkt->net_udplen = (uint16)(UDP_HDR_LEN+len); /* UDP length	*/
-	pkt->net_udpcksum = 0x0000;	/* Ignore UDP checksum		*/
-	udataptr = (char *) pkt->net_udpdata;
-	memcpy(udataptr, buff, len);
+/*------------------------------------------------------------------------
+ * udp_sendto  -  Send a UDP packet to a specified destination
+ *------------------------------------------------------------------------
+ */
+status	udp_sendto (
+	 uid32	slot,			/* UDP table slot to use	*/
+	 uint32	remip,			/* Remote IP address to use	*/
+	 uint16	remport,		/* Remote protocol port to use	*/
+	 char   *buff,			/* Buffer of UDP data		*/
+	 int32	len			/* Length of data in buffer	*/
+	)
+{
+	struct	netpacket *pkt;		/* Pointer to a packet buffer	*/
 
-	/* Call ipsend to send the datagram */
+	if (remip == 0) {
+		return SYSERR;
+	}
 
-	ip_send(pkt);
-	restore(mask);
-	return OK;
+	/* Obtain a packet addressed to the specified destination	*/
+
+	pkt = udp_getpkt(slot, remip, remport);
+	if ((int32)pkt == SYSERR) {
+		return SYSERR;
+	}
+
+	/* Copy the data into the packet and send it */
+
+	if ( (len > 0) && (len <= sizeof(pkt->net_udpdata)) ) {
+		memcpy((char *)pkt->net_udpdata, buff, len);
+	}
+	return udp_sendpkt(pkt, len);
 }
 
 
@@ -0,0 +1,374 @@
+/* rdserver.c - main, rdshandle, rdsfile, rdsstats, rdsusage */
+
+/************************************************************************/
+/*									*/
+/* Stand-in remote disk server that runs on a Linux host.  Each disk	*/
+/* is kept in a file named by the disk ID in the data directory; a	*/
+/* block beyond the end of the file reads as zeroes.  Requests are	*/
+/* handled in the order they arrive, and a reply carries the sequence	*/
+/* number of the request, which is all the pipelined Xinu client	*/
+/* needs.  Statistics are printed on SIGINT or SIGTERM, and the -l	*/
+/* option drops a percentage of requests to exercise retransmission.	*/
+/*									*/
+/* use:  rdserver [-p port] [-d dir] [-l percent] [-v]			*/
+/*									*/
+/************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <signal.h>
+#include <sys/time.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+/* Definitions that must agree with include/rdisksys.h in Xinu */
+
+#define	RD_BLKSIZ	512		/* Remote disk block size	*/
+#define	RD_IDLEN	64		/* Size of a remote disk ID	*/
+#define	RD_SERVER_PORT	53124		/* Default UDP port		*/
+
+#define	RD_MSG_RESPONSE	0x0100		/* Bit that indicates response	*/
+#define	RD_MSG_RREQ	0x0010		/* Read request			*/
+#define	RD_MSG_WREQ	0x0020		/* Write request		*/
+#define	RD_MSG_OREQ	0x0030		/* Open request			*/
+#define	RD_MSG_CREQ	0x0040		/* Close request		*/
+#define	RD_MSG_DREQ	0x0050		/* Delete request		*/
+#define	RD_MSG_MRREQ	0x0060		/* Multi-block read request	*/
+#define	RD_MSG_MWREQ	0x0070		/* Multi-block write request	*/
+#define	RD_MAXBLKS	16		/* Max. blocks in a multi-block	*/
+					/*   message			*/
+
+#pragma pack(2)
+struct	rd_msg	{			/* Single-block read reply or	*/
+	uint16_t rd_type;		/*   write request; other	*/
+	uint16_t rd_status;		/*   messages are a prefix	*/
+	uint32_t rd_seq;
+	char	rd_id[RD_IDLEN];
+	uint32_t rd_blk;
+	char	rd_data[RD_BLKSIZ];
+};
+
+struct	rd_mmsg	{			/* Multi-block read reply or	*/
+	uint16_t rd_type;		/*   write request		*/
+	uint16_t rd_status;
+	uint32_t rd_seq;
+	char	rd_id[RD_IDLEN];
+	uint32_t rd_blk;
+	uint32_t rd_nblks;
+	char	rd_data[RD_MAXBLKS*RD_BLKSIZ];
+};
+#pragma pack()
+
+#define	RD_HDRLEN	(sizeof(struct rd_msg) - sizeof(uint32_t) - RD_BLKSIZ)
+#define	RD_BLKLEN	(RD_HDRLEN + sizeof(uint32_t))
+#define	RD_MHDRLEN	(RD_BLKLEN + sizeof(uint32_t))
+
+/* Server state and statistics */
+
+static	char	*datadir = ".";		/* Directory that holds disks	*/
+static	int	losspct = 0;		/* Percent of requests dropped	*/
+static	int	verbose = 0;		/* Print each request?		*/
+
+static	unsigned long	nreq[8];	/* Requests by type (index is	*/
+					/*   type >> 4)			*/
+static	unsigned long	nbad;		/* Malformed requests		*/
+static	unsigned long	ndropped;	/* Requests dropped (-l)	*/
+static	unsigned long	nerr;		/* Requests that failed		*/
+static	unsigned long long nbytes;	/* Data bytes read and written	*/
+static	struct	timeval	tstart;		/* Time of the first request	*/
+static	volatile sig_atomic_t done = 0;	/* Set by the signal handler	*/
+
+static	void	rdshandle(struct rd_mmsg *, int *);
+static	int	rdsfile(const char *, int);
+static	void	rdsstats(void);
+static	void	rdsusage(const char *);
+
+static	void	rdsquit(int sig) { done = 1; }
+
+/*------------------------------------------------------------------------
+ * main  -  Parse arguments, bind the server port, and handle requests
+ *------------------------------------------------------------------------
+ */
+int	main(int argc, char *argv[])
+{
+	int	port = RD_SERVER_PORT;	/* UDP port to use		*/
+	int	sock;			/* Server socket		*/
+	int	opt;			/* Option letter		*/
+	int	len;			/* Length of message/reply	*/
+	struct	sockaddr_in sin;	/* Local address		*/
+	struct	sockaddr_in from;	/* Client address		*/
+	socklen_t flen;			/* Length of client address	*/
+	struct	rd_mmsg	msg;		/* Request and reply (large	*/
+					/*   enough for any message)	*/
+	struct	sigaction sa;		/* Handler for SIGINT/SIGTERM	*/
+
+	while ((opt = getopt(argc, argv, "p:d:l:v")) != -1) {
+		switch (opt) {
+		case 'p':	port = atoi(optarg);	break;
+		case 'd':	datadir = optarg;	break;
+		case 'l':	losspct = atoi(optarg);	break;
+		case 'v':	verbose = 1;		break;
+		default:	rdsusage(argv[0]);
+		}
+	}
+	if (optind != argc || port <= 0 || port > 65535 ||
+	    losspct < 0 || losspct > 100) {
+		rdsusage(argv[0]);
+	}
+
+	sock = socket(AF_INET, SOCK_DGRAM, 0);
+	if (sock < 0) {
+		perror("socket");
+		exit(1);
+	}
+	memset(&sin, 0, sizeof(sin));
+	sin.sin_family = AF_INET;
+	sin.sin_addr.s_addr = htonl(INADDR_ANY);
+	sin.sin_port = htons(port);
+	if (bind(sock, (struct sockaddr *)&sin, sizeof(sin)) < 0) {
+		perror("bind");
+		exit(1);
+	}
+
+	/* Stop cleanly (and print statistics) on an interrupt */
+
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_handler = rdsquit;
+	sigaction(SIGINT, &sa, NULL);
+	sigaction(SIGTERM, &sa, NULL);
+
+	srandom(getpid());
+	printf("rdserver: serving %s on UDP port %d\n", datadir, port);
+
+	while (!done) {
+		flen = sizeof(from);
+		len = recvfrom(sock, &msg, sizeof(msg), 0,
+				(struct sockaddr *)&from, &flen);
+		if (len < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			perror("recvfrom");
+			break;
+		}
+		if (tstart.tv_sec == 0) {
+			gettimeofday(&tstart, NULL);
+		}
+		if (losspct > 0 && (random() % 100) < losspct) {
+			ndropped++;
+			continue;
+		}
+		rdshandle(&msg, &len);
+		if (len > 0) {
+			sendto(sock, &msg, len, 0,
+				(struct sockaddr *)&from, flen);
+		}
+	}
+	rdsstats();
+	return 0;
+}
+
+/*------------------------------------------------------------------------
+ * rdshandle  -  Handle one request in place, turning it into the reply
+ *		   and setting *lenp to the reply length (0 for no reply)
+ *------------------------------------------------------------------------
+ */
+static	void	rdshandle(struct rd_mmsg *mmsg, int *lenp)
+{
+	struct	rd_msg	*msg;		/* Single-block view of message	*/
+	int	len = *lenp;		/* Length of the request	*/
+	int	type;			/* Request type			*/
+	int	fd;			/* Disk file			*/
+	uint32_t blk;			/* Block number in a request	*/
+	uint32_t nblks;			/* Blocks in a multi-block msg	*/
+	off_t	off;			/* Byte offset of the block	*/
+	ssize_t	n;			/* Bytes transferred		*/
+	int	ok = 1;			/* Did the request succeed?	*/
+
+	msg = (struct rd_msg *)mmsg;
+
+	*lenp = 0;
+	if (len < (int)RD_HDRLEN) {
+		nbad++;
+		return;
+	}
+	type = ntohs(msg->rd_type);
+	msg->rd_id[RD_IDLEN - 1] = '\0';
+	if (msg->rd_id[0] == '\0' || strchr(msg->rd_id, '/') != NULL ||
+	    type < RD_MSG_RREQ || type > RD_MSG_MWREQ ||
+	    (type & 0xf) != 0) {
+		nbad++;
+		return;
+	}
+	nreq[type >> 4]++;
+
+	switch (type) {
+
+	case RD_MSG_MRREQ:
+	case RD_MSG_MWREQ:
+		if (len < (int)RD_MHDRLEN) {
+			nbad++;
+			return;
+		}
+		blk = ntohl(mmsg->rd_blk);
+		nblks = ntohl(mmsg->rd_nblks);
+		off = (off_t)blk * RD_BLKSIZ;
+		if (nblks == 0 || nblks > RD_MAXBLKS ||
+		    (type == RD_MSG_MWREQ &&
+		     len < (int)(RD_MHDRLEN + nblks * RD_BLKSIZ))) {
+			nbad++;
+			return;
+		}
+		if (type == RD_MSG_MRREQ) {
+			memset(mmsg->rd_data, 0, nblks * RD_BLKSIZ);
+			fd = rdsfile(msg->rd_id, O_RDONLY);
+			if (fd >= 0) {
+				n = pread(fd, mmsg->rd_data,
+						nblks * RD_BLKSIZ, off);
+				ok = (n >= 0);
+				close(fd);
+			} else {
+				ok = (errno == ENOENT);
+			}
+			*lenp = RD_MHDRLEN + nblks * RD_BLKSIZ;
+		} else {
+			fd = rdsfile(msg->rd_id, O_WRONLY | O_CREAT);
+			ok = (fd >= 0);
+			if (ok) {
+				n = pwrite(fd, mmsg->rd_data,
+						nblks * RD_BLKSIZ, off);
+				ok = (n == (ssize_t)(nblks * RD_BLKSIZ));
+				close(fd);
+			}
+			*lenp = RD_MHDRLEN;
+		}
+		nbytes += nblks * RD_BLKSIZ;
+		break;
+
+	case RD_MSG_RREQ:
+		if (len < (int)RD_BLKLEN) {
+			nbad++;
+			return;
+		}
+		blk = ntohl(msg->rd_blk);
+		off = (off_t)blk * RD_BLKSIZ;
+		memset(msg->rd_data, 0, RD_BLKSIZ);
+		fd = rdsfile(msg->rd_id, O_RDONLY);
+		if (fd >= 0) {
+			n = pread(fd, msg->rd_data, RD_BLKSIZ, off);
+			ok = (n >= 0);
+			close(fd);
+		} else {
+			ok = (errno == ENOENT);	/* Unwritten disk	*/
+		}
+		nbytes += RD_BLKSIZ;
+		*lenp = sizeof(struct rd_msg);
+		break;
+
+	case RD_MSG_WREQ:
+		if (len < (int)sizeof(struct rd_msg)) {
+			nbad++;
+			return;
+		}
+		blk = ntohl(msg->rd_blk);
+		off = (off_t)blk * RD_BLKSIZ;
+		fd = rdsfile(msg->rd_id, O_WRONLY | O_CREAT);
+		ok = (fd >= 0);
+		if (ok) {
+			n = pwrite(fd, msg->rd_data, RD_BLKSIZ, off);
+			ok = (n == RD_BLKSIZ);
+			close(fd);
+		}
+		nbytes += RD_BLKSIZ;
+		*lenp = RD_BLKLEN;
+		break;
+
+	case RD_MSG_OREQ:
+		fd = rdsfile(msg->rd_id, O_RDWR | O_CREAT);
+		ok = (fd >= 0);
+		if (ok) {
+			close(fd);
+		}
+		*lenp = RD_HDRLEN;
+		break;
+
+	case RD_MSG_CREQ:
+		*lenp = RD_HDRLEN;
+		break;
+
+	case RD_MSG_DREQ:
+		fd = rdsfile(msg->rd_id, -1);	/* Unlink the file	*/
+		ok = (fd == 0 || errno == ENOENT);
+		*lenp = RD_HDRLEN;
+		break;
+	}
+
+	if (!ok) {
+		nerr++;
+	}
+	if (verbose) {
+		printf("type 0x%04x seq %u id %s%s\n", type,
+			(unsigned)ntohl(msg->rd_seq), msg->rd_id,
+			ok ? "" : " FAILED");
+	}
+	msg->rd_type = htons(type | RD_MSG_RESPONSE);
+	msg->rd_status = htons(ok ? 0 : 1);
+}
+
+/*------------------------------------------------------------------------
+ * rdsfile  -  Open the file for a disk with the given flags (or unlink
+ *		 it when flags is -1)
+ *------------------------------------------------------------------------
+ */
+static	int	rdsfile(const char *id, int flags)
+{
+	char	path[4096];		/* Path name of the disk file	*/
+
+	snprintf(path, sizeof(path), "%s/%s", datadir, id);
+	if (flags == -1) {
+		return unlink(path);
+	}
+	return open(path, flags, 0644);
+}
+
+/*------------------------------------------------------------------------
+ * rdsstats  -  Print request counts and throughput
+ *------------------------------------------------------------------------
+ */
+static	void	rdsstats(void)
+{
+	struct	timeval	now;		/* Current time			*/
+	double	secs;			/* Seconds since first request	*/
+
+	gettimeofday(&now, NULL);
+	secs = (now.tv_sec - tstart.tv_sec) +
+		(now.tv_usec - tstart.tv_usec) / 1e6;
+	printf("\nrdserver: %lu reads, %lu writes, %lu opens, "
+		"%lu closes, %lu deletes\n", nreq[1], nreq[2], nreq[3],
+		nreq[4], nreq[5]);
+	printf("rdserver: %lu multi-block reads, %lu multi-block writes\n",
+		nreq[6], nreq[7]);
+	printf("rdserver: %lu malformed, %lu dropped, %lu failed\n",
+		nbad, ndropped, nerr);
+	if (tstart.tv_sec != 0 && secs > 0) {
+		printf("rdserver: %llu data bytes in %.3f s (%.1f KB/s)\n",
+			nbytes, secs, nbytes / 1024.0 / secs);
+	}
+}
+
+/*------------------------------------------------------------------------
+ * rdsusage  -  Print a usage message and exit
+ *------------------------------------------------------------------------
+ */
+static	void	rdsusage(const char *prog)
+{
+	fprintf(stderr, "use: %s [-p port] [-d dir] [-l percent] [-v]\n",
+		prog);
+	exit(1);
+}
@@ -10,12 +10,15 @@
 const	struct	cmdent	cmdtab[] = {
 	{"argecho",	TRUE,	xsh_argecho},
 	{"arp",		FALSE,	xsh_arp},
+	{"biostat",	FALSE,	xsh_biostat},
+	{"bufstat",	FALSE,	xsh_bufstat},
 	{"cat",		FALSE,	xsh_cat},
 	{"clear",	TRUE,	xsh_clear},
 	{"date",	FALSE,	xsh_date},
 	{"devdump",	FALSE,	xsh_devdump},
 	{"echo",	FALSE,	xsh_echo},
 	{"exit",	TRUE,	xsh_exit},
+	{"fsbench",	FALSE,	xsh_fsbench},
 	{"help",	FALSE,	xsh_help},
 	{"kill",	TRUE,	xsh_kill},
 	{"ls",		FALSE,	xsh_ls},
@@ -25,7 +28,9 @@ const	struct	cmdent	cmdtab[] = {
 	{"ns",		FALSE,	xsh_ns},
 	{"ping",	FALSE,	xsh_ping},
 	{"ps",		FALSE,	xsh_ps},
+	{"rdstat",	FALSE,	xsh_rdstat},
 	{"sleep",	FALSE,	xsh_sleep},
+	{"ttybench",	FALSE,	xsh_ttybench},
 	{"udp",		FALSE,	xsh_udpdump},
 	{"udpecho",	FALSE,	xsh_udpecho},
 	{"udpeserver",	FALSE,	xsh_udpeserver},
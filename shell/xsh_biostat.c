@@ -0,0 +1,65 @@
+/* xsh_biostat.c - xsh_biostat */
+
+#include <xinu.h>
+#include <stdio.h>
+#include <string.h>
+
+/*------------------------------------------------------------------------
+ * xsh_biostat - shell command to display the block request queues
+ *------------------------------------------------------------------------
+ */
+shellcmd xsh_biostat(int nargs, char *args[])
+{
+	int32	i;			/* Index into bioqtab		*/
+	struct	bioqueue *bqptr;	/* Ptr to entry in bioqtab	*/
+	intmask	mask;			/* Saved interrupt mask		*/
+	struct	bioqueue bq;		/* Copy of an entry, so printing*/
+					/*   does not hold interrupts	*/
+					/*   disabled			*/
+
+	/* For argument '--help', emit help about the 'biostat' command	*/
+
+	if (nargs == 2 && strncmp(args[1], "--help", 7) == 0) {
+		printf("Use: %s\n\n", args[0]);
+		printf("Description:\n");
+		printf("\tDisplays the block request queue of each device\n");
+		printf("\tthat has received requests: the current and\n");
+		printf("\tlargest depth, the requests and blocks submitted,\n");
+		printf("\tthe transfers given to the driver, the requests\n");
+		printf("\tmerged into another transfer, and the plugs held\n");
+		printf("Options:\n");
+		printf("\t--help\t display this help and exit\n");
+		return 0;
+	}
+
+	/* Check for valid number of arguments */
+
+	if (nargs > 1) {
+		fprintf(stderr, "%s: no arguments expected\n", args[0]);
+		fprintf(stderr, "Try '%s --help' for more information\n",
+				args[0]);
+		return 1;
+	}
+
+	printf("%3s %-10s %5s %5s %8s %8s %8s %8s %5s\n",
+		"Dev", "Name", "Depth", "Max", "Reqs", "Blocks", "Xfers",
+		"Merged", "Plugs");
+	printf("%3s %-10s %5s %5s %8s %8s %8s %8s %5s\n",
+		"---", "----------", "-----", "-----", "--------",
+		"--------", "--------", "--------", "-----");
+
+	for (i=0; i<NDEVS; i++) {
+		mask = disable();
+		bqptr = &bioqtab[i];
+		bq = *bqptr;
+		restore(mask);
+		if (bq.bq_nreqs == 0) {
+			continue;
+		}
+		printf("%3d %-10s %5d %5d %8u %8u %8u %8u %5d\n",
+			i, devtab[i].dvname, bq.bq_depth, bq.bq_maxdepth,
+			bq.bq_nreqs, bq.bq_nblks, bq.bq_nxfers,
+			bq.bq_nmerged, bq.bq_plugs);
+	}
+	return 0;
+}
@@ -0,0 +1,60 @@
+/* xsh_bufstat.c - xsh_bufstat */
+
+#include <xinu.h>
+#include <stdio.h>
+#include <string.h>
+
+/*------------------------------------------------------------------------
+ * xsh_bufstat - shell command to display use of the buffer pools
+ *------------------------------------------------------------------------
+ */
+shellcmd xsh_bufstat(int nargs, char *args[])
+{
+	int32	i;			/* Index into buftab		*/
+	struct	bpentry	*bpptr;		/* Ptr to entry in buftab	*/
+	intmask	mask;			/* Saved interrupt mask		*/
+	int32	size, total, used;	/* Values from an entry, copied	*/
+	int32	maxused;		/*   so printing does not hold	*/
+	uint32	exhaust;		/*   interrupts disabled	*/
+
+	/* For argument '--help', emit help about the 'bufstat' command	*/
+
+	if (nargs == 2 && strncmp(args[1], "--help", 7) == 0) {
+		printf("Use: %s\n\n", args[0]);
+		printf("Description:\n");
+		printf("\tDisplays the size and use of each buffer pool,\n");
+		printf("\tincluding the most buffers ever in use and the\n");
+		printf("\tnumber of requests that found the pool empty\n");
+		printf("Options:\n");
+		printf("\t--help\t display this help and exit\n");
+		return 0;
+	}
+
+	/* Check for valid number of arguments */
+
+	if (nargs > 1) {
+		fprintf(stderr, "%s: no arguments expected\n", args[0]);
+		fprintf(stderr, "Try '%s --help' for more information\n",
+				args[0]);
+		return 1;
+	}
+
+	printf("%4s %6s %6s %6s %6s %8s\n",
+		"Pool", "Size", "Bufs", "Used", "Max", "Empty");
+	printf("%4s %6s %6s %6s %6s %8s\n",
+		"----", "------", "------", "------", "------", "--------");
+
+	for (i=0; i<nbpools; i++) {
+		mask = disable();
+		bpptr = &buftab[i];
+		size = bpptr->bpsize;
+		total = bpptr->bpnbufs;
+		used = bpused(bpptr);
+		maxused = bpptr->bpmaxused;
+		exhaust = bpptr->bpexhaust;
+		restore(mask);
+		printf("%4d %6d %6d %6d %6d %8u\n",
+			i, size, total, used, maxused, exhaust);
+	}
+	return 0;
+}
@@ -0,0 +1,482 @@
+/* xsh_fsbench.c - xsh_fsbench, fbworker, fbop, fbusec, fbsort */
+
+#include <xinu.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define	FB_MAXPROCS	8		/* Most concurrent processes	*/
+#define	FB_MAXBSIZ	8192		/* Largest request size		*/
+#define	FB_MAXSAMP	2048		/* Latencies kept per process	*/
+#define	FB_STACK	16384		/* Stack size of a worker	*/
+#define	FB_CALMS	200		/* Time to calibrate the TSC	*/
+
+/* Workloads */
+
+#define	FB_SEQWR	0		/* Sequential write		*/
+#define	FB_SEQRD	1		/* Sequential read		*/
+#define	FB_RANDWR	2		/* Random write			*/
+#define	FB_RANDRD	3		/* Random read			*/
+#define	FB_CREATE	4		/* Create and delete files	*/
+#define	FB_NLOADS	5		/* Number of workloads		*/
+
+local	char	*fbnames[FB_NLOADS] = {
+		"seqwr", "seqrd", "randwr", "randrd", "create" };
+
+struct	fbwork	{			/* Work of one process		*/
+	int32	fw_load;		/* Workload to run		*/
+	char	fw_name[NM_MAXLEN];	/* File the process uses	*/
+	uint32	fw_size;		/* Bytes in the file		*/
+	uint32	fw_bsize;		/* Bytes in a request		*/
+	uint32	fw_nfiles;		/* Files to create and delete	*/
+	char	*fw_buf;		/* Buffer for a request		*/
+	uint32	*fw_lat;		/* Latencies of operations (us)	*/
+	uint32	fw_nlat;		/* Latencies recorded		*/
+	uint32	fw_ops;			/* Operations performed		*/
+	uint32	fw_bytes;		/* Bytes transferred		*/
+	uint32	fw_errors;		/* Operations that failed	*/
+	sid32	fw_ready;		/* Signaled when ready to start	*/
+	sid32	fw_start;		/* Waited on before starting	*/
+	sid32	fw_done;		/* Signaled when finished	*/
+};
+
+local	uint32	fbtpms;			/* TSC ticks / 256 per ms	*/
+
+local	process	fbworker(struct fbwork *);
+local	bool8	fbop(struct fbwork *, int32, uint32);
+local	uint32	fbusec(uint64);
+local	void	fbsort(uint32 *, uint32);
+
+/*------------------------------------------------------------------------
+ * xsh_fsbench - shell command to measure the performance of a file
+ *		   system by running workloads against files
+ *------------------------------------------------------------------------
+ */
+shellcmd xsh_fsbench(int nargs, char *args[])
+{
+	char	*path = "/local/fsb";	/* Prefix of file names		*/
+	int32	load = -1;		/* Workload, or -1 for all	*/
+	uint32	size = 65536;		/* Bytes in each file		*/
+	uint32	bsize = 512;		/* Bytes in a request		*/
+	uint32	nfiles = 32;		/* Files per create storm	*/
+	int32	nprocs = 1;		/* Concurrent processes		*/
+	bool8	csv = FALSE;		/* Print results as CSV?	*/
+	struct	fbwork	work[FB_MAXPROCS];/* Work of each process	*/
+	struct	fbwork	*wp;		/* Pointer to a process's work	*/
+	sid32	ready, start, done;	/* Semaphores for the workers	*/
+	uint32	*lat;			/* Latencies of all processes	*/
+	uint32	nlat;			/* Number of latencies		*/
+	uint32	ops, bytes, errors;	/* Totals for a workload	*/
+	uint32	usec;			/* Elapsed time of a workload	*/
+	uint32	msec;			/* Elapsed time in ms (min. 1)	*/
+	uint64	t0, t1;			/* TSC at start and end		*/
+	int32	first, last;		/* Range of workloads to run	*/
+	int32	nstarted;		/* Processes that were started	*/
+	pid32	pid;			/* ID of a new process		*/
+	int32	retval;			/* Value to return		*/
+	int32	l, i;			/* Walk workloads / processes	*/
+	uint32	j;			/* Walks latencies		*/
+
+	/* For argument '--help', emit help about the 'fsbench' command	*/
+
+	if (nargs == 2 && strncmp(args[1], "--help", 7) == 0) {
+		printf("Use: %s [-w load] [-f path] [-s size] [-b bsize]\n",
+				args[0]);
+		printf("       [-n nfiles] [-p nprocs] [-c]\n\n");
+		printf("Description:\n");
+		printf("\tRuns file system workloads and reports the\n");
+		printf("\tthroughput, operations per second, and latency\n");
+		printf("\tpercentiles (from the first %d operations of\n",
+				FB_MAXSAMP);
+		printf("\teach process) of each one\n");
+		printf("Options:\n");
+		printf("\t-w load\t seqwr, seqrd, randwr, randrd, or create\n");
+		printf("\t\t (default: all of them in that order)\n");
+		printf("\t-f path\t prefix of the file names; process i\n");
+		printf("\t\t uses path<i> (default: %s)\n", path);
+		printf("\t-s size\t bytes in each file (default: %d)\n", size);
+		printf("\t-b bsize bytes in a request (default: %d)\n", bsize);
+		printf("\t-n num\t files each process creates and deletes\n");
+		printf("\t\t in the create workload (default: %d)\n", nfiles);
+		printf("\t-p num\t concurrent processes, at most %d\n",
+				FB_MAXPROCS);
+		printf("\t-c\t print results as comma-separated values\n");
+		printf("\t--help\t display this help and exit\n");
+		return 0;
+	}
+
+	/* Parse the options */
+
+	for (i=1; i<nargs; i++) {
+		if (strncmp(args[i], "-c", 3) == 0) {
+			csv = TRUE;
+			continue;
+		}
+		if (i+1 >= nargs) {
+			break;
+		}
+		if (strncmp(args[i], "-w", 3) == 0) {
+			for (load=0; load<FB_NLOADS; load++) {
+				if (strncmp(args[i+1], fbnames[load], 8) == 0) {
+					break;
+				}
+			}
+			if (load >= FB_NLOADS) {
+				break;
+			}
+		} else if (strncmp(args[i], "-f", 3) == 0) {
+			path = args[i+1];
+		} else if (strncmp(args[i], "-s", 3) == 0) {
+			size = atoi(args[i+1]);
+		} else if (strncmp(args[i], "-b", 3) == 0) {
+			bsize = atoi(args[i+1]);
+		} else if (strncmp(args[i], "-n", 3) == 0) {
+			nfiles = atoi(args[i+1]);
+		} else if (strncmp(args[i], "-p", 3) == 0) {
+			nprocs = atoi(args[i+1]);
+		} else {
+			break;
+		}
+		i++;
+	}
+	if ( (i < nargs) || (bsize == 0) || (bsize > FB_MAXBSIZ) ||
+	     (size < bsize) || (nprocs < 1) || (nprocs > FB_MAXPROCS) ||
+	     (strlen(path) > NM_MAXLEN - 16) ) {
+		fprintf(stderr, "%s: invalid arguments\n", args[0]);
+		fprintf(stderr, "Try '%s --help' for more information\n",
+				args[0]);
+		return 1;
+	}
+	size -= size % bsize;
+
+	/* Find the rate of the time stamp counter */
+
+	t0 = getticks();
+	sleepms(FB_CALMS);
+	t1 = getticks();
+	fbtpms = (uint32)((t1 - t0) >> 8) / FB_CALMS;
+	if (fbtpms == 0) {
+		fbtpms = 1;
+	}
+
+	/* Allocate buffers for the processes */
+
+	lat = (uint32 *)getmem(nprocs * FB_MAXSAMP * sizeof(uint32));
+	if (lat == (uint32 *)SYSERR) {
+		fprintf(stderr, "%s: out of memory\n", args[0]);
+		return 1;
+	}
+	for (i=0; i<nprocs; i++) {
+		wp = &work[i];
+		wp->fw_buf = getmem(bsize);
+		wp->fw_lat = (uint32 *)getmem(FB_MAXSAMP * sizeof(uint32));
+		if ( (wp->fw_buf == (char *)SYSERR) ||
+		     (wp->fw_lat == (uint32 *)SYSERR) ) {
+			fprintf(stderr, "%s: out of memory\n", args[0]);
+			for (; i>=0; i--) {
+				if (work[i].fw_buf != (char *)SYSERR) {
+					freemem(work[i].fw_buf, bsize);
+				}
+				if (work[i].fw_lat != (uint32 *)SYSERR) {
+					freemem((char *)work[i].fw_lat,
+					    FB_MAXSAMP * sizeof(uint32));
+				}
+			}
+			freemem((char *)lat,
+				nprocs * FB_MAXSAMP * sizeof(uint32));
+			return 1;
+		}
+		memset(wp->fw_buf, 'a' + i, bsize);
+		sprintf(wp->fw_name, "%s%d", path, i);
+		wp->fw_size = size;
+		wp->fw_bsize = bsize;
+		wp->fw_nfiles = nfiles;
+	}
+
+	if (csv) {
+		printf("workload,procs,bsize,ops,kbytes,usec,kbps,iops,");
+		printf("p50us,p90us,p99us,maxus,errors\n");
+	} else {
+		printf("%-7s %5s %5s %7s %7s %8s %7s %7s "
+			"%6s %6s %6s %7s %5s\n", "Load", "Procs", "BSize",
+			"Ops", "KB", "msec", "KB/s", "IOPS", "p50us",
+			"p90us", "p99us", "maxus", "Errs");
+		printf("%-7s %5s %5s %7s %7s %8s %7s %7s "
+			"%6s %6s %6s %7s %5s\n", "-------", "-----",
+			"-----", "-------", "-------", "--------", "-------",
+			"-------", "------", "------", "------", "-------",
+			"-----");
+	}
+
+	retval = 0;
+	first = (load == -1) ? 0 : load;
+	last = (load == -1) ? FB_NLOADS - 1 : load;
+	for (l=first; l<=last; l++) {
+
+		/* Start the processes, which prepare their files and	*/
+		/*   then wait so they all start together		*/
+
+		ready = semcreate(0);
+		start = semcreate(0);
+		done = semcreate(0);
+		nstarted = 0;
+		if ( (ready != SYSERR) && (start != SYSERR) &&
+		     (done != SYSERR) ) {
+			for (; nstarted<nprocs; nstarted++) {
+				wp = &work[nstarted];
+				wp->fw_load = l;
+				wp->fw_nlat = wp->fw_ops = wp->fw_bytes = 0;
+				wp->fw_errors = 0;
+				wp->fw_ready = ready;
+				wp->fw_start = start;
+				wp->fw_done = done;
+				pid = create(fbworker, FB_STACK,
+					getprio(getpid()), "fsbench", 1, wp);
+				if (pid == SYSERR) {
+					break;
+				}
+				resume(pid);
+			}
+		}
+		for (i=0; i<nstarted; i++) {
+			wait(ready);
+		}
+		t0 = getticks();
+		if (nstarted > 0) {
+			signaln(start, nstarted);
+		}
+		for (i=0; i<nstarted; i++) {
+			wait(done);
+		}
+		t1 = getticks();
+		if (ready != SYSERR) {
+			semdelete(ready);
+		}
+		if (start != SYSERR) {
+			semdelete(start);
+		}
+		if (done != SYSERR) {
+			semdelete(done);
+		}
+
+		/* If not every process could be started, stop (those	*/
+		/*   that were started have finished)			*/
+
+		if (nstarted < nprocs) {
+			fprintf(stderr, "%s: cannot start processes\n",
+					args[0]);
+			retval = 1;
+			break;
+		}
+
+		/* Combine the results of the processes */
+
+		ops = bytes = errors = nlat = 0;
+		for (i=0; i<nprocs; i++) {
+			wp = &work[i];
+			ops += wp->fw_ops;
+			bytes += wp->fw_bytes;
+			errors += wp->fw_errors;
+			for (j=0; j<wp->fw_nlat; j++) {
+				lat[nlat++] = wp->fw_lat[j];
+			}
+		}
+		fbsort(lat, nlat);
+		if (nlat == 0) {
+			lat[0] = 0;
+			nlat = 1;
+		}
+		usec = fbusec(t1 - t0);
+		msec = (usec < 1000) ? 1 : usec / 1000;
+		if (csv) {
+			printf("%s,%d,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u\n",
+				fbnames[l], nprocs, bsize, ops, bytes / 1024,
+				usec, (bytes / 1024) * 1000 / msec,
+				ops * 1000 / msec, lat[nlat / 2],
+				lat[(nlat * 9) / 10], lat[(nlat * 99) / 100],
+				lat[nlat - 1], errors);
+		} else {
+			printf("%-7s %5d %5u %7u %7u %8u %7u %7u "
+				"%6u %6u %6u %7u %5u\n", fbnames[l], nprocs,
+				bsize, ops, bytes / 1024, msec,
+				(bytes / 1024) * 1000 / msec,
+				ops * 1000 / msec, lat[nlat / 2],
+				lat[(nlat * 9) / 10], lat[(nlat * 99) / 100],
+				lat[nlat - 1], errors);
+		}
+	}
+
+	for (i=0; i<nprocs; i++) {
+		freemem(work[i].fw_buf, bsize);
+		freemem((char *)work[i].fw_lat, FB_MAXSAMP * sizeof(uint32));
+	}
+	freemem((char *)lat, nprocs * FB_MAXSAMP * sizeof(uint32));
+	return retval;
+}
+
+/*------------------------------------------------------------------------
+ * fbworker  -  Process that runs one workload on its own file(s)
+ *------------------------------------------------------------------------
+ */
+local	process	fbworker (
+	  struct fbwork	*wp		/* Work to perform		*/
+	)
+{
+	did32	fd;			/* File being read or written	*/
+	uint32	nblks;			/* Requests that fill the file	*/
+	uint32	i;			/* Counts operations		*/
+
+	/* Give a read or random-write workload a file of full size */
+
+	fd = SYSERR;
+	if ( (wp->fw_load == FB_SEQRD) || (wp->fw_load == FB_RANDRD) ||
+	     (wp->fw_load == FB_RANDWR) ) {
+		fd = open(NAMESPACE, wp->fw_name, "rw");
+		for (i=0; (fd != SYSERR) && (i<wp->fw_size);
+						i += wp->fw_bsize) {
+			write(fd, wp->fw_buf, wp->fw_bsize);
+		}
+		if (fd != SYSERR) {
+			seek(fd, 0);
+		}
+	} else if (wp->fw_load != FB_CREATE) {
+		fd = open(NAMESPACE, wp->fw_name, "rw");
+	}
+	signal(wp->fw_ready);
+	wait(wp->fw_start);
+
+	nblks = wp->fw_size / wp->fw_bsize;
+	switch (wp->fw_load) {
+
+	case FB_SEQWR:
+	case FB_SEQRD:
+		for (i=0; i<nblks; i++) {
+			fbop(wp, fd, i);
+		}
+		break;
+
+	case FB_RANDWR:
+	case FB_RANDRD:
+		for (i=0; i<nblks; i++) {
+			fbop(wp, fd, rand() % nblks);
+		}
+		break;
+
+	case FB_CREATE:
+		for (i=0; i<wp->fw_nfiles; i++) {
+			fbop(wp, SYSERR, i);
+		}
+		break;
+	}
+	if (fd != SYSERR) {
+		close(fd);
+	}
+	signal(wp->fw_done);
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ * fbop  -  Perform and time one operation of a workload: a request at
+ *	      a given block of the file, or the creation and deletion of
+ *	      a given file
+ *------------------------------------------------------------------------
+ */
+local	bool8	fbop (
+	  struct fbwork	*wp,		/* Work being performed		*/
+	  did32		fd,		/* Open file, if any		*/
+	  uint32	blk		/* Block or file number		*/
+	)
+{
+	char	name[NM_MAXLEN];	/* Name of a file to create	*/
+	char	newname[NM_MAXLEN];	/* Name mapped by the namespace	*/
+	did32	dev;			/* Device of a mapped name	*/
+	uint64	t0;			/* TSC at start of operation	*/
+	int32	retval;			/* Outcome of the operation	*/
+
+	t0 = getticks();
+	retval = SYSERR;
+	switch (wp->fw_load) {
+
+	case FB_SEQWR:
+	case FB_RANDWR:
+		if ( (fd != SYSERR) && ( (wp->fw_load == FB_SEQWR) ||
+		     (seek(fd, blk * wp->fw_bsize) != SYSERR) ) ) {
+			retval = write(fd, wp->fw_buf, wp->fw_bsize);
+		}
+		break;
+
+	case FB_SEQRD:
+	case FB_RANDRD:
+		if ( (fd != SYSERR) && ( (wp->fw_load == FB_SEQRD) ||
+		     (seek(fd, blk * wp->fw_bsize) != SYSERR) ) ) {
+			retval = read(fd, wp->fw_buf, wp->fw_bsize);
+		}
+		break;
+
+	case FB_CREATE:
+		sprintf(name, "%s-%d", wp->fw_name, blk);
+		fd = open(NAMESPACE, name, "rwn");
+		if (fd == SYSERR) {
+			break;
+		}
+		retval = write(fd, wp->fw_buf, wp->fw_bsize);
+		close(fd);
+		dev = nammap(name, newname, NAMESPACE);
+		if ( (dev == SYSERR) ||
+		     (control(dev, F_CTL_DEL, (int32)newname, 0) == SYSERR) ) {
+			retval = SYSERR;
+		}
+		break;
+	}
+
+	wp->fw_ops++;
+	if (retval == SYSERR) {
+		wp->fw_errors++;
+		return FALSE;
+	}
+	wp->fw_bytes += wp->fw_bsize;
+	if (wp->fw_nlat < FB_MAXSAMP) {
+		wp->fw_lat[wp->fw_nlat++] = fbusec(getticks() - t0);
+	}
+	return TRUE;
+}
+
+/*------------------------------------------------------------------------
+ * fbusec  -  Convert a number of TSC ticks to microseconds (without
+ *		64-bit division, which the kernel does not provide)
+ *------------------------------------------------------------------------
+ */
+local	uint32	fbusec (
+	  uint64	ticks		/* Ticks to convert		*/
+	)
+{
+	uint32	units;			/* Ticks / 256			*/
+
+	units = (uint32)(ticks >> 8);
+	return (units / fbtpms) * 1000 + ((units % fbtpms) * 1000) / fbtpms;
+}
+
+/*------------------------------------------------------------------------
+ * fbsort  -  Sort latencies into ascending order (shell sort)
+ *------------------------------------------------------------------------
+ */
+local	void	fbsort (
+	  uint32	*a,		/* Latencies to sort		*/
+	  uint32	n		/* Number of latencies		*/
+	)
+{
+	uint32	gap;			/* Distance between compared	*/
+	uint32	i, j;			/* Indexes into the array	*/
+	uint32	val;			/* Value being inserted		*/
+
+	for (gap = n / 2; gap > 0; gap /= 2) {
+		for (i=gap; i<n; i++) {
+			val = a[i];
+			for (j=i; (j >= gap) && (a[j-gap] > val); j -= gap) {
+				a[j] = a[j-gap];
+			}
+			a[j] = val;
+		}
+	}
+	return;
+}
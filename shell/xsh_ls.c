@@ -11,12 +11,11 @@ shellcmd xsh_ls(int nargs, char *args[])
 {
 	did32	dev;			/* Device to use		*/
 	char	*fname;			/* File name to map to a device	*/
-	struct	lfdir	dir;		/* Copy oif lfs directory	*/
+	struct	ldentry	ent;		/* One slot of an lfs directory	*/
 	char	nbuf[NM_MAXLEN];	/* Buffer namespace can use for	*/
 					/*   a replacement name		*/
 	int32	retval;			/* Return value			*/
 	bool8	loption = FALSE;	/* Did the user specify -l?	*/
-	int32	i;			/* Walks through file names	*/
 	int32	nextarg;		/* Walks through arguments	*/
 	did32	fd;			/* File desc. for remote dir.	*/
 	char	buf[512];		/* Buffer for remote directory	*/
@@ -63,34 +62,36 @@ shellcmd xsh_ls(int nargs, char *args[])
 
 	if (dev == LFILESYS) {
 
-	    wait(Lf_data.lf_mutex);
-	    if ( ! Lf_data.lf_dirpresent ) {
-		retval = read(Lf_data.lf_dskdev,(char *)&Lf_data.lf_dir,
-			LF_AREA_DIR);
-		if (retval == SYSERR ) {
-			fprintf(stderr, "%s: cannot obtain directory\n",
-				args[0]);
-			signal(Lf_data.lf_mutex);
-	                return 1;
-		}
-		if (lfscheck(&Lf_data.lf_dir) == SYSERR ) {
-			fprintf(stderr, "%s: file system uninitialized\n",
-				args[0]);
-			signal(Lf_data.lf_mutex);
-			return 1;
-		}
+	    /* Read the slots of the directory, skipping the header	*/
+	    /*   and slots that do not hold an entry			*/
+
+	    fd = open(LFILESYS, nbuf, "ro");
+	    if (fd == (did32)SYSERR) {
+		fprintf(stderr, "%s: cannot open directory %s\n",
+			args[0], fname);
+		return 1;
 	    }
-	    signal(Lf_data.lf_mutex);
-	    memcpy((void *)&dir, (void *)&Lf_data.lf_dir, sizeof(dir));
-	    for (i = 0; i < dir.lfd_nfiles; i++) {
-		if (loption) {
-		    fprintf(stdout, "%6d  %s\n", dir.lfd_files[i].ld_size,
-			dir.lfd_files[i].ld_name);
-		} else {
-			fprintf(stdout, "        %s\n",
-			dir.lfd_files[i].ld_name);
+	    if (read(fd, (char *)&ent, sizeof(ent)) != sizeof(ent)) {
+		close(fd);
+		return 0;
+	    }
+	    while (read(fd, (char *)&ent, sizeof(ent)) == sizeof(ent)) {
+		if (ent.ld_type == LF_TFILE) {
+		    if (loption) {
+			fprintf(stdout, "%6d  %s\n", ent.ld_size,
+				ent.ld_name);
+		    } else {
+			fprintf(stdout, "        %s\n", ent.ld_name);
+		    }
+		} else if (ent.ld_type == LF_TDIR) {
+		    if (loption) {
+			fprintf(stdout, "%6s  %s/\n", "-", ent.ld_name);
+		    } else {
+			fprintf(stdout, "        %s/\n", ent.ld_name);
+		    }
 		}
 	    }
+	    close(fd);
 
 	/* Handle remote file system */
 
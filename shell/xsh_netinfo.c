@@ -19,6 +19,8 @@ shellcmd xsh_netinfo(int nargs, char *args[]) {
 	uint32	dserver;		/* DNS server address in binary	*/
 	char	str[40];		/* Temporary used for formatting*/
 	uint32	ipmask;			/* Subnet mask in binary	*/
+	int32	i;			/* Index into netqtab		*/
+	struct	netqentry *nqptr;	/* Pointer to an input queue	*/
 
 	/* Output info for '--help' argument */
 
@@ -140,5 +142,16 @@ shellcmd xsh_netinfo(int nargs, char *args[]) {
 	0xff & NetData.ethbcast[4],
 	0xff & NetData.ethbcast[5]);
 
+	/* Depth and drop counts of the packet input queues */
+
+	printf("\n   %-8s %4s %6s %6s %10s %8s\n",
+		"Queue", "Prio", "Depth", "Max", "Packets", "Drops");
+	for (i=0; i<NETQ_NUM; i++) {
+		nqptr = &netqtab[i];
+		printf("   %-8s %4d %6d %6d %10u %8u\n", nqptr->nqname,
+			nqptr->nqprio, nqptr->nqcount, nqptr->nqmax,
+			nqptr->nqpkts, nqptr->nqdrops);
+	}
+
 	return OK;
 }
@@ -20,7 +20,6 @@ shellcmd xsh_ns (
 	char	repname[NM_MAXLEN];	/* Buffer to hold a mapped name	*/
 	did32	dev;			/* Device for a mapped name	*/
 	int32	slen;			/* Length of an argument	*/
-	int32	cpylen;			/* Bytes to copy		*/
 	int32	d;			/* Walks through devtab		*/
 
 	char	err[] = "invalid arguments - type  --help for details";
@@ -101,19 +100,8 @@ shellcmd xsh_ns (
 			fprintf(stderr, "%s\n", err);
 			return 1;
 		}
-		slen = strlen(args[2]) + 1;
-		for (i=0; i<nnames; i++) {
-			nptr = &nametab[i];
-			if (strncmp(args[2],nptr->nprefix, slen)
-								== 0) {
-			    cpylen = (nnames-i-1)*sizeof(struct nmentry);
-			    if (cpylen > 0) {
-				memcpy((void *)nptr,(void *)&nametab[i+1],
-					cpylen);
-			    }
-			    nnames--;
-			    return 0;
-			}
+		if (unmount(args[2]) == OK) {
+			return 0;
 		}
 		fprintf(stderr, "No such entry in the namepace\n");
 		return 1;
@@ -0,0 +1,76 @@
+/* xsh_rdstat.c - xsh_rdstat */
+
+#include <xinu.h>
+#include <stdio.h>
+#include <string.h>
+
+/*------------------------------------------------------------------------
+ * xsh_rdstat - shell command to display remote disk cache statistics
+ *------------------------------------------------------------------------
+ */
+shellcmd xsh_rdstat(int nargs, char *args[])
+{
+	int32	i;			/* Index into rdstab		*/
+	struct	rdscblk	*rdptr;		/* Ptr to entry in rdstab	*/
+	intmask	mask;			/* Saved interrupt mask		*/
+	char	id[RD_IDLEN];		/* Values from an entry, copied	*/
+	int32	csize, ndirty;		/*   so printing does not hold	*/
+	uint32	hits, misses, wbacks;	/*   interrupts disabled	*/
+	uint32	coalesce, retrans;
+	uint32	raissued, rahits;
+
+	/* For argument '--help', emit help about the 'rdstat' command	*/
+
+	if (nargs == 2 && strncmp(args[1], "--help", 7) == 0) {
+		printf("Use: %s\n\n", args[0]);
+		printf("Description:\n");
+		printf("\tDisplays the cache size, cache hits and misses,\n");
+		printf("\tdirty blocks, write backs, coalesced writes,\n");
+		printf("\treadahead requests and the reads they satisfied,\n");
+		printf("\tand retransmissions for each open remote disk\n");
+		printf("Options:\n");
+		printf("\t--help\t display this help and exit\n");
+		return 0;
+	}
+
+	/* Check for valid number of arguments */
+
+	if (nargs > 1) {
+		fprintf(stderr, "%s: no arguments expected\n", args[0]);
+		fprintf(stderr, "Try '%s --help' for more information\n",
+				args[0]);
+		return 1;
+	}
+
+	printf("%3s %-10s %5s %7s %7s %5s %7s %7s %7s %7s %7s\n",
+		"Dev", "Disk ID", "Cache", "Hits", "Misses", "Dirty",
+		"Wbacks", "Coalesc", "RAreqs", "RAhits", "Retrans");
+	printf("%3s %-10s %5s %7s %7s %5s %7s %7s %7s %7s %7s\n",
+		"---", "----------", "-----", "-------", "-------",
+		"-----", "-------", "-------", "-------", "-------",
+		"-------");
+
+	for (i=0; i<Nrds; i++) {
+		mask = disable();
+		rdptr = &rdstab[i];
+		if (rdptr->rd_state != RD_OPEN) {
+			restore(mask);
+			continue;
+		}
+		memcpy(id, rdptr->rd_id, RD_IDLEN);
+		csize = rdptr->rd_csize;
+		ndirty = rdptr->rd_ndirty;
+		hits = rdptr->rd_chits;
+		misses = rdptr->rd_cmisses;
+		wbacks = rdptr->rd_cwbacks;
+		coalesce = rdptr->rd_ccoalesce;
+		retrans = rdptr->rd_retrans;
+		raissued = rdptr->rd_raissued;
+		rahits = rdptr->rd_rahits;
+		restore(mask);
+		printf("%3d %-10.10s %5d %7u %7u %5d %7u %7u %7u %7u %7u\n",
+			i, id, csize, hits, misses, ndirty, wbacks,
+			coalesce, raissued, rahits, retrans);
+	}
+	return 0;
+}
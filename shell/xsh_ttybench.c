@@ -0,0 +1,157 @@
+/* xsh_ttybench.c - xsh_ttybench, tbrun */
+
+#include <xinu.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define	TB_MAXLINE	1024		/* Longest line written		*/
+
+/* Ways of writing a line */
+
+#define	TB_WRITE	0		/* One write call per line	*/
+#define	TB_PUTC		1		/* One putc call per character	*/
+#define	TB_NMODES	2		/* Number of modes		*/
+
+local	char	*tbnames[TB_NMODES] = { "write", "putc" };
+
+local	uint32	tbrun(int32, char *, uint32, uint32, uint32 *);
+
+/*------------------------------------------------------------------------
+ * xsh_ttybench - shell command to measure console output throughput by
+ *		    writing lines to standard output
+ *------------------------------------------------------------------------
+ */
+shellcmd xsh_ttybench(int nargs, char *args[])
+{
+	int32	mode = -1;		/* Mode, or -1 for all		*/
+	uint32	total = 8192;		/* Characters to write		*/
+	uint32	linelen = 64;		/* Characters in each line	*/
+	uint32	msec[TB_NMODES];	/* Elapsed time of each mode	*/
+	uint32	ints[TB_NMODES];	/* Console transmit interrupts	*/
+					/*   during each mode		*/
+	char	*line;			/* Line to write		*/
+	int32	first, last;		/* Range of modes to run	*/
+	int32	m;			/* Walks the modes		*/
+	int32	a;			/* Index into args		*/
+	uint32	i;			/* Index into the line		*/
+
+	/* For argument '--help', emit help about the 'ttybench' command*/
+
+	if (nargs == 2 && strncmp(args[1], "--help", 7) == 0) {
+		printf("Use: %s [-m mode] [-n count] [-l length]\n\n",
+				args[0]);
+		printf("Description:\n");
+		printf("\tWrites lines of text to standard output and\n");
+		printf("\treports the time taken, characters per second,\n");
+		printf("\tand console transmit interrupts for each mode\n");
+		printf("Options:\n");
+		printf("\t-m mode\t write (one write per line) or putc (one\n");
+		printf("\t\t putc per character) (default: both)\n");
+		printf("\t-n count characters to write (default: %d)\n",
+				total);
+		printf("\t-l len\t characters in a line, including the\n");
+		printf("\t\t newline, at most %d (default: %d)\n",
+				TB_MAXLINE, linelen);
+		printf("\t--help\t display this help and exit\n");
+		return 0;
+	}
+
+	/* Parse the options */
+
+	for (a=1; a+1<nargs; a+=2) {
+		if (strncmp(args[a], "-m", 3) == 0) {
+			for (mode=0; mode<TB_NMODES; mode++) {
+				if (strncmp(args[a+1], tbnames[mode], 6) == 0) {
+					break;
+				}
+			}
+			if (mode >= TB_NMODES) {
+				break;
+			}
+		} else if (strncmp(args[a], "-n", 3) == 0) {
+			total = atoi(args[a+1]);
+		} else if (strncmp(args[a], "-l", 3) == 0) {
+			linelen = atoi(args[a+1]);
+		} else {
+			break;
+		}
+	}
+	if ( (a < nargs) || (linelen < 1) || (linelen > TB_MAXLINE) ||
+	     (total < linelen) ) {
+		fprintf(stderr, "%s: invalid arguments\n", args[0]);
+		fprintf(stderr, "Try '%s --help' for more information\n",
+				args[0]);
+		return 1;
+	}
+
+	line = getmem(linelen);
+	if (line == (char *)SYSERR) {
+		fprintf(stderr, "%s: out of memory\n", args[0]);
+		return 1;
+	}
+	for (i=0; i<linelen-1; i++) {
+		line[i] = 'a' + (i % 26);
+	}
+	line[linelen-1] = '\n';
+
+	if (mode < 0) {
+		first = 0;
+		last = TB_NMODES - 1;
+	} else {
+		first = last = mode;
+	}
+	for (m=first; m<=last; m++) {
+		msec[m] = tbrun(m, line, linelen, total / linelen, &ints[m]);
+	}
+	freemem(line, linelen);
+
+	/* Report after all output so the results are not scrolled away	*/
+
+	total -= total % linelen;
+	printf("\n%-6s %8s %8s %8s %8s\n", "Mode", "Chars", "msec",
+			"Chars/s", "TxInts");
+	for (m=first; m<=last; m++) {
+		printf("%-6s %8d %8d %8d %8d\n", tbnames[m], total, msec[m],
+			(total / msec[m]) * 1000 +
+			((total % msec[m]) * 1000) / msec[m], ints[m]);
+	}
+	return 0;
+}
+
+/*------------------------------------------------------------------------
+ * tbrun  -  Write a line a given number of times in one mode and return
+ *		the elapsed time in milliseconds (at least 1), recording
+ *		the transmit interrupts the console handled meanwhile
+ *------------------------------------------------------------------------
+ */
+local	uint32	tbrun (
+	  int32		mode,		/* TB_WRITE or TB_PUTC		*/
+	  char		*line,		/* Line to write		*/
+	  uint32	linelen,	/* Characters in the line	*/
+	  uint32	nlines,		/* Times to write the line	*/
+	  uint32	*ints		/* Where to store interrupts	*/
+	)
+{
+	struct	ttycblk	*typtr;		/* Console's tty control block	*/
+	uint32	txints;			/* Interrupts at the start	*/
+	uint32	start;			/* Time at the start (ms)	*/
+	uint32	elapsed;		/* Elapsed time (ms)		*/
+	uint32	i, j;			/* Walk lines and characters	*/
+
+	typtr = &ttytab[devtab[CONSOLE].dvminor];
+	txints = typtr->tytxints;
+	start = ctr1000;
+	for (i=0; i<nlines; i++) {
+		if (mode == TB_WRITE) {
+			write(stdout, line, linelen);
+		} else {
+			for (j=0; j<linelen; j++) {
+				putc(stdout, line[j]);
+			}
+		}
+	}
+	elapsed = ctr1000 - start;
+	*ints = typtr->tytxints - txints;
+	return (elapsed > 0) ? elapsed : 1;
+}
@@ -0,0 +1,68 @@
+/* bcflush.c - bcflush, bcwdone */
+
+#include <xinu.h>
+
+local	void	bcwdone(struct bioreq *);
+
+/*------------------------------------------------------------------------
+ *  bcflush  -  Start writing a dirty buffer to its device without
+ *		  waiting for the write (called with interrupts disabled
+ *		  for a buffer with no transfer in progress; the buffer
+ *		  stays busy and held until the write completes, and a
+ *		  process that changes it afterward marks it dirty again)
+ *------------------------------------------------------------------------
+ */
+status	bcflush (
+	  struct bcbuf	*bptr		/* Buffer to write		*/
+	)
+{
+	struct	bioreq	*req;		/* Request for the write	*/
+
+	bptr->bc_flags = (bptr->bc_flags & ~BC_DIRTY) | BC_BUSY;
+	Bc_data.bc_ndirty--;
+	bptr->bc_refs++;
+	req = &bptr->bc_bio;
+	bioprep(req, BIO_WRITE, bptr->bc_blk, 1, bptr->bc_data);
+	req->bio_func = bcwdone;
+	req->bio_arg = (void *)bptr;
+	if (biosubmit(bptr->bc_dev, req) == SYSERR) {
+		req->bio_status = SYSERR;
+		bcwdone(req);
+		return SYSERR;
+	}
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ *  bcwdone  -  Finish the write of a buffer when its request completes;
+ *		  if the write failed, mark the buffer dirty again so it
+ *		  is retried (called with interrupts disabled)
+ *------------------------------------------------------------------------
+ */
+local	void	bcwdone (
+	  struct bioreq	*req		/* Completed write request	*/
+	)
+{
+	struct	bcbuf	*bptr;		/* Buffer that was written	*/
+
+	bptr = (struct bcbuf *)req->bio_arg;
+	Bc_data.bc_writes++;
+	bptr->bc_flags &= ~BC_BUSY;
+	if (Bc_data.bc_niowait > 0) {
+		signaln(Bc_data.bc_iosem, Bc_data.bc_niowait);
+		Bc_data.bc_niowait = 0;
+	}
+	if (req->bio_status == SYSERR) {
+		Bc_data.bc_werrors++;
+		if (! (bptr->bc_flags & BC_WERR)) {
+			kprintf("bcflush: cannot write block %d of device %d\n",
+					bptr->bc_blk, bptr->bc_dev);
+		}
+		bptr->bc_flags |= BC_WERR;
+		bcrelse(bptr, TRUE);	/* Dirty again, with a new time	*/
+		return;
+	}
+	bptr->bc_flags &= ~BC_WERR;
+	bcrelse(bptr, FALSE);
+	return;
+}
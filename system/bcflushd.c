@@ -0,0 +1,21 @@
+/* bcflushd.c - bcflushd */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ *  bcflushd  -  Process that periodically writes the dirty buffers that
+ *		   have aged BC_AGE ms
+ *------------------------------------------------------------------------
+ */
+process	bcflushd(void)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+
+	while (TRUE) {
+		sleepms(BC_FLUSHMS);
+		mask = disable();
+		bcwback(BC_ALLDEV, TRUE);
+		restore(mask);
+	}
+	return OK;
+}
@@ -0,0 +1,129 @@
+/* bcget.c - bcget */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ *  bcget  -  Obtain and hold the buffer for a block, reading the block
+ *		from the device unless the caller will overwrite all of it
+ *		(returns NULL if the read fails)
+ *------------------------------------------------------------------------
+ */
+struct	bcbuf	*bcget (
+	  did32		dev,		/* Device that holds the block	*/
+	  uint32	blk,		/* Block number			*/
+	  bool8		fill		/* Read the block if it is not	*/
+					/*   in the cache?		*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	struct	bcbuf	*bptr;		/* Buffer for the block		*/
+	struct	bcbuf	**pp;		/* Walks a hash chain		*/
+	int32	retval;			/* Return value from read	*/
+
+	mask = disable();
+	while (TRUE) {
+
+		/* Search the hash chain for the block */
+
+		for (bptr = Bc_data.bc_hash[bchash(dev, blk)];
+				bptr != (struct bcbuf *)NULL;
+				bptr = bptr->bc_hnext) {
+			if ( (bptr->bc_dev == dev) && (bptr->bc_blk == blk) ) {
+				break;
+			}
+		}
+		if (bptr != (struct bcbuf *)NULL) {
+			bptr->bc_refs++;
+			Bc_data.bc_hits++;
+
+			/* Share the buffer once a transfer completes */
+
+			while (bptr->bc_flags & BC_BUSY) {
+				Bc_data.bc_niowait++;
+				wait(Bc_data.bc_iosem);
+			}
+			break;
+		}
+
+		/* Choose the least recently used buffer not held	*/
+		/*   (waiting for one to be released if all are held)	*/
+
+		for (bptr = Bc_data.bc_lru; bptr != (struct bcbuf *)NULL;
+						bptr = bptr->bc_next) {
+			if ( (bptr->bc_refs == 0) &&
+			     ! (bptr->bc_flags & BC_BUSY) ) {
+				break;
+			}
+		}
+		if (bptr == (struct bcbuf *)NULL) {
+			Bc_data.bc_nwait++;
+			wait(Bc_data.bc_wsem);
+			continue;
+		}
+
+		/* Start writing a dirty buffer and look for another	*/
+		/*   one to reuse (the write holds the buffer)		*/
+
+		if (bptr->bc_flags & BC_DIRTY) {
+			bcflush(bptr);
+			continue;
+		}
+
+		/* Move the buffer to the hash chain for the block */
+
+		if (bptr->bc_dev != BC_NODEV) {
+			pp = &Bc_data.bc_hash[bchash(bptr->bc_dev,
+							bptr->bc_blk)];
+			while (*pp != bptr) {
+				pp = &(*pp)->bc_hnext;
+			}
+			*pp = bptr->bc_hnext;
+		}
+		bptr->bc_dev = dev;
+		bptr->bc_blk = blk;
+		bptr->bc_flags = 0;
+		bptr->bc_refs = 1;
+		bptr->bc_hnext = Bc_data.bc_hash[bchash(dev, blk)];
+		Bc_data.bc_hash[bchash(dev, blk)] = bptr;
+		Bc_data.bc_misses++;
+		break;
+	}
+
+	/* Make the buffer the most recently used */
+
+	if (bptr != Bc_data.bc_mru) {
+		if (bptr->bc_prev == (struct bcbuf *)NULL) {
+			Bc_data.bc_lru = bptr->bc_next;
+		} else {
+			bptr->bc_prev->bc_next = bptr->bc_next;
+		}
+		bptr->bc_next->bc_prev = bptr->bc_prev;
+		bptr->bc_prev = Bc_data.bc_mru;
+		bptr->bc_next = (struct bcbuf *)NULL;
+		Bc_data.bc_mru->bc_next = bptr;
+		Bc_data.bc_mru = bptr;
+	}
+
+	/* Read the block if needed (other processes that want the	*/
+	/*   block wait until the read completes)			*/
+
+	if ( ! (bptr->bc_flags & BC_VALID) ) {
+		if (fill) {
+			bptr->bc_flags |= BC_BUSY;
+			retval = bioread(dev, bptr->bc_data, blk, 1);
+			bptr->bc_flags &= ~BC_BUSY;
+			if (Bc_data.bc_niowait > 0) {
+				signaln(Bc_data.bc_iosem, Bc_data.bc_niowait);
+				Bc_data.bc_niowait = 0;
+			}
+			if (retval == SYSERR) {
+				bcrelse(bptr, FALSE);
+				restore(mask);
+				return (struct bcbuf *)NULL;
+			}
+		}
+		bptr->bc_flags |= BC_VALID;
+	}
+	restore(mask);
+	return bptr;
+}
@@ -0,0 +1,41 @@
+/* bcinit.c - bcinit */
+
+#include <xinu.h>
+
+struct	bcdata	Bc_data;		/* Block buffer cache		*/
+
+/*------------------------------------------------------------------------
+ *  bcinit  -  Initialize the block buffer cache (all buffers unused and
+ *		 linked in LRU order)
+ *------------------------------------------------------------------------
+ */
+status	bcinit(void)
+{
+	struct	bcbuf	*bptr;		/* Walks the buffers		*/
+	int32	i;			/* Index into buffers		*/
+
+	for (i=0; i<BC_NHASH; i++) {
+		Bc_data.bc_hash[i] = (struct bcbuf *)NULL;
+	}
+	for (i=0; i<BC_NBUFS; i++) {
+		bptr = &Bc_data.bc_bufs[i];
+		bptr->bc_dev = BC_NODEV;
+		bptr->bc_blk = 0;
+		bptr->bc_flags = 0;
+		bptr->bc_refs = 0;
+		bptr->bc_hnext = (struct bcbuf *)NULL;
+		bptr->bc_prev = (i == 0) ? (struct bcbuf *)NULL : bptr - 1;
+		bptr->bc_next = (i == BC_NBUFS-1) ? (struct bcbuf *)NULL :
+								bptr + 1;
+	}
+	Bc_data.bc_lru = &Bc_data.bc_bufs[0];
+	Bc_data.bc_mru = &Bc_data.bc_bufs[BC_NBUFS-1];
+	Bc_data.bc_wsem = semcreate(0);
+	Bc_data.bc_nwait = 0;
+	Bc_data.bc_iosem = semcreate(0);
+	Bc_data.bc_niowait = 0;
+	Bc_data.bc_ndirty = 0;
+	Bc_data.bc_hits = Bc_data.bc_misses = Bc_data.bc_writes = 0;
+	Bc_data.bc_werrors = 0;
+	return OK;
+}
@@ -0,0 +1,40 @@
+/* bcinval.c - bcinval */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ *  bcinval  -  Discard the buffers of a device that are not held (dirty
+ *		  data is lost, so a caller syncs the device first if the
+ *		  data matters)
+ *------------------------------------------------------------------------
+ */
+void	bcinval (
+	  did32		dev		/* Device to discard		*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	struct	bcbuf	*bptr;		/* Walks the buffers		*/
+	struct	bcbuf	**pp;		/* Walks a hash chain		*/
+	int32	i;			/* Index into buffers		*/
+
+	mask = disable();
+	for (i=0; i<BC_NBUFS; i++) {
+		bptr = &Bc_data.bc_bufs[i];
+		if ( (bptr->bc_dev != dev) || (bptr->bc_refs > 0) ||
+		     (bptr->bc_flags & BC_BUSY) ) {
+			continue;
+		}
+		if (bptr->bc_flags & BC_DIRTY) {
+			Bc_data.bc_ndirty--;
+		}
+		pp = &Bc_data.bc_hash[bchash(bptr->bc_dev, bptr->bc_blk)];
+		while (*pp != bptr) {
+			pp = &(*pp)->bc_hnext;
+		}
+		*pp = bptr->bc_hnext;
+		bptr->bc_dev = BC_NODEV;
+		bptr->bc_flags = 0;
+	}
+	restore(mask);
+	return;
+}
@@ -0,0 +1,24 @@
+/* bcread.c - bcread */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ *  bcread  -  Copy a block into a caller's buffer through the cache
+ *------------------------------------------------------------------------
+ */
+status	bcread (
+	  did32		dev,		/* Device that holds the block	*/
+	  char		*buff,		/* Buffer to hold the block	*/
+	  uint32	blk		/* Block number			*/
+	)
+{
+	struct	bcbuf	*bptr;		/* Buffer for the block		*/
+
+	bptr = bcget(dev, blk, TRUE);
+	if (bptr == (struct bcbuf *)NULL) {
+		return SYSERR;
+	}
+	memcpy(buff, bptr->bc_data, BC_BLKSIZ);
+	bcrelse(bptr, FALSE);
+	return OK;
+}
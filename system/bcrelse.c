@@ -0,0 +1,29 @@
+/* bcrelse.c - bcrelse */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ *  bcrelse  -  Release a buffer obtained with bcget, marking it dirty if
+ *		  the caller changed it (the write is delayed)
+ *------------------------------------------------------------------------
+ */
+void	bcrelse (
+	  struct bcbuf	*bptr,		/* Buffer to release		*/
+	  bool8		dirty		/* Did the caller change it?	*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+
+	mask = disable();
+	if (dirty && ! (bptr->bc_flags & BC_DIRTY)) {
+		bptr->bc_flags |= BC_DIRTY;
+		bptr->bc_dtime = ctr1000;
+		Bc_data.bc_ndirty++;
+	}
+	if ( (--bptr->bc_refs == 0) && (Bc_data.bc_nwait > 0) ) {
+		signaln(Bc_data.bc_wsem, Bc_data.bc_nwait);
+		Bc_data.bc_nwait = 0;
+	}
+	restore(mask);
+	return;
+}
@@ -0,0 +1,56 @@
+/* bcsync.c - bcsync */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ *  bcsync  -  Write every dirty buffer of a device (or of all devices
+ *		 if the device is BC_ALLDEV) and wait for the writes,
+ *		 returning SYSERR if any buffer could not be written (it
+ *		 stays dirty, so bcflushd retries it)
+ *------------------------------------------------------------------------
+ */
+status	bcsync (
+	  did32		dev		/* Device to sync or BC_ALLDEV	*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	struct	bcbuf	*bptr;		/* Walks the buffers		*/
+	status	retval;			/* Value to return		*/
+	bool8	flushed;		/* Written here during the sync?*/
+	int32	i;			/* Index into buffers		*/
+
+	mask = disable();
+	retval = OK;
+
+	/* Start all the writes at once so they can be merged */
+
+	bcwback(dev, FALSE);
+	for (i=0; i<BC_NBUFS; i++) {
+		bptr = &Bc_data.bc_bufs[i];
+		if ( (dev != BC_ALLDEV) && (bptr->bc_dev != dev) ) {
+			continue;
+		}
+
+		/* Wait for a transfer in progress, then write the	*/
+		/*   buffer if it is still (or again) dirty, but stop	*/
+		/*   after a second write of the buffer has failed	*/
+
+		flushed = FALSE;
+		while (bptr->bc_flags & (BC_BUSY | BC_DIRTY)) {
+			if (bptr->bc_flags & BC_BUSY) {
+				Bc_data.bc_niowait++;
+				wait(Bc_data.bc_iosem);
+			} else if (flushed && (bptr->bc_flags & BC_WERR)) {
+				break;
+			} else {
+				bcflush(bptr);
+				flushed = TRUE;
+			}
+		}
+		if (bptr->bc_flags & BC_WERR) {
+			retval = SYSERR;
+		}
+	}
+	restore(mask);
+	return retval;
+}
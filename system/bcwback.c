@@ -0,0 +1,47 @@
+/* bcwback.c - bcwback */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ *  bcwback  -  Start writing the dirty buffers of a device (or of all
+ *		  devices if the device is BC_ALLDEV), optionally only
+ *		  those that have aged BC_AGE ms, with each device's queue
+ *		  plugged so the writes are sorted and merged (called with
+ *		  interrupts disabled; does not wait for the writes)
+ *------------------------------------------------------------------------
+ */
+void	bcwback (
+	  did32		dev,		/* Device to write or BC_ALLDEV	*/
+	  bool8		aged		/* Write only aged buffers?	*/
+	)
+{
+	struct	bcbuf	*bptr;		/* Walks the buffers		*/
+	bool8	plugged[NDEVS];		/* Devices plugged here		*/
+	int32	i;			/* Index into buffers/devices	*/
+
+	for (i=0; i<NDEVS; i++) {
+		plugged[i] = FALSE;
+	}
+	for (i=0; i<BC_NBUFS; i++) {
+		bptr = &Bc_data.bc_bufs[i];
+		if ( ((dev != BC_ALLDEV) && (bptr->bc_dev != dev)) ||
+		     ((bptr->bc_flags & (BC_DIRTY|BC_BUSY)) != BC_DIRTY) ||
+		     (aged && (ctr1000 - bptr->bc_dtime < BC_AGE)) ) {
+			continue;
+		}
+		if ( (! plugged[bptr->bc_dev]) &&
+		     (bioplug(bptr->bc_dev) == OK) ) {
+			plugged[bptr->bc_dev] = TRUE;
+		}
+		bcflush(bptr);
+	}
+
+	/* Run the queues, which now hold the writes in block order */
+
+	for (i=0; i<NDEVS; i++) {
+		if (plugged[i]) {
+			biounplug(i);
+		}
+	}
+	return;
+}
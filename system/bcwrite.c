@@ -0,0 +1,25 @@
+/* bcwrite.c - bcwrite */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ *  bcwrite  -  Copy a caller's buffer into the cache as the new contents
+ *		  of a block (the write to the device is delayed)
+ *------------------------------------------------------------------------
+ */
+status	bcwrite (
+	  did32		dev,		/* Device that holds the block	*/
+	  char		*buff,		/* Buffer holding the block	*/
+	  uint32	blk		/* Block number			*/
+	)
+{
+	struct	bcbuf	*bptr;		/* Buffer for the block		*/
+
+	bptr = bcget(dev, blk, FALSE);
+	if (bptr == (struct bcbuf *)NULL) {
+		return SYSERR;
+	}
+	memcpy(bptr->bc_data, buff, BC_BLKSIZ);
+	bcrelse(bptr, TRUE);
+	return OK;
+}
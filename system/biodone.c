@@ -0,0 +1,46 @@
+/* biodone.c - biodone */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ *  biodone  -  Record the completion of blocks of an asynchronous
+ *		  request and, once all blocks have completed, notify the
+ *		  submitter (called by a driver with interrupts disabled)
+ *------------------------------------------------------------------------
+ */
+void	biodone(
+	  struct bioreq	*req,		/* Request being completed	*/
+	  uint32	nblks,		/* Blocks that have completed	*/
+	  status	stat		/* Outcome for those blocks	*/
+	)
+{
+	pid32	pid;			/* Process waiting in biowait	*/
+
+	if ( (stat != OK) && (req->bio_status == OK) ) {
+		req->bio_status = stat;
+	}
+	if (nblks < req->bio_nleft) {
+		req->bio_nleft -= nblks;
+		return;
+	}
+	req->bio_nleft = 0;
+	req->bio_state = BIO_DONE;
+
+	/* Notify in each way the submitter requested */
+
+	if (req->bio_func != NULL) {
+		(*req->bio_func)(req);
+	}
+	if (req->bio_pid != -1) {
+		send(req->bio_pid, req->bio_msg);
+	}
+	if (req->bio_sem != -1) {
+		signal(req->bio_sem);
+	}
+	if (req->bio_waiter != -1) {
+		pid = req->bio_waiter;
+		req->bio_waiter = -1;
+		resume(pid);
+	}
+	return;
+}
@@ -0,0 +1,46 @@
+/* bioemul.c - bioemul */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ *  bioemul  -  Perform an asynchronous transfer (a chain of requests
+ *		  linked by bio_next) synchronously with the read and
+ *		  write functions of the device (used as the block I/O
+ *		  function of a driver that has no queue)
+ *------------------------------------------------------------------------
+ */
+devcall	bioemul(
+	  struct dentry	*devptr,	/* Entry in device switch table	*/
+	  struct bioreq	*req		/* First request to perform	*/
+	)
+{
+	struct	bioreq	*nextreq;	/* Next request in the transfer	*/
+	char	*buf;			/* Buffer for the next block	*/
+	uint32	blk;			/* Next block to transfer	*/
+	uint32	nblks;			/* Blocks in the request	*/
+	int32	op;			/* Operation of the request	*/
+	int32	retval;			/* Value from read or write	*/
+	uint32	i;			/* Index of block in request	*/
+
+	/* Completing a request may let its owner reuse it, so take	*/
+	/*   what is needed from each request before its blocks start	*/
+
+	for (; req != (struct bioreq *)NULL; req = nextreq) {
+		nextreq = req->bio_next;
+		op = req->bio_op;
+		buf = req->bio_buf;
+		blk = req->bio_blk;
+		nblks = req->bio_nblks;
+		for (i=0; i<nblks; i++) {
+			if (op == BIO_READ) {
+				retval = (*devptr->dvread)(devptr, buf, blk);
+			} else {
+				retval = (*devptr->dvwrite)(devptr, buf, blk);
+			}
+			biodone(req, 1, (retval == SYSERR) ? SYSERR : OK);
+			buf += BIO_BLKSIZ;
+			blk++;
+		}
+	}
+	return OK;
+}
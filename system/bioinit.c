@@ -0,0 +1,25 @@
+/* bioinit.c - bioinit */
+
+#include <xinu.h>
+
+struct	bioqueue bioqtab[NDEVS];	/* Request queue of each device	*/
+
+/*------------------------------------------------------------------------
+ *  bioinit  -  Initialize the block request queues to empty
+ *------------------------------------------------------------------------
+ */
+status	bioinit(void)
+{
+	struct	bioqueue *bqptr;	/* Walks the queues		*/
+	int32	i;			/* Index into bioqtab		*/
+
+	for (i=0; i<NDEVS; i++) {
+		bqptr = &bioqtab[i];
+		bqptr->bq_head = (struct bioreq *)NULL;
+		bqptr->bq_plugs = 0;
+		bqptr->bq_depth = bqptr->bq_maxdepth = 0;
+		bqptr->bq_nreqs = bqptr->bq_nblks = 0;
+		bqptr->bq_nxfers = bqptr->bq_nmerged = 0;
+	}
+	return OK;
+}
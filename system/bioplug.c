@@ -0,0 +1,24 @@
+/* bioplug.c - bioplug */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ *  bioplug  -  Hold the requests submitted to a device in its queue
+ *		  until biounplug, so a burst can be sorted and merged
+ *------------------------------------------------------------------------
+ */
+syscall	bioplug(
+	  did32		descrp		/* Descriptor for device	*/
+	)
+{
+	intmask		mask;		/* Saved interrupt mask		*/
+
+	mask = disable();
+	if (isbaddev(descrp)) {
+		restore(mask);
+		return SYSERR;
+	}
+	bioqtab[descrp].bq_plugs++;
+	restore(mask);
+	return OK;
+}
@@ -0,0 +1,31 @@
+/* bioprep.c - bioprep */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ *  bioprep  -  Fill in an asynchronous block request for a transfer,
+ *		  with no notification other than biowait
+ *------------------------------------------------------------------------
+ */
+void	bioprep(
+	  struct bioreq	*req,		/* Request to fill in		*/
+	  int32		op,		/* BIO_READ or BIO_WRITE	*/
+	  uint32	blk,		/* First block to transfer	*/
+	  uint32	nblks,		/* Number of blocks		*/
+	  char		*buf		/* Buffer of nblks blocks	*/
+	)
+{
+	req->bio_op = op;
+	req->bio_blk = blk;
+	req->bio_nblks = nblks;
+	req->bio_buf = buf;
+	req->bio_sem = -1;
+	req->bio_pid = -1;
+	req->bio_msg = 0;
+	req->bio_func = NULL;
+	req->bio_arg = NULL;
+	req->bio_state = BIO_IDLE;
+	req->bio_waiter = -1;
+	req->bio_next = (struct bioreq *)NULL;
+	return;
+}
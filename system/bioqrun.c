@@ -0,0 +1,58 @@
+/* bioqrun.c - bioqrun */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ *  bioqrun  -  Give the queued requests of a device to its driver in
+ *		  queue order, linking successive requests for contiguous
+ *		  blocks with the same operation into one transfer
+ *		  (called with interrupts disabled)
+ *------------------------------------------------------------------------
+ */
+void	bioqrun(
+	  did32		descrp		/* Descriptor for device	*/
+	)
+{
+	struct	dentry	*devptr;	/* Entry in device switch table	*/
+	struct	bioqueue *bqptr;	/* Queue of the device		*/
+	struct	bioreq	*req;		/* First request of a transfer	*/
+	struct	bioreq	*last;		/* Last request of a transfer	*/
+	struct	bioreq	*nptr;		/* Next request			*/
+	uint32	nblks;			/* Blocks in the transfer	*/
+
+	devptr = (struct dentry *) &devtab[descrp];
+	bqptr = &bioqtab[descrp];
+
+	while ( (req = bqptr->bq_head) != (struct bioreq *)NULL) {
+
+		/* Remove the first request and those that continue it	*/
+
+		req->bio_state = BIO_PEND;
+		bqptr->bq_depth--;
+		nblks = req->bio_nblks;
+		last = req;
+		while ( ((nptr = last->bio_next) != (struct bioreq *)NULL) &&
+			(nptr->bio_op == req->bio_op) &&
+			(nptr->bio_blk == last->bio_blk + last->bio_nblks) &&
+			(nblks + nptr->bio_nblks <= BIO_MAXMERGE) ) {
+			nptr->bio_state = BIO_PEND;
+			bqptr->bq_depth--;
+			bqptr->bq_nmerged++;
+			nblks += nptr->bio_nblks;
+			last = nptr;
+		}
+		bqptr->bq_head = last->bio_next;
+		last->bio_next = (struct bioreq *)NULL;
+		bqptr->bq_nxfers++;
+
+		/* Fail the requests of a transfer the driver rejects */
+
+		if ((*devptr->dvbio)(devptr, req) == SYSERR) {
+			for (; req != (struct bioreq *)NULL; req = nptr) {
+				nptr = req->bio_next;
+				biodone(req, req->bio_nleft, SYSERR);
+			}
+		}
+	}
+	return;
+}
@@ -0,0 +1,24 @@
+/* bioread.c - bioread */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ *  bioread  -  Read contiguous blocks from a device through the
+ *		  asynchronous interface and wait for the transfer
+ *------------------------------------------------------------------------
+ */
+syscall	bioread(
+	  did32		descrp,		/* Descriptor for device	*/
+	  char		*buf,		/* Buffer of nblks blocks	*/
+	  uint32	blk,		/* First block to read		*/
+	  uint32	nblks		/* Number of blocks		*/
+	)
+{
+	struct	bioreq	req;		/* Request for the transfer	*/
+
+	bioprep(&req, BIO_READ, blk, nblks, buf);
+	if (biosubmit(descrp, &req) == SYSERR) {
+		return SYSERR;
+	}
+	return biowait(&req);
+}
@@ -0,0 +1,76 @@
+/* biosubmit.c - biosubmit */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ *  biosubmit  -  Queue an asynchronous transfer of blocks to or from a
+ *		    device and return without waiting for it to complete
+ *		    (the queue runs at once unless it is plugged)
+ *------------------------------------------------------------------------
+ */
+syscall	biosubmit(
+	  did32		descrp,		/* Descriptor for device	*/
+	  struct bioreq	*req		/* Request to start		*/
+	)
+{
+	intmask		mask;		/* Saved interrupt mask		*/
+	struct	bioqueue *bqptr;	/* Queue of the device		*/
+	struct	bioreq	*qptr;		/* A queued request		*/
+	struct	bioreq	**pp;		/* Walks the queue links	*/
+	struct	bioreq	**after;	/* Link after the last queued	*/
+					/*   request that must precede	*/
+					/*   the new one		*/
+
+	mask = disable();
+	if ( isbaddev(descrp) || (req->bio_state == BIO_QUEUED) ||
+	     (req->bio_state == BIO_PEND) || (req->bio_nblks == 0) ||
+	     ( (req->bio_op != BIO_READ) && (req->bio_op != BIO_WRITE) ) ) {
+		restore(mask);
+		return SYSERR;
+	}
+	req->bio_dev = descrp;
+	req->bio_state = BIO_QUEUED;
+	req->bio_status = OK;
+	req->bio_nleft = req->bio_nblks;
+	req->bio_waiter = -1;
+	bqptr = &bioqtab[descrp];
+
+	/* The new request must follow every queued request that	*/
+	/*   overlaps it if either of the two writes			*/
+
+	after = &bqptr->bq_head;
+	for (pp = &bqptr->bq_head; *pp != (struct bioreq *)NULL;
+						pp = &qptr->bio_next) {
+		qptr = *pp;
+		if ( (qptr->bio_blk < req->bio_blk + req->bio_nblks) &&
+		     (req->bio_blk < qptr->bio_blk + qptr->bio_nblks) &&
+		     ( (qptr->bio_op == BIO_WRITE) ||
+		       (req->bio_op == BIO_WRITE) ) ) {
+			after = &qptr->bio_next;
+		}
+	}
+
+	/* Beyond that point, keep the queue in block order */
+
+	for (pp = after; (*pp != (struct bioreq *)NULL) &&
+			 ((*pp)->bio_blk <= req->bio_blk);
+						pp = &(*pp)->bio_next) {
+		;
+	}
+	req->bio_next = *pp;
+	*pp = req;
+
+	bqptr->bq_nreqs++;
+	bqptr->bq_nblks += req->bio_nblks;
+	if (++bqptr->bq_depth > bqptr->bq_maxdepth) {
+		bqptr->bq_maxdepth = bqptr->bq_depth;
+	}
+
+	/* Run the queue unless a burst is being built */
+
+	if ( (bqptr->bq_plugs == 0) || (bqptr->bq_depth >= BIO_QMAX) ) {
+		bioqrun(descrp);
+	}
+	restore(mask);
+	return OK;
+}
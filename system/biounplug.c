@@ -0,0 +1,28 @@
+/* biounplug.c - biounplug */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ *  biounplug  -  Undo a call of bioplug, running the device's queue
+ *		    once no plugs remain
+ *------------------------------------------------------------------------
+ */
+syscall	biounplug(
+	  did32		descrp		/* Descriptor for device	*/
+	)
+{
+	intmask		mask;		/* Saved interrupt mask		*/
+	struct	bioqueue *bqptr;	/* Queue of the device		*/
+
+	mask = disable();
+	if ( isbaddev(descrp) || (bioqtab[descrp].bq_plugs <= 0) ) {
+		restore(mask);
+		return SYSERR;
+	}
+	bqptr = &bioqtab[descrp];
+	if (--bqptr->bq_plugs == 0) {
+		bioqrun(descrp);
+	}
+	restore(mask);
+	return OK;
+}
@@ -0,0 +1,42 @@
+/* biowait.c - biowait */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ *  biowait  -  Wait for an asynchronous block request to complete and
+ *		  return its outcome
+ *------------------------------------------------------------------------
+ */
+syscall	biowait(
+	  struct bioreq	*req		/* Request to wait for		*/
+	)
+{
+	intmask		mask;		/* Saved interrupt mask		*/
+	status		retval;		/* Value to return to caller	*/
+
+	mask = disable();
+	if (req->bio_state == BIO_IDLE) {
+		restore(mask);
+		return SYSERR;
+	}
+
+	/* Only one process can wait for a given request; one that is	*/
+	/*   still queued (e.g., behind a plug) is started first	*/
+
+	while (req->bio_state != BIO_DONE) {
+		if (req->bio_state == BIO_QUEUED) {
+			bioqrun(req->bio_dev);
+			continue;
+		}
+		if ( (req->bio_waiter != -1) &&
+		     (req->bio_waiter != currpid) ) {
+			restore(mask);
+			return SYSERR;
+		}
+		req->bio_waiter = currpid;
+		suspend(currpid);
+	}
+	retval = req->bio_status;
+	restore(mask);
+	return retval;
+}
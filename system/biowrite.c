@@ -0,0 +1,24 @@
+/* biowrite.c - biowrite */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ *  biowrite  -  Write contiguous blocks to a device through the
+ *		  asynchronous interface and wait for the transfer
+ *------------------------------------------------------------------------
+ */
+syscall	biowrite(
+	  did32		descrp,		/* Descriptor for device	*/
+	  char		*buf,		/* Buffer of nblks blocks	*/
+	  uint32	blk,		/* First block to write		*/
+	  uint32	nblks		/* Number of blocks		*/
+	)
+{
+	struct	bioreq	req;		/* Request for the transfer	*/
+
+	bioprep(&req, BIO_WRITE, blk, nblks, buf);
+	if (biosubmit(descrp, &req) == SYSERR) {
+		return SYSERR;
+	}
+	return biowait(&req);
+}
@@ -33,7 +33,16 @@ syscall	freebuf(
 
 	((struct bpentry *)bufaddr)->bpnext = bpptr->bpnext;
 	bpptr->bpnext = (struct bpentry *)bufaddr;
+	resched_cntl(DEFER_START);
 	signal(bpptr->bpsem);
+
+	/* Let getbufs callers check whether enough buffers are free */
+
+	if (bpptr->bpnwait > 0) {
+		signaln(bpptr->bpnsem, bpptr->bpnwait);
+		bpptr->bpnwait = 0;
+	}
+	resched_cntl(DEFER_STOP);
 	restore(mask);
 	return OK;
 }
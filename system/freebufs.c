@@ -0,0 +1,91 @@
+/* freebufs.c - freebufs, bpfreed */
+
+#include <xinu.h>
+
+local	void	bpfreed(struct bpentry *, int32);
+
+/*------------------------------------------------------------------------
+ *  freebufs  -  Free n buffers that were allocated by getbuf or getbufs,
+ *		   signaling each pool once per run of buffers from it
+ *------------------------------------------------------------------------
+ */
+syscall	freebufs(
+	  char		*vec[],		/* Addresses of buffers		*/
+	  int32		n		/* Number of buffers in vec	*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	struct	bpentry	*bpptr;		/* Pointer to entry in buftab	*/
+	char	*bufaddr;		/* Address of one buffer	*/
+	bpid32	poolid;			/* ID of buffer's pool		*/
+	bpid32	runpool;		/* Pool of the current run	*/
+	int32	runlen;			/* Buffers in the current run	*/
+	int32	i;			/* Index into vec		*/
+	status	retval;			/* Value to return		*/
+
+	mask = disable();
+	if (n < 0) {
+		restore(mask);
+		return SYSERR;
+	}
+
+	/* Defer rescheduling until all buffers are back in their pools	*/
+
+	resched_cntl(DEFER_START);
+	retval = OK;
+	runpool = -1;
+	runlen = 0;
+	for (i=0; i<n; i++) {
+
+		/* Extract pool ID from integer prior to buffer address */
+
+		bufaddr = vec[i] - sizeof(bpid32);
+		poolid = *(bpid32 *)bufaddr;
+		if (poolid < 0  ||  poolid >= nbpools) {
+			retval = SYSERR;
+			continue;
+		}
+
+		/* Signal the previous pool for its run of buffers */
+
+		if (poolid != runpool) {
+			if (runlen > 0) {
+				bpfreed(&buftab[runpool], runlen);
+			}
+			runpool = poolid;
+			runlen = 0;
+		}
+
+		/* Insert buffer into list */
+
+		bpptr = &buftab[poolid];
+		((struct bpentry *)bufaddr)->bpnext = bpptr->bpnext;
+		bpptr->bpnext = (struct bpentry *)bufaddr;
+		runlen++;
+	}
+	if (runlen > 0) {
+		bpfreed(&buftab[runpool], runlen);
+	}
+	resched_cntl(DEFER_STOP);
+	restore(mask);
+	return retval;
+}
+
+/*------------------------------------------------------------------------
+ *  bpfreed  -  Signal a pool for buffers returned to it, and let getbufs
+ *		  callers check whether enough buffers are now free
+ *		  (interrupts disabled)
+ *------------------------------------------------------------------------
+ */
+local	void	bpfreed(
+	  struct bpentry *bpptr,	/* Pool the buffers returned to	*/
+	  int32		n		/* Number of buffers returned	*/
+	)
+{
+	signaln(bpptr->bpsem, n);
+	if (bpptr->bpnwait > 0) {
+		signaln(bpptr->bpnsem, bpptr->bpnwait);
+		bpptr->bpnwait = 0;
+	}
+	return;
+}
@@ -27,12 +27,18 @@ char    *getbuf(
 
 	/* Wait for pool to have > 0 buffers and allocate a buffer */
 
+	if (semtab[bpptr->bpsem].scount <= 0) {
+		bpptr->bpexhaust++;
+	}
 	wait(bpptr->bpsem);
 	bufptr = bpptr->bpnext;
 
 	/* Unlink buffer from pool */
 
 	bpptr->bpnext = bufptr->bpnext;
+	if (bpused(bpptr) > bpptr->bpmaxused) {
+		bpptr->bpmaxused = bpused(bpptr);
+	}
 
 	/* Record pool ID in first four bytes of buffer	and skip */
 
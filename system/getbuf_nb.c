@@ -0,0 +1,52 @@
+/* getbuf_nb.c - getbuf_nb */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ *  getbuf_nb  -  Get a buffer from a preestablished buffer pool without
+ *		    blocking (SYSERR if the pool is empty)
+ *------------------------------------------------------------------------
+ */
+char    *getbuf_nb(
+          bpid32        poolid          /* Index of pool in buftab	*/
+        )
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	struct	bpentry	*bpptr;		/* Pointer to entry in buftab	*/
+	struct	bpentry	*bufptr;	/* Pointer to a buffer		*/
+
+	mask = disable();
+
+	/* Check arguments */
+
+	if ( (poolid < 0  ||  poolid >= nbpools) ) {
+		restore(mask);
+		return (char *)SYSERR;
+
+	}
+	bpptr = &buftab[poolid];
+
+	/* Fail rather than wait if the pool has no buffers */
+
+	if (semtab[bpptr->bpsem].scount <= 0) {
+		bpptr->bpexhaust++;
+		restore(mask);
+		return (char *)SYSERR;
+	}
+	wait(bpptr->bpsem);		/* Does not block		*/
+	bufptr = bpptr->bpnext;
+
+	/* Unlink buffer from pool */
+
+	bpptr->bpnext = bufptr->bpnext;
+	if (bpused(bpptr) > bpptr->bpmaxused) {
+		bpptr->bpmaxused = bpused(bpptr);
+	}
+
+	/* Record pool ID in first four bytes of buffer	and skip */
+
+	*(bpid32 *)bufptr = poolid;
+	bufptr = (struct bpentry *)(sizeof(bpid32) + (char *)bufptr);
+	restore(mask);
+	return (char *)bufptr;
+}
@@ -0,0 +1,67 @@
+/* getbufs.c - getbufs */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ *  getbufs  -  Get n buffers from a preestablished buffer pool, placing
+ *		  their addresses in vec; all of them are taken in one
+ *		  step, waiting (while holding none) until enough are free
+ *------------------------------------------------------------------------
+ */
+syscall	getbufs(
+	  bpid32	poolid,		/* Index of pool in buftab	*/
+	  int32		n,		/* Number of buffers wanted	*/
+	  char		*vec[]		/* Array to hold buffer addrs	*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	struct	bpentry	*bpptr;		/* Pointer to entry in buftab	*/
+	struct	bpentry	*bufptr;	/* Pointer to a buffer		*/
+	struct	sentry	*semptr;	/* Pointer to pool's semaphore	*/
+	int32	i;			/* Index into vec		*/
+
+	mask = disable();
+
+	/* Check arguments */
+
+	if ( (poolid < 0  ||  poolid >= nbpools) ) {
+		restore(mask);
+		return SYSERR;
+	}
+	bpptr = &buftab[poolid];
+	if ( (n <= 0) || (n > bpptr->bpnbufs) ) {
+		restore(mask);
+		return SYSERR;
+	}
+	semptr = &semtab[bpptr->bpsem];
+
+	/* Claim all n buffers at once; until enough are available,	*/
+	/*	wait for frees while holding none, so two callers	*/
+	/*	cannot each hold part of what the other needs		*/
+
+	if (semptr->scount < n) {
+		bpptr->bpexhaust++;
+		while (semptr->scount < n) {
+			bpptr->bpnwait++;
+			wait(bpptr->bpnsem);
+		}
+	}
+	semptr->scount -= n;
+
+	/* Unlink the buffers from the pool */
+
+	for (i=0; i<n; i++) {
+		bufptr = bpptr->bpnext;
+		bpptr->bpnext = bufptr->bpnext;
+
+		/* Record pool ID in first four bytes of buffer	and skip */
+
+		*(bpid32 *)bufptr = poolid;
+		vec[i] = sizeof(bpid32) + (char *)bufptr;
+	}
+	if (bpused(bpptr) > bpptr->bpmaxused) {
+		bpptr->bpmaxused = bpused(bpptr);
+	}
+	restore(mask);
+	return OK;
+}
@@ -85,6 +85,11 @@ void	nulluser()
 
 	net_init();
 
+	/* Start the process that writes dirty cache buffers */
+
+	resume(create((void *)bcflushd, BC_STACK, BC_PRIO,
+					"bcflushd", 0, NULL));
+
 	/* Create a process to finish startup and start main */
 
 	resume(create((void *)startup, INITSTK, INITPRIO,
@@ -216,6 +221,14 @@ static	void	sysinit()
 
 	bufinit();
 
+	/* Initialize the block request queues */
+
+	bioinit();
+
+	/* Initialize the block buffer cache */
+
+	bcinit();
+
 	/* Create a ready list for processes */
 
 	readylist = newqueue();
@@ -0,0 +1,37 @@
+/* ioreadv.c - ioreadv */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ *  ioreadv  -  Read into a vector of buffers by calling the device's
+ *		  read function for each buffer, stopping after a buffer
+ *		  that is not filled (used for devices without a readv)
+ *------------------------------------------------------------------------
+ */
+devcall	ioreadv(
+	  struct dentry	*devptr,	/* Entry in device switch table	*/
+	  struct iovec	*iov,		/* Buffers to fill in order	*/
+	  int32		iovcnt		/* Number of buffers		*/
+	)
+{
+	int32	nread;			/* Bytes read so far		*/
+	int32	retval;			/* Value from the read function	*/
+	int32	i;			/* Index into the vector	*/
+
+	nread = 0;
+	for (i=0; i<iovcnt; i++) {
+		if (iov[i].iov_len == 0) {
+			continue;
+		}
+		retval = (*devptr->dvread)(devptr, iov[i].iov_base,
+							iov[i].iov_len);
+		if ( (retval == SYSERR) || (retval == EOF) ) {
+			return (nread > 0) ? nread : retval;
+		}
+		nread += retval;
+		if ((uint32)retval < iov[i].iov_len) {
+			break;
+		}
+	}
+	return nread;
+}
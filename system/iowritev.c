@@ -0,0 +1,32 @@
+/* iowritev.c - iowritev */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ *  iowritev  -  Write a vector of buffers by calling the device's write
+ *		   function for each buffer (used for devices without a
+ *		   writev)
+ *------------------------------------------------------------------------
+ */
+devcall	iowritev(
+	  struct dentry	*devptr,	/* Entry in device switch table	*/
+	  struct iovec	*iov,		/* Buffers to write in order	*/
+	  int32		iovcnt		/* Number of buffers		*/
+	)
+{
+	int32	nwritten;		/* Bytes written so far		*/
+	int32	i;			/* Index into the vector	*/
+
+	nwritten = 0;
+	for (i=0; i<iovcnt; i++) {
+		if (iov[i].iov_len == 0) {
+			continue;
+		}
+		if ((*devptr->dvwrite)(devptr, iov[i].iov_base,
+					iov[i].iov_len) == SYSERR) {
+			return SYSERR;
+		}
+		nwritten += iov[i].iov_len;
+	}
+	return nwritten;
+}
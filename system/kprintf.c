@@ -1,8 +1,10 @@
-/* kprintf.c -  kputc, kgetc, kprintf */
+/* kprintf.c -  kputc, kputfifo, kgetc, kprintf */
 
 #include <xinu.h>
 #include <stdarg.h>
 
+local	void	kputfifo(struct uart_csreg *, struct ttycblk *, byte);
+
 /*------------------------------------------------------------------------
  * kputc  -  use polled I/O to write a character to the console
  *------------------------------------------------------------------------
@@ -30,26 +32,44 @@ syscall	kputc(
 		return SYSERR;
 	}
 
-	/* Repeatedly poll the device until it becomes nonbusy */
-
-	while ((io_inb(csrptr->lsr) & UART_LSR_THRE) == 0) {
-		;
-	}
-
 	/* Write the character */
-	io_outb(csrptr->buffer, c);
+
+	kputfifo((struct uart_csreg *)csrptr, &ttytab[devptr->dvminor], c);
 
 	/* Honor CRLF - when writing NEWLINE also send CARRIAGE RETURN	*/
 
 	if (c == '\n') {
-		/* Poll until transmitter queue is empty */
+		kputfifo((struct uart_csreg *)csrptr,
+				&ttytab[devptr->dvminor], '\r');
+	}
+	restore(mask);
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ * kputfifo  -  Place a character in the console UART's transmit FIFO,
+ *		  polling for the FIFO to empty only when no slot is known
+ *		  to be free (interrupts disabled)
+ *------------------------------------------------------------------------
+ */
+local	void	kputfifo(
+	  struct uart_csreg *csrptr,	/* Address of UART's CSRs	*/
+	  struct ttycblk *typtr,	/* Ptr to ttytab entry		*/
+	  byte	c			/* character to write		*/
+	)
+{
+	/* Once the FIFO is seen empty, a burst of characters can be	*/
+	/*   written without polling (before ttyinit has sized the	*/
+	/*   FIFO, assume it holds one character)			*/
+
+	if (typtr->tyofree <= 0) {
 		while ((io_inb(csrptr->lsr) & UART_LSR_THRE) == 0) {
 			;
 		}
-		io_outb(csrptr->buffer, '\r');
+		typtr->tyofree = (typtr->tyfifosz > 0) ? typtr->tyfifosz : 1;
 	}
-	restore(mask);
-	return OK;
+	io_outb(csrptr->buffer, c);
+	typtr->tyofree--;
 }
 
 /*------------------------------------------------------------------------
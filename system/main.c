@@ -1,6 +1,7 @@
 /*  main.c  - main */
 
 #include <xinu.h>
+#include <ramdisk.h>
 
 process	main(void)
 {
@@ -10,7 +11,8 @@ process	main(void)
 
 	/* Create a local file system on the RAM disk */
 
-	lfscreate(RAM0, 40, 20480);
+	lfscreate(RAM0, 40, control(RAM0, RM_CTL_SIZE, 0, 0) * RM_BLKSIZ,
+							LF_BLKSIZ);
 
 	/* Run the Xinu shell */
 
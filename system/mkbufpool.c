@@ -36,12 +36,23 @@ bpid32	mkbufpool(
 	bpptr = &buftab[poolid];
 	bpptr->bpnext = (struct bpentry *)buf;
 	bpptr->bpsize = bufsiz;
+	bpptr->bpnbufs = numbufs;
+	bpptr->bpmaxused = 0;
+	bpptr->bpexhaust = 0;
 	if ( (bpptr->bpsem = semcreate(numbufs)) == SYSERR) {
 		freemem(buf, numbufs * (bufsiz+sizeof(bpid32)) );
 		nbpools--;
 		restore(mask);
 		return (bpid32)SYSERR;
 	}
+	if ( (bpptr->bpnsem = semcreate(0)) == SYSERR) {
+		semdelete(bpptr->bpsem);
+		freemem(buf, numbufs * (bufsiz+sizeof(bpid32)) );
+		nbpools--;
+		restore(mask);
+		return (bpid32)SYSERR;
+	}
+	bpptr->bpnwait = 0;
 	bufsiz+=sizeof(bpid32);
 	for (numbufs-- ; numbufs>0 ; numbufs-- ) {
 		bpptr = (struct bpentry *)buf;
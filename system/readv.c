@@ -0,0 +1,28 @@
+/* readv.c - readv */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ *  readv  -  Read from a device into a vector of buffers
+ *------------------------------------------------------------------------
+ */
+syscall	readv(
+	  did32		descrp,		/* Descriptor for device	*/
+	  struct iovec	*iov,		/* Buffers to fill in order	*/
+	  int32		iovcnt		/* Number of buffers		*/
+	)
+{
+	intmask		mask;		/* Saved interrupt mask		*/
+	struct dentry	*devptr;	/* Entry in device switch table	*/
+	int32		retval;		/* Value to return to caller	*/
+
+	mask = disable();
+	if (isbaddev(descrp) || (iovcnt <= 0) || (iovcnt > IOV_MAX)) {
+		restore(mask);
+		return SYSERR;
+	}
+	devptr = (struct dentry *) &devtab[descrp];
+	retval = (*devptr->dvreadv) (devptr, iov, iovcnt);
+	restore(mask);
+	return retval;
+}
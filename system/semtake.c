@@ -0,0 +1,40 @@
+/* semtake.c - semtake */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ *  semtake  -  Take up to max counts of a semaphore without blocking,
+ *		  as if by that many waits, and return the number taken
+ *		  (0 if the count is not positive).  A caller that gives
+ *		  back unused counts with signaln must keep interrupts
+ *		  disabled and must not reschedule in between, so that no
+ *		  other process sees the counts as missing meanwhile.
+ *------------------------------------------------------------------------
+ */
+syscall	semtake(
+	  sid32		sem,		/* ID of semaphore to take from	*/
+	  int32		max		/* Most counts to take		*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	struct	sentry	*semptr;	/* Ptr to sempahore table entry */
+	int32	n;			/* Counts taken			*/
+
+	mask = disable();
+	if (isbadsem(sem) || (max < 0)) {
+		restore(mask);
+		return SYSERR;
+	}
+	semptr = &semtab[sem];
+	if (semptr->sstate == S_FREE) {
+		restore(mask);
+		return SYSERR;
+	}
+	n = (semptr->scount < max) ? semptr->scount : max;
+	if (n < 0) {
+		n = 0;
+	}
+	semptr->scount -= n;
+	restore(mask);
+	return n;
+}
@@ -0,0 +1,28 @@
+/* writev.c - writev */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ *  writev  -  Write a vector of buffers to a device as one transfer
+ *------------------------------------------------------------------------
+ */
+syscall	writev(
+	  did32		descrp,		/* Descriptor for device	*/
+	  struct iovec	*iov,		/* Buffers to write in order	*/
+	  int32		iovcnt		/* Number of buffers		*/
+	)
+{
+	intmask		mask;		/* Saved interrupt mask		*/
+	struct dentry	*devptr;	/* Entry in device switch table	*/
+	int32		retval;		/* Value to return to caller	*/
+
+	mask = disable();
+	if (isbaddev(descrp) || (iovcnt <= 0) || (iovcnt > IOV_MAX)) {
+		restore(mask);
+		return SYSERR;
+	}
+	devptr = (struct dentry *) &devtab[descrp];
+	retval = (*devptr->dvwritev) (devptr, iov, iovcnt);
+	restore(mask);
+	return retval;
+}